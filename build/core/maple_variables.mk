@@ -11,8 +11,8 @@ JAVA2JAR := $(MAPLE_ROOT)/out/bin/java2jar
 JBC2MPL_BIN := $(MAPLE_ROOT)/out/bin/jbc2mpl
 MAPLE_BIN := $(MAPLE_ROOT)/out/bin/maple
 MPLCG_BIN := $(MAPLE_ROOT)/out/bin/mplcg
-MPLME_FLAGS := --quiet
-MPL2MPL_FLAGS := --quiet --regnativefunc --maplelinker
+MPLME_FLAGS := --quiet $(MPLME_EXTRA_FLAGS)
+MPL2MPL_FLAGS := --quiet --regnativefunc --maplelinker $(MPL2MPL_EXTRA_FLAGS)
 MPLCG_SO_FLAGS := --fpic
 MPLCG_FLAGS := --quiet --no-pie --verbose-asm --maplelinker
 MPLCOMBO_FLAGS := --run=me:mpl2mpl:mplcg --option="$(MPLME_FLAGS):$(MPL2MPL_FLAGS):$(MPLCG_FLAGS) $(MPLCG_SO_FLAGS)"
@@ -0,0 +1,32 @@
+public class BceTest {
+    // i < a.length guards every access
+    static int sum(int[] a) {
+        int s = 0;
+        for (int i = 0; i < a.length; i++) {
+            s += a[i];
+        }
+        return s;
+    }
+
+    // a constant index into an array of known length
+    static int fixed() {
+        int[] a = new int[4];
+        a[3] = 9;
+        return a[3];
+    }
+
+    // the check must stay, the index may be out of bounds
+    static int unchecked(int[] a, int i) {
+        return a[i];
+    }
+
+    public static void main(String[] args) {
+        System.out.println(sum(new int[]{1, 2, 3}));
+        System.out.println(fixed());
+        try {
+            System.out.println(unchecked(new int[2], 2));
+        } catch (ArrayIndexOutOfBoundsException e) {
+            System.out.println("ArrayIndexOutOfBoundsException");
+        }
+    }
+}
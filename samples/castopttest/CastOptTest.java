@@ -0,0 +1,59 @@
+class Shape {
+    int area() {
+        return 0;
+    }
+}
+
+class Square extends Shape {
+    int side = 3;
+
+    int area() {
+        return side * side;
+    }
+}
+
+public class CastOptTest {
+    // the second cast of o is proven by the first one
+    static int twice(Object o) {
+        Shape s = (Shape) o;
+        Square q = (Square) o;
+        Shape again = (Shape) o;
+        return s.area() + q.side + again.area();
+    }
+
+    // the cast is proven by the instanceof branch
+    static int guarded(Object o) {
+        if (o instanceof Square) {
+            return ((Square) o).side;
+        }
+        return -1;
+    }
+
+    // the first cast only runs on one path, it proves nothing for the second one
+    static int conditional(Object o, boolean c) {
+        int r = 0;
+        if (o != null) {
+            if (c) {
+                r = ((Square) o).side;
+            }
+        }
+        return r + ((Shape) o).area();
+    }
+
+    public static void main(String[] args) {
+        System.out.println(twice(new Square()));
+        System.out.println(guarded(new Square()));
+        System.out.println(guarded(new Shape()));
+        System.out.println(conditional(new Square(), true));
+        try {
+            System.out.println(conditional("shape", false));
+        } catch (ClassCastException e) {
+            System.out.println("ClassCastException");
+        }
+        try {
+            System.out.println(twice(new Shape()));
+        } catch (ClassCastException e) {
+            System.out.println("ClassCastException");
+        }
+    }
+}
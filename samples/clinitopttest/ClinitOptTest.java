@@ -0,0 +1,25 @@
+class Config {
+    static int base = init();
+
+    static int init() {
+        System.out.println("Config initialized");
+        return 40;
+    }
+}
+
+public class ClinitOptTest {
+    // only the first access to Config needs its class initialization check
+    static int read(boolean flag) {
+        int v = Config.base;
+        if (flag) {
+            v += Config.base;
+        }
+        return v + Config.base;
+    }
+
+    public static void main(String[] args) {
+        System.out.println("start");
+        System.out.println(read(true));
+        System.out.println(read(false));
+    }
+}
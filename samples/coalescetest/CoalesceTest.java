@@ -0,0 +1,25 @@
+public class CoalesceTest {
+    // the versions of s and t do not interfere and share one variable
+    static int swapLoop(int n) {
+        int s = 1;
+        int t = 0;
+        for (int i = 0; i < n; i++) {
+            int u = s + t;
+            t = s;
+            s = u;
+        }
+        return s;
+    }
+
+    // the copy of the formal crosses a redefinition, the two stay apart
+    static int formal(int p) {
+        int q = p;
+        p = p + 1;
+        return p * q;
+    }
+
+    public static void main(String[] args) {
+        System.out.println(swapLoop(10));
+        System.out.println(formal(6));
+    }
+}
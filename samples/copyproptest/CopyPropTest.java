@@ -0,0 +1,24 @@
+public class CopyPropTest {
+    // b and c are copies of a, their uses read a directly
+    static int copies(int a) {
+        int b = a;
+        int c = b;
+        if (c > 10) {
+            b = c + 1;
+        }
+        return b + c;
+    }
+
+    // a is redefined, the copy in c must not be propagated past it
+    static int killed(int a) {
+        int c = a;
+        a = a * 2;
+        return c + a;
+    }
+
+    public static void main(String[] args) {
+        System.out.println(copies(5));
+        System.out.println(copies(20));
+        System.out.println(killed(7));
+    }
+}
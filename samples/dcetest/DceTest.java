@@ -0,0 +1,33 @@
+public class DceTest {
+    // the value of unused never reaches an output
+    static int unusedValue(int a) {
+        int unused = a * 17 + 3;
+        int used = a + 1;
+        return used;
+    }
+
+    // the branch only computes dead values and is removed
+    static int deadBranch(int a) {
+        int t = 0;
+        if (a > 3) {
+            t = a * a;
+        }
+        return a - 1;
+    }
+
+    // the division may throw and stays
+    static int mayThrow(int a, int b) {
+        int q = a / b;
+        return a;
+    }
+
+    public static void main(String[] args) {
+        System.out.println(unusedValue(4));
+        System.out.println(deadBranch(5));
+        try {
+            System.out.println(mayThrow(4, 0));
+        } catch (ArithmeticException e) {
+            System.out.println("ArithmeticException");
+        }
+    }
+}
@@ -0,0 +1,30 @@
+public class DseTest {
+    int a;
+    int b;
+
+    // the first store to a is overwritten before any read
+    void overwrite(int v) {
+        a = v;
+        b = v + 1;
+        a = v * 2;
+    }
+
+    // the store is read through a call in between and stays
+    void readBetween(int v) {
+        a = v;
+        print();
+        a = v * 2;
+    }
+
+    void print() {
+        System.out.println(a + " " + b);
+    }
+
+    public static void main(String[] args) {
+        DseTest t = new DseTest();
+        t.overwrite(3);
+        t.print();
+        t.readBetween(5);
+        t.print();
+    }
+}
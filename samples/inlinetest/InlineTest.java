@@ -0,0 +1,62 @@
+public class InlineTest {
+    int base = 10;
+
+    // an early return, the rewritten returns jump to the end of the inlined body
+    static int clamp(int v) {
+        if (v < 0) {
+            return 0;
+        }
+        return v > 100 ? 100 : v;
+    }
+
+    // a void callee, its return drops out of the inlined body
+    static void check(int v) {
+        if (v == 13) {
+            throw new IllegalArgumentException("13");
+        }
+    }
+
+    // the receiver is checked before the inlined body runs
+    int add(int v) {
+        return base + v;
+    }
+
+    // a callee with its own handler, inlined only outside the try regions of the caller
+    static int parse(String s) {
+        try {
+            return Integer.parseInt(s);
+        } catch (NumberFormatException e) {
+            return -1;
+        }
+    }
+
+    // the exception of the inlined body must reach the handler of the caller
+    static String guarded(int v) {
+        try {
+            check(v);
+            return "ok " + clamp(v);
+        } catch (IllegalArgumentException e) {
+            return "caught " + e.getMessage();
+        }
+    }
+
+    public static void main(String[] args) {
+        System.out.println(clamp(-5) + " " + clamp(50) + " " + clamp(500));
+        System.out.println(guarded(7));
+        System.out.println(guarded(13));
+        System.out.println(parse("42") + " " + parse("x"));
+        try {
+            System.out.println(parse("7") + guarded(parse("13")));
+        } catch (RuntimeException e) {
+            System.out.println("wrong exception");
+        }
+        InlineTest t = new InlineTest();
+        System.out.println(t.add(5));
+        t = null;
+        try {
+            System.out.println(t.add(5));
+        } catch (NullPointerException e) {
+            System.out.println("NullPointerException");
+        }
+    }
+}
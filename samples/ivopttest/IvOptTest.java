@@ -0,0 +1,27 @@
+public class IvOptTest {
+    // i * 4 + base and i << 1 are derived induction variables
+    static long derived(int n, int base) {
+        long s = 0;
+        for (int i = 0; i < n; i++) {
+            s += i * 4 + base;
+            s += i << 1;
+        }
+        return s;
+    }
+
+    // the exit test can be replaced by a test of k
+    static int replaced(int n) {
+        int s = 0;
+        for (int i = 0; i < n; i++) {
+            int k = i * 8 - 3;
+            s ^= k;
+        }
+        return s;
+    }
+
+    public static void main(String[] args) {
+        System.out.println(derived(10, 5));
+        System.out.println(replaced(100));
+        System.out.println(replaced(Integer.MAX_VALUE / 1024));
+    }
+}
@@ -0,0 +1,50 @@
+public class LicmTest {
+    int scale = 3;
+    int offset = 7;
+
+    // scale * offset and the field loads are invariant in the loop
+    int weighted(int[] a) {
+        int s = 0;
+        for (int i = 0; i < a.length; i++) {
+            s += a[i] * (scale * offset);
+        }
+        return s;
+    }
+
+    // the division may throw, it is only hoisted when the loop always runs it first
+    static int divide(int[] a, int d) {
+        int s = 0;
+        for (int i = 0; i < a.length; i++) {
+            s += 100 / d + a[i];
+        }
+        return s;
+    }
+
+    // a[k] is evaluated before 100 / d, its exception must come first
+    static int order(int[] a, int k, int d) {
+        int s = 0;
+        for (int i = 0; i < 3; i++) {
+            s += a[k] + 100 / d;
+        }
+        return s;
+    }
+
+    public static void main(String[] args) {
+        int[] a = new int[]{1, 2, 3};
+        System.out.println(new LicmTest().weighted(a));
+        System.out.println(divide(a, 5));
+        try {
+            System.out.println(divide(new int[0], 0));
+            System.out.println(divide(a, 0));
+        } catch (ArithmeticException e) {
+            System.out.println("ArithmeticException");
+        }
+        try {
+            System.out.println(order(new int[1], 5, 0));
+        } catch (ArrayIndexOutOfBoundsException e) {
+            System.out.println("ArrayIndexOutOfBoundsException");
+        } catch (ArithmeticException e) {
+            System.out.println("wrong exception: ArithmeticException");
+        }
+    }
+}
@@ -0,0 +1,38 @@
+public class LockElisionTest {
+    int count;
+
+    // the lock object never escapes the method
+    static int localLock(int n) {
+        Object lock = new Object();
+        int s = 0;
+        synchronized (lock) {
+            s += n;
+        }
+        return s;
+    }
+
+    // the inner monitor is already held
+    synchronized void nested() {
+        synchronized (this) {
+            count++;
+        }
+    }
+
+    // the exit and the following enter of the same monitor merge
+    void adjacent() {
+        synchronized (this) {
+            count++;
+        }
+        synchronized (this) {
+            count += 2;
+        }
+    }
+
+    public static void main(String[] args) {
+        System.out.println(localLock(3));
+        LockElisionTest t = new LockElisionTest();
+        t.nested();
+        t.adjacent();
+        System.out.println(t.count);
+    }
+}
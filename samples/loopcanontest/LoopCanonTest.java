@@ -0,0 +1,32 @@
+public class LoopCanonTest {
+    // the loop head is reached by a fall through and by a branch from outside the loop
+    static int sum(int[] a, boolean skipFirst) {
+        int i = 0;
+        int s = 0;
+        if (skipFirst) {
+            i = 1;
+        }
+        while (i < a.length) {
+            s += a[i];
+            i++;
+        }
+        return s;
+    }
+
+    // the BB falling into the head is in the loop
+    static int countDown(int n) {
+        int c = 0;
+        do {
+            c += n;
+            n--;
+        } while (n > 0);
+        return c;
+    }
+
+    public static void main(String[] args) {
+        int[] a = new int[]{1, 2, 3, 4};
+        System.out.println(sum(a, false));
+        System.out.println(sum(a, true));
+        System.out.println(countDown(4));
+    }
+}
@@ -0,0 +1,48 @@
+public class NullCheckOptTest {
+    int a;
+    int b;
+
+    // the second access to p is already known to be non null
+    static int twice(NullCheckOptTest p) {
+        return p.a + p.b;
+    }
+
+    // after the store p is known to be non null
+    static int store(NullCheckOptTest p, int v) {
+        p.b = v;
+        return p.a + v;
+    }
+
+    // the load is dead and may be dropped, it must not stand for a null check
+    static int[] deadLoad(NullCheckOptTest p, int[] arr) {
+        int x = p.a;
+        arr[0] = p.b;
+        return arr;
+    }
+
+    // a new object is never null
+    static int fresh() {
+        NullCheckOptTest p = new NullCheckOptTest();
+        p.a = 3;
+        return p.a;
+    }
+
+    public static void main(String[] args) {
+        NullCheckOptTest p = new NullCheckOptTest();
+        p.a = 1;
+        p.b = 2;
+        System.out.println(twice(p));
+        System.out.println(fresh());
+        System.out.println(store(p, 4));
+        try {
+            System.out.println(twice(null));
+        } catch (NullPointerException e) {
+            System.out.println("NullPointerException");
+        }
+        try {
+            System.out.println(deadLoad(null, new int[1])[0]);
+        } catch (NullPointerException e) {
+            System.out.println("NullPointerException");
+        }
+    }
+}
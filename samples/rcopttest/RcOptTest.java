@@ -0,0 +1,34 @@
+class Node {
+    Node next;
+    int value;
+}
+
+public class RcOptTest {
+    // the increment of a copied reference cancels the decrement of the old value
+    static int copies(Node n) {
+        Node a = n;
+        Node b = a;
+        Node c = b.next;
+        return a.value + b.value + (c == null ? 0 : c.value);
+    }
+
+    // the local reference is overwritten, its old value is released
+    static int overwrite(Node n) {
+        Node cur = n;
+        int s = 0;
+        while (cur != null) {
+            s += cur.value;
+            cur = cur.next;
+        }
+        return s;
+    }
+
+    public static void main(String[] args) {
+        Node head = new Node();
+        head.value = 1;
+        head.next = new Node();
+        head.next.value = 2;
+        System.out.println(copies(head));
+        System.out.println(overwrite(head));
+    }
+}
@@ -0,0 +1,35 @@
+public class SccpTest {
+    // x is 10 on every path, the branch on it folds
+    static int constant(boolean flag) {
+        int x;
+        if (flag) {
+            x = 4 + 6;
+        } else {
+            x = 20 / 2;
+        }
+        if (x == 10) {
+            return 1;
+        }
+        return 2;
+    }
+
+    // i stays 0 in the loop since the branch changing it is never taken
+    static int loop(int n) {
+        int i = 0;
+        int s = 0;
+        for (int k = 0; k < n; k++) {
+            if (i != 0) {
+                i = k;
+            }
+            s += i;
+        }
+        return s;
+    }
+
+    public static void main(String[] args) {
+        System.out.println(constant(true));
+        System.out.println(constant(false));
+        System.out.println(loop(5));
+        System.out.println((byte) (127 + constant(true)));
+    }
+}
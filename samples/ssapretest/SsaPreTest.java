@@ -0,0 +1,29 @@
+public class SsaPreTest {
+    int x;
+    int y;
+
+    // x + y is computed on one path and again after the join
+    int partial(boolean flag) {
+        int a = 0;
+        if (flag) {
+            a = x + y;
+        }
+        return a + (x + y);
+    }
+
+    // the load of this.x is fully redundant
+    int loads() {
+        int a = x * 2;
+        int b = x * 3;
+        return a + b;
+    }
+
+    public static void main(String[] args) {
+        SsaPreTest t = new SsaPreTest();
+        t.x = 2;
+        t.y = 5;
+        System.out.println(t.partial(true));
+        System.out.println(t.partial(false));
+        System.out.println(t.loads());
+    }
+}
@@ -54,6 +54,11 @@ enum OptionIndex : uint64 {
   kLessThrowAlias,
   kFinalFieldAlias,
   kRegReadAtReturn,
+  kMeColdBBLayout,
+  kMeEdgeProfileGen,
+  kMeEdgeProfileUse,
+  kMeEdgeProfileMap,
+  kMeOptL2,
   //----------mpl2mpl begin---------
   kMpl2MplHelp,
   kMpl2MplDumpPhase,
@@ -72,6 +77,12 @@ enum OptionIndex : uint64 {
   kMpl2MplMapleLinker,
   kMplnkDumpMuid,
   kEmitVtableImpl,
+  kMpl2MplDevirtLevel,
+  kMpl2MplFuncLayoutProfile,
+  kMpl2MplInlineLimit,
+  kMpl2MplInlineImport,
+  kMpl2MplInlineExport,
+  kMpl2MplSwitchDensity,
   //----------mplcg begin---------
   kCGQuiet,
   kPie,
@@ -156,6 +156,21 @@ MeOption *MapleCombCompiler::MakeMeOptions(const MplOptions &options, maple::Mem
       case kRegReadAtReturn:
         meOption->regreadAtReturn = true;
         break;
+      case kMeColdBBLayout:
+        meOption->coldBBLayout = true;
+        break;
+      case kMeEdgeProfileGen:
+        meOption->edgeProfileGen = opt.Args();
+        break;
+      case kMeEdgeProfileUse:
+        meOption->edgeProfileUse = opt.Args();
+        break;
+      case kMeEdgeProfileMap:
+        meOption->edgeProfileMap = opt.Args();
+        break;
+      case kMeOptL2:
+        meOption->optLevel = MeOption::kLevelTwo;
+        break;
       default:
         WARN(kLncWarn, "input invalid key for me " + opt.OptionKey());
         break;
@@ -223,6 +238,24 @@ Options *MapleCombCompiler::MakeMpl2MplOptions(const MplOptions &options, maple:
       case kEmitVtableImpl:
         mpl2mplOption->emitVtableImpl = true;
         break;
+      case kMpl2MplDevirtLevel:
+        mpl2mplOption->devirtLevel = std::stoul(opt.Args(), nullptr);
+        break;
+      case kMpl2MplFuncLayoutProfile:
+        mpl2mplOption->funcLayoutProfile = opt.Args();
+        break;
+      case kMpl2MplInlineLimit:
+        mpl2mplOption->inlineLimit = std::stoul(opt.Args(), nullptr);
+        break;
+      case kMpl2MplInlineImport:
+        mpl2mplOption->inlineImport = opt.Args();
+        break;
+      case kMpl2MplInlineExport:
+        mpl2mplOption->inlineExport = opt.Args();
+        break;
+      case kMpl2MplSwitchDensity:
+        mpl2mplOption->switchDensity = std::stoul(opt.Args(), nullptr);
+        break;
 #if MIR_JAVA
       case kMpl2MplSkipVirtual:
         mpl2mplOption->skipVirtualMethod = true;
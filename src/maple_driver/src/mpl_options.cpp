@@ -463,6 +463,67 @@ const mapleOption::Descriptor USAGES[] = {
     "  --regreadatreturn           \tAllow register promotion to promote the operand of return statements\n",
     "me",
     { { nullptr } } },
+  { kMeColdBBLayout,
+    0,
+    nullptr,
+    "cold-bblayout",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyNone,
+    "  --cold-bblayout             \tMove catch, throw and never executed BBs to the end of functions\n",
+    "me",
+    { { nullptr } } },
+  { kMeEdgeProfileGen,
+    0,
+    nullptr,
+    "edge-profile-gen",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyRequired,
+    "  --edge-profile-gen=file     \tInstrument edge counters, write their map to file and their counts to\n"
+    "                              \tfile.counts when the program exits\n",
+    "me",
+    { { nullptr } } },
+  { kMeEdgeProfileUse,
+    0,
+    nullptr,
+    "edge-profile-use",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyRequired,
+    "  --edge-profile-use=file     \tSet BB frequencies from the edge counters dumped in file\n",
+    "me",
+    { { nullptr } } },
+  { kMeEdgeProfileMap,
+    0,
+    nullptr,
+    "edge-profile-map",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyRequired,
+    "  --edge-profile-map=file     \tMap of the counters read by --edge-profile-use\n",
+    "me",
+    { { nullptr } } },
+  { kMeOptL2,
+    0,
+    nullptr,
+    "O2",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyNone,
+    "  --O2                        \tRun the scalar, loop and RC optimizations in me\n",
+    "me",
+    { { nullptr } } },
   // mpl2mpl
   { kMpl2MplHelp,
     0,
@@ -676,6 +737,78 @@ const mapleOption::Descriptor USAGES[] = {
     "  --emitVtableImpl            \tgenerate VtableImpl file\n",
     "mpl2mpl",
     { { nullptr } } },
+  { kMpl2MplDevirtLevel,
+    0,
+    nullptr,
+    "devirt-level",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyRequired,
+    "  --devirt-level=n            \tDevirtualize calls. 0: off (default), 1: proven targets, 2: also guarded\n",
+    "mpl2mpl",
+    { { nullptr } } },
+  { kMpl2MplFuncLayoutProfile,
+    0,
+    nullptr,
+    "func-layout-profile",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyRequired,
+    "  --func-layout-profile=file  \tOrder functions by the call traces in file\n",
+    "mpl2mpl",
+    { { nullptr } } },
+  { kMpl2MplInlineLimit,
+    0,
+    nullptr,
+    "inline-limit",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyRequired,
+    "  --inline-limit=n            \tInline direct callees of at most n statements. 0: off (default)\n",
+    "mpl2mpl",
+    { { nullptr } } },
+  { kMpl2MplInlineImport,
+    0,
+    nullptr,
+    "inline-import",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyRequired,
+    "  --inline-import=file        \tAlso inline the function bodies in file, exported by other modules\n",
+    "mpl2mpl",
+    { { nullptr } } },
+  { kMpl2MplInlineExport,
+    0,
+    nullptr,
+    "inline-export",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyRequired,
+    "  --inline-export=file        \tWrite the bodies of this module's inline candidates to file\n",
+    "mpl2mpl",
+    { { nullptr } } },
+  { kMpl2MplSwitchDensity,
+    0,
+    nullptr,
+    "switch-density",
+    nullptr,
+    false,
+    nullptr,
+    mapleOption::BuildType::kBuildTypeAll,
+    mapleOption::ArgCheckPolicy::kArgCheckPolicyRequired,
+    "  --switch-density=n          \tUse jump tables for switch cases at least n percent dense (default 40)\n",
+    "mpl2mpl",
+    { { nullptr } } },
 #if MIR_JAVA
   { kMpl2MplSkipVirtual,
     0,
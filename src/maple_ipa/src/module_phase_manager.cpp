@@ -15,6 +15,10 @@
 #include "module_phase_manager.h"
 #include "class_hierarchy.h"
 #include "class_init.h"
+#include "edge_profile_dump.h"
+#include "func_layout.h"
+#include "inline.h"
+#include "switch_lowering.h"
 #include "option.h"
 #if MIR_JAVA
 #include "native_stub_func.h"
@@ -562,6 +562,32 @@ class ConstPool {
   std::unordered_map<std::u16string, MIRSymbol*> constU16StringPool;
 };
 
+// MUIDTable memoizes the MUID of global names, so that each name is hashed
+// at most once per compilation no matter how many phases ask for it.
+class MUIDTable {
+ public:
+  MUIDTable() = default;
+  MUIDTable(const MUIDTable&) = delete;
+  MUIDTable &operator=(const MUIDTable&) = delete;
+  ~MUIDTable() = default;
+
+  bool HasMUID(GStrIdx strIdx) const {
+    return muidMap.find(strIdx) != muidMap.end();
+  }
+
+  size_t Size() const {
+    return muidMap.size();
+  }
+
+  const MUID &GetOrCreateMUID(GStrIdx strIdx);
+  // Batch version, muids[i] is the MUID of strIdxVec[i].
+  // Only names not seen before are hashed, each of them once.
+  void GetOrCreateMUIDs(const std::vector<GStrIdx> &strIdxVec, std::vector<MUID> &muids);
+
+ private:
+  std::unordered_map<GStrIdx, MUID, GStrIdxHash> muidMap;
+};
+
 class GlobalTables {
  public:
   static GlobalTables &GetGlobalTables();
@@ -602,6 +628,10 @@ class GlobalTables {
     return globalTables.constPool;
   }
 
+  static MUIDTable &GetMUIDTable() {
+    return globalTables.muidTable;
+  }
+
   GlobalTables(const GlobalTables &globalTables) = delete;
   GlobalTables(const GlobalTables &&globalTables) = delete;
   GlobalTables &operator=(const GlobalTables &globalTables) = delete;
@@ -621,6 +651,7 @@ class GlobalTables {
   FunctionTable functionTable;
   GSymbolTable gSymbolTable;
   ConstPool constPool;
+  MUIDTable muidTable;
   std::unique_ptr<FPConstTable> fpConstTablePtr;
   StringTable<std::string, GStrIdx> gStringTable;
   StringTable<std::string, UStrIdx> uStrTable;
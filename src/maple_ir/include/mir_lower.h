@@ -74,6 +74,11 @@ class MIRLower {
     lowerPhase |= LOWEREXPANDARRAY;
   }
 
+  // expands the array checks of all functions, not only kSetArrayHotFunc; set when bce runs to remove redundant ones
+  void SetOptArrayMrtAll(bool optAll) {
+    optArrayMrtAll = optAll;
+  }
+
   void SetLowerBE() {
     lowerPhase |= LOWERBE;
   }
@@ -103,6 +108,7 @@ class MIRLower {
   MIRFunction *mirFunc;
   MIRBuilder *mirBuilder;
   uint32 lowerPhase;
+  bool optArrayMrtAll = false;
   LabelIdx CreateCondGotoStmt(Opcode op, BlockNode &blk, const IfStmtNode &ifStmt);
   void CreateBrFalseStmt(BlockNode &blk, const IfStmtNode &ifStmt);
   void CreateBrTrueStmt(BlockNode &blk, const IfStmtNode &ifStmt);
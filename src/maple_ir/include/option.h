@@ -28,6 +28,9 @@ constexpr uint32 kRadicalDecouple = 2;
 constexpr uint32 kNoLazyBinding = 0;
 constexpr uint32 kLazyBindingUseConditionCall = 1;
 constexpr uint32 kLazyBindingUseSegv = 2;
+constexpr uint32 kNoDevirt = 0;
+constexpr uint32 kProvenDevirt = 1;
+constexpr uint32 kGuardedDevirt = 2;
 class Options {
  public:
   explicit Options(maple::MemPool &memPool) : optionAlloc(&memPool) {}
@@ -60,6 +63,12 @@ class Options {
   static bool mapleLinker;
   static bool dumpMuidFile;
   static bool emitVtableImpl;
+  static uint32 devirtLevel;
+  static std::string funcLayoutProfile;
+  static uint32 inlineLimit;
+  static std::string inlineImport;
+  static std::string inlineExport;
+  static uint32 switchDensity;
 #if MIR_JAVA
   static bool skipVirtualMethod;
 #endif
@@ -294,6 +294,25 @@ void GSymbolTable::Dump(bool islocal, int32 indent) const {
   }
 }
 
+const MUID &MUIDTable::GetOrCreateMUID(GStrIdx strIdx) {
+  auto it = muidMap.find(strIdx);
+  if (it != muidMap.end()) {
+    return it->second;
+  }
+  const std::string &name = GlobalTables::GetStrTable().GetStringFromStrIdx(strIdx);
+  return muidMap.emplace(strIdx, GetMUID(name)).first->second;
+}
+
+void MUIDTable::GetOrCreateMUIDs(const std::vector<GStrIdx> &strIdxVec, std::vector<MUID> &muids) {
+  // Grow the table once for the whole batch instead of rehashing while inserting.
+  muidMap.reserve(muidMap.size() + strIdxVec.size());
+  muids.clear();
+  muids.reserve(strIdxVec.size());
+  for (GStrIdx strIdx : strIdxVec) {
+    muids.push_back(GetOrCreateMUID(strIdx));
+  }
+}
+
 GlobalTables GlobalTables::globalTables;
 GlobalTables &GlobalTables::GetGlobalTables() {
   return globalTables;
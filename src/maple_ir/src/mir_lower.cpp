@@ -429,6 +429,8 @@ void MIRLower::AddArrayMrtMpl(BaseNode &exp, BlockNode &newBlock) {
       IntrinsiccallNode *boundaryTrinsicCall = builder->CreateStmtIntrinsicCall(INTRN_MPL_BOUNDARY_CHECK, args);
 #endif
       newBlock.AddStatement(boundaryTrinsicCall);
+      // the check is explicit now, also keeps the access from being expanded twice when the body is lowered again
+      arrayNode->SetBoundsCheck(false);
     }
   }
 }
@@ -471,8 +473,11 @@ BlockNode *MIRLower::ExpandArrayMrtBlock(BlockNode &block) {
   return newBlock;
 }
 
+// Makes the null and bounds checks of array accesses explicit statements, so that the me phases (bce) can
+// remove the ones proven redundant and hoist the loop invariant ones. Functions outside kSetArrayHotFunc are only
+// expanded when the caller runs bce afterwards, the others keep the bounds-check flag of their accesses.
 void MIRLower::ExpandArrayMrt(MIRFunction &func) {
-  if (ShouldOptArrayMrt(func)) {
+  if (optArrayMrtAll || ShouldOptArrayMrt(func)) {
     BlockNode *origBody = func.GetBody();
     ASSERT(origBody != nullptr, "nullptr check");
     BlockNode *newBody = ExpandArrayMrtBlock(*origBody);
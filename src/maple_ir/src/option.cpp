@@ -38,6 +38,12 @@ bool Options::usePreg = false;
 bool Options::mapleLinker = false;
 bool Options::dumpMuidFile = false;
 bool Options::emitVtableImpl = false;
+uint32 Options::devirtLevel = 0;
+std::string Options::funcLayoutProfile;
+uint32 Options::inlineLimit = 0;
+std::string Options::inlineImport;
+std::string Options::inlineExport;
+uint32 Options::switchDensity = 40;
 #if MIR_JAVA
 bool Options::skipVirtualMethod = false;
 #endif
@@ -60,6 +66,12 @@ enum OptionIndex {
   kMapleLinker,
   kMplnkDumpMuid,
   kEmitVtableImpl,
+  kDevirtLevel,
+  kFuncLayoutProfile,
+  kInlineLimit,
+  kInlineImport,
+  kInlineExport,
+  kSwitchDensity,
 };
 
 const Descriptor kUsage[] = {
@@ -101,6 +113,18 @@ const Descriptor kUsage[] = {
     "  --dump-muid                       Dump MUID def information into a .muid file" },
   { kEmitVtableImpl, 0, "", "emitVtableImpl", kBuildTypeAll, kArgCheckPolicyNone,
     "  --emitVtableImpl                  Generate VtableImpl file" },
+  { kDevirtLevel, 0, "", "devirt-level", kBuildTypeAll, kArgCheckPolicyRequired,
+    "  --devirt-level=n                  Devirtualize calls. 0: off (default), 1: proven targets, 2: also guarded" },
+  { kFuncLayoutProfile, 0, "", "func-layout-profile", kBuildTypeAll, kArgCheckPolicyRequired,
+    "  --func-layout-profile=file        Order functions by the call traces in file" },
+  { kInlineLimit, 0, "", "inline-limit", kBuildTypeAll, kArgCheckPolicyRequired,
+    "  --inline-limit=n                  Inline direct callees of at most n statements. 0: off (default)" },
+  { kInlineImport, 0, "", "inline-import", kBuildTypeAll, kArgCheckPolicyRequired,
+    "  --inline-import=file              Also inline the function bodies in file, exported by other modules" },
+  { kInlineExport, 0, "", "inline-export", kBuildTypeAll, kArgCheckPolicyRequired,
+    "  --inline-export=file              Write the bodies of this module's inline candidates to file" },
+  { kSwitchDensity, 0, "", "switch-density", kBuildTypeAll, kArgCheckPolicyRequired,
+    "  --switch-density=n                Use jump tables for switch cases at least n percent dense (default 40)" },
 #if MIR_JAVA
   { kSkipVirtual, 0, "", "skipvirtual", kBuildTypeAll, kArgCheckPolicyNone, "  --skipvirtual" },
 #endif
@@ -167,6 +191,24 @@ bool Options::ParseOptions(int argc, char **argv, std::string &fileName) const {
       case kEmitVtableImpl:
         Options::emitVtableImpl = true;
         break;
+      case kDevirtLevel:
+        Options::devirtLevel = std::stoul(opt.Args(), nullptr);
+        break;
+      case kFuncLayoutProfile:
+        Options::funcLayoutProfile = opt.Args();
+        break;
+      case kInlineLimit:
+        Options::inlineLimit = std::stoul(opt.Args(), nullptr);
+        break;
+      case kInlineImport:
+        Options::inlineImport = opt.Args();
+        break;
+      case kInlineExport:
+        Options::inlineExport = opt.Args();
+        break;
+      case kSwitchDensity:
+        Options::switchDensity = std::stoul(opt.Args(), nullptr);
+        break;
 #if MIR_JAVA
       case kSkipVirtual:
         Options::skipVirtualMethod = true;
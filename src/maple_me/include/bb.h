@@ -54,6 +54,7 @@ enum BBAttr : uint32 {
 };
 
 constexpr uint32 kBBVectorInitialSize = 2;
+constexpr size_t kCondGotoSuccNum = 2;  // fallthrough and branch target of a kBBCondGoto
 using StmtNodes = PtrListRef<StmtNode>;
 using MeStmts = PtrListRef<MeStmt>;
 
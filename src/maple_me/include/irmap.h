@@ -91,6 +91,7 @@ class IRMap : public AnalysisResult {
   MeExpr *CreateIntConstMeExpr(int64, PrimType);
   MeExpr *CreateConstMeExpr(PrimType, MIRConst&);
   MeExpr *CreateMeExprBinary(Opcode, PrimType, MeExpr&, MeExpr&);
+  MeExpr *CreateMeExprCompare(Opcode, PrimType, PrimType, MeExpr&, MeExpr&);
   MeExpr *CreateMeExprSelect(PrimType, MeExpr&, MeExpr&, MeExpr&);
   MeExpr *CreateMeExprTypeCvt(PrimType, PrimType, MeExpr&);
   IntrinsiccallMeStmt *CreateIntrinsicCallMeStmt(MIRIntrinsicID idx, std::vector<MeExpr*> &opnds,
@@ -200,7 +201,6 @@ class IRMap : public AnalysisResult {
   MeExpr *BuildLHSReg(const VersionSt &verSt, RegassignMeStmt &defMeStmt, const RegassignNode &regassign);
   IvarMeExpr *BuildLHSIvar(MeExpr &baseAddr, IassignMeStmt &iassignMeStmt, FieldID fieldID);
   RegMeExpr *CreateRefRegMeExpr(const MIRSymbol&);
-  MeExpr *CreateMeExprCompare(Opcode, PrimType, PrimType, MeExpr&, MeExpr&);
   MeExpr *CreateAddrofMeExprFromNewSymbol(MIRSymbol&, PUIdx);
   VarMeExpr *GetOrCreateVarFromVerSt(const VersionSt &verSt);
   RegMeExpr *GetOrCreateRegFromVerSt(const VersionSt &verSt);
@@ -58,6 +58,8 @@ class BBLayout : public AnalysisResult {
   BB *GetFallThruBBSkippingEmpty(BB &bb);
   void ResolveUnconditionalFallThru(BB &bb, BB &nextBB);
   void ChangeToFallthruFromGoto(BB &bb);
+  bool IsHotterThan(const BB &bb1, const BB &bb2) const;
+  void SinkColdBBs();
   const MapleVector<BB*> &GetBBs() const {
     return layoutBBs;
   }
@@ -86,7 +88,12 @@ class BBLayout : public AnalysisResult {
     return laidOut.push_back(val);
   }
 
+  bool BBStartsWithTry(const BB &bb) const;
+
  private:
+  bool BBEndsWithThrow(const BB &bb) const;
+  void MarkColdBBs(std::vector<bool> &isCold) const;
+  BB *GetLayoutFallthru(const BB &bb) const;
   MeFunction &func;
   MapleAllocator layoutAlloc;
   MapleVector<BB*> layoutBBs;  // gives the determined layout order
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_BCE_H
+#define MAPLE_ME_INCLUDE_ME_BCE_H
+#include "dominance.h"
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_loop_analysis.h"
+#include "me_phase.h"
+
+namespace maple {
+// Removes the array bounds checks expanded by MIRLower::ExpandArrayMrt whose index is proven to lie in
+// [0, length). Ranges come from the comparisons of the conditional branches dominating the check, from earlier
+// checks of the same index and array, from the allocation size of the array and from induction variables that
+// only step by one towards the checked bound. Checks whose operands are loop invariant and that start the loop head
+// are first hoisted to the loop preheader.
+class BCE {
+ public:
+  BCE(MeFunction &f, Dominance &dom, IdentifyLoops &identLoops, bool enabledDebug)
+      : func(f),
+        ssaTab(*f.GetMeSSATab()),
+        dom(dom),
+        identLoops(identLoops),
+        enabledDebug(enabledDebug) {}
+
+  ~BCE() = default;
+
+  void Run();
+
+ private:
+  enum FactKind {
+    kFactLT,   // lhs < rhs, signed
+    kFactGE,   // lhs >= rhs, signed
+    kFactULT   // lhs < rhs, unsigned
+  };
+
+  struct Fact {
+    FactKind kind;
+    MeExpr *lhs;
+    MeExpr *rhs;
+  };
+
+  bool IsBoundaryCheck(const MeStmt &stmt) const;
+  MeExpr *GetDefRHS(MeExpr &expr) const;
+  MeExpr *GetCopyRoot(MeExpr &expr) const;
+  bool GetStep(MeExpr &rhs, MeExpr *&base, int64 &step) const;
+  MeExpr *GetLengthArray(MeExpr &len) const;
+  bool GetAllocSize(MeExpr &array, MeExpr *&size, int64 &constSize) const;
+  bool IsAtMostLength(MeExpr &bound, MeExpr &array) const;
+  bool HasFact(FactKind kind, const MeExpr *lhs, const MeExpr *rhs) const;
+  bool HasLowerBound(const MeExpr &value) const;
+  bool IsNonNegativeValue(MeExpr &expr, std::set<const MeExpr*> &visited) const;
+  bool IsNonNegative(MeExpr &index) const;
+  bool IsBelowLengthValue(MeExpr &expr, MeExpr &array, std::set<const MeExpr*> &visited) const;
+  bool IsBelowLength(MeExpr &index, MeExpr &array) const;
+  bool IsInBounds(MeExpr &index, MeExpr &array) const;
+  void AddFact(FactKind kind, MeExpr &lhs, MeExpr &rhs);
+  void AddBranchFacts(BB &bb);
+  void CollectStep(MeStmt &stmt);
+  void VisitStmts(BB &bb);
+  void TraverseBB(BB &bb);
+  bool IsInvariant(const LoopDesc &loop, MeExpr &expr) const;
+  bool IsHoistableCheck(const LoopDesc &loop, MeStmt &stmt) const;
+  void HoistChecks(const LoopDesc &loop);
+  MeFunction &func;
+  SSATab &ssaTab;
+  Dominance &dom;
+  IdentifyLoops &identLoops;
+  // facts along the current dominator tree path
+  std::vector<Fact> facts;
+  // values defined by x + 1 where x is below some bound, or by x - 1 where x is above some bound, so the step
+  // cannot wrap around
+  std::set<const MeExpr*> safeIncs;
+  std::set<const MeExpr*> safeDecs;
+  // false while the safe steps are collected, true while checks are removed
+  bool removing = false;
+  uint32 numChecks = 0;
+  uint32 numRemovedChecks = 0;
+  uint32 numHoistedChecks = 0;
+  bool enabledDebug;
+};
+
+class MeDoBCE : public MeFuncPhase {
+ public:
+  explicit MeDoBCE(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoBCE() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "bce";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_BCE_H
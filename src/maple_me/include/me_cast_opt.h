@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_CAST_OPT_H
+#define MAPLE_ME_INCLUDE_ME_CAST_OPT_H
+#include "class_hierarchy.h"
+#include "dominance.h"
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+
+namespace maple {
+// Removes runtime cast checks on SSA values whose dynamic type is already proven on every path reaching them.
+// Facts come from earlier checkcasts of the same value (valid once control joins after the check) and from
+// instanceof branches; they are kept along dominator tree paths, as SSA values and object classes never change.
+class CastOpt {
+ public:
+  CastOpt(MeFunction &f, Dominance &dom, KlassHierarchy &kh, bool enabledDebug)
+      : func(f), ssaTab(*f.GetMeSSATab()), dom(dom), klassHierarchy(kh), enabledDebug(enabledDebug) {}
+
+  virtual ~CastOpt() = default;
+
+  void CollectJoinFacts();
+  void TraverseBB(BB &bb);
+  void Finish() const;
+
+ private:
+  bool IsTrackedValue(const MeExpr &expr) const;
+  MeExpr *GetCopyRoot(MeExpr &expr) const;
+  MeExpr *GetDefRHS(MeExpr &expr) const;
+  Klass *GetClassInfoKlass(const MeExpr &expr) const;
+  Klass *GetCheckKlass(TyIdx tyIdx) const;
+  bool IsCastCheckCall(const MeStmt &stmt, bool &isThrow) const;
+  BB *FindCastJoinBB(BB &bb, const MeStmt &call) const;
+  bool GetInstanceOfFact(MeExpr &cond, bool &polarity, MeExpr *&value, Klass *&klass) const;
+  void AddBranchFact(BB &bb);
+  bool IsSubKlass(const Klass &sub, Klass &super) const;
+  bool IsProven(MeExpr &value, Klass &klass) const;
+  void AddFact(MeExpr &value, Klass &klass);
+  void PopFacts(size_t mark);
+  void OptimizeStmts(BB &bb);
+  MeFunction &func;
+  SSATab &ssaTab;
+  Dominance &dom;
+  KlassHierarchy &klassHierarchy;
+  // proven classes of each SSA value along the current dominator tree path
+  std::unordered_map<MeExpr*, std::vector<Klass*>> provenKlasses;
+  std::vector<MeExpr*> factStack;
+  // facts that start to hold at the join block of an earlier cast check
+  std::map<BBId, std::vector<std::pair<MeExpr*, Klass*>>> joinFacts;
+  uint32 numChecks = 0;
+  uint32 numRemovedChecks = 0;
+  bool enabledDebug;
+};
+
+class MeDoCastOpt : public MeFuncPhase {
+ public:
+  explicit MeDoCastOpt(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoCastOpt() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "castopt";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_CAST_OPT_H
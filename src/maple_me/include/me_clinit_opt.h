@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_CLINIT_OPT_H
+#define MAPLE_ME_INCLUDE_ME_CLINIT_OPT_H
+#include "class_hierarchy.h"
+#include "dominance.h"
+#include "me_function.h"
+#include "me_phase.h"
+
+namespace maple {
+// Removes JAVA_CLINIT_CHECKs of a class already initialized by a dominating check of the same class or one of its
+// subclasses, and checks of classes that need no initialization at all. It runs before ssatab, so alias analysis
+// does not have to model the removed checks.
+class ClinitOpt {
+ public:
+  ClinitOpt(MeFunction &f, Dominance &dom, KlassHierarchy &kh, bool enabledDebug)
+      : func(f), dom(dom), klassHierarchy(kh), enabledDebug(enabledDebug) {}
+
+  virtual ~ClinitOpt() = default;
+
+  void TraverseBB(BB &bb);
+  void Finish() const;
+
+ private:
+  Klass *GetClinitCheckKlass(const StmtNode &stmt) const;
+  bool IsInitialized(const Klass &klass) const;
+  MeFunction &func;
+  Dominance &dom;
+  KlassHierarchy &klassHierarchy;
+  // classes initialized by checks dominating the current statement
+  std::vector<Klass*> initializedKlasses;
+  uint32 numChecks = 0;
+  uint32 numRemovedChecks = 0;
+  bool enabledDebug;
+};
+
+class MeDoClinitOpt : public MeFuncPhase {
+ public:
+  explicit MeDoClinitOpt(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoClinitOpt() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "clinitopt";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_CLINIT_OPT_H
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_COALESCE_H
+#define MAPLE_ME_INCLUDE_ME_COALESCE_H
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+
+namespace maple {
+// SSA destruction by coalescing. Emit already gives all versions of a variable (the phi web) one symbol or preg;
+// this merges the webs of variables connected by copies when their live ranges do not interfere, so the copies
+// between them disappear and the merged-away symbols are never emitted. Only local scalar variables and pregs that
+// never appear in chi/mu lists and whose address is not taken are coalesced; references are left alone since
+// their RC is already lowered. Runs right before emit, as merging breaks the SSA form of the function.
+class Coalescer {
+ public:
+  Coalescer(MeFunction &f, bool enabledDebug) : func(f), ssaTab(*f.GetMeSSATab()), enabledDebug(enabledDebug) {}
+
+  virtual ~Coalescer() = default;
+
+  void Run();
+
+ private:
+  struct Candidate {
+    OStIdx ostIdx;
+    bool isReg;
+    bool isFormal;
+    uint32 typeKey;  // symbol TyIdx or preg primitive type, only equal keys are merged
+    std::set<RegMeExpr*> regs;  // all versions of a preg, renumbered when merged
+  };
+
+  bool IsQualified(const MeExpr &expr) const;
+  void VisitValue(MeExpr &expr);
+  void VisitExpr(MeExpr &expr);
+  void VisitStmt(MeStmt &stmt);
+  void CollectCandidates();
+  int32 GetCandidate(const MeExpr &expr) const;
+  int32 GetCopySource(const MeStmt &stmt) const;
+  void AddUses(MeExpr &expr, std::set<uint32> &live) const;
+  void AddDefs(MeStmt &stmt, std::vector<uint32> &defs) const;
+  void AddInterference(uint32 def, const std::set<uint32> &live, int32 copySrc);
+  std::set<uint32> GetLiveOut(BB &bb) const;
+  std::set<uint32> GetLiveIn(BB &bb, bool addInterference);
+  void ComputeLiveness();
+  void BuildInterference();
+  uint32 FindRep(uint32 idx);
+  bool Interferes(uint32 rep1, uint32 rep2);
+  void CoalesceCopies();
+  void Rewrite();
+  MeFunction &func;
+  SSATab &ssaTab;
+  std::vector<Candidate> candidates;
+  std::map<OStIdx, uint32> candidateOfOst;
+  std::set<OStIdx> disqualifiedOsts;
+  // indexed by BBId
+  std::vector<std::set<uint32>> liveIns;
+  std::vector<std::set<uint32>> interference;
+  std::vector<uint32> reps;
+  uint32 numRemovedCopies = 0;
+  bool enabledDebug;
+};
+
+class MeDoCoalesce : public MeFuncPhase {
+ public:
+  explicit MeDoCoalesce(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoCoalesce() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "coalesce";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_COALESCE_H
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_COPY_PROP_H
+#define MAPLE_ME_INCLUDE_ME_COPY_PROP_H
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+
+namespace maple {
+// Replaces the uses of a copy x = y by y, leaving the copy dead for dce. Emit maps all versions of a variable to one
+// symbol or preg, so y may only be read where it still holds the copied version: either y has no other definition
+// in the function, or the use follows the copy in the same block before y is redefined.
+class CopyProp {
+ public:
+  CopyProp(MeFunction &f, MeIRMap &irMap, bool enabledDebug)
+      : func(f), irMap(irMap), ssaTab(*f.GetMeSSATab()), enabledDebug(enabledDebug) {}
+
+  virtual ~CopyProp() = default;
+
+  void Run();
+
+ private:
+  OStIdx GetOStIdx(const MeExpr &expr) const;
+  bool IsCopySource(const MeExpr &expr) const;
+  MeExpr *GetCopyRHS(const MeStmt &stmt) const;
+  void CountDef(const MeExpr &lhs);
+  void CountDefs();
+  bool IsSingleDef(const MeExpr &value) const;
+  void CollectCopies();
+  void CollectLeaves(MeExpr &expr, std::vector<MeExpr*> &leaves) const;
+  MeExpr *GetRoot(MeExpr &value) const;
+  void KillLocalCopies(const MeExpr &lhs);
+  void PropagateInStmt(MeStmt &stmt);
+  MeFunction &func;
+  MeIRMap &irMap;
+  SSATab &ssaTab;
+  // number of definitions of each variable and preg, phis and chis included
+  std::map<OStIdx, uint32> numDefs;
+  // copies whose source has a single definition, valid wherever the copy reaches
+  std::unordered_map<const MeExpr*, MeExpr*> globalCopies;
+  // copies of the current block whose source was not redefined since
+  std::unordered_map<const MeExpr*, MeExpr*> localCopies;
+  uint32 numReplacedUses = 0;
+  bool enabledDebug;
+};
+
+class MeDoCopyProp : public MeFuncPhase {
+ public:
+  explicit MeDoCopyProp(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoCopyProp() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "copyprop";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_COPY_PROP_H
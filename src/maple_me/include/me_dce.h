@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_DCE_H
+#define MAPLE_ME_INCLUDE_ME_DCE_H
+#include "dominance.h"
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_loop_analysis.h"
+#include "me_phase.h"
+
+namespace maple {
+// Aggressive dead code elimination: everything is dead unless proven live. Statements with effects outside the
+// function are live, and so are the definitions of the values a live statement uses and the branches a live block
+// is control dependent on, found in the post-dominance frontier of the block. Dead assignments and phis are
+// removed, and a dead conditional branch jumps straight to its immediate post-dominator.
+class AggressiveDCE {
+ public:
+  AggressiveDCE(MeFunction &f, Dominance &dom, IdentifyLoops &loops, bool enabledDebug)
+      : func(f), ssaTab(*f.GetMeSSATab()), dom(dom), loops(loops), enabledDebug(enabledDebug) {}
+
+  virtual ~AggressiveDCE() = default;
+
+  void Run();
+
+  bool IsCFGChanged() const {
+    return numRemovedBranches != 0;
+  }
+
+ private:
+  bool HasSideEffect(MeExpr &expr) const;
+  bool IsEssential(MeStmt &stmt) const;
+  void MarkBBLive(BB &bb);
+  void MarkBranchLive(BB &bb);
+  void MarkStmtLive(MeStmt &stmt);
+  void MarkValueLive(MeExpr &value);
+  void MarkExprLive(MeExpr &expr);
+  void MarkMuListLive(MapleMap<OStIdx, VarMeExpr*> &muList);
+  void VisitValue(MeExpr &value);
+  void VisitStmt(MeStmt &stmt);
+  template <typename PhiNode>
+  void VisitPhi(PhiNode &phi);
+  void MarkEssentials();
+  void Propagate();
+  void RemoveDeadPhis(BB &bb);
+  bool RemoveDeadBranch(BB &bb);
+  void RemoveDeadCode();
+  uint32 CountStmts() const;
+  MeFunction &func;
+  SSATab &ssaTab;
+  Dominance &dom;
+  IdentifyLoops &loops;
+  std::vector<bool> liveBBs;
+  std::unordered_set<const MeStmt*> liveStmts;
+  // SSA values whose definition is live
+  std::unordered_set<const MeExpr*> liveValues;
+  std::vector<MeStmt*> stmtWorkList;
+  std::vector<MeExpr*> valueWorkList;
+  uint32 numRemovedStmts = 0;
+  uint32 numRemovedPhis = 0;
+  uint32 numRemovedBranches = 0;
+  bool enabledDebug;
+};
+
+class MeDoDCE : public MeFuncPhase {
+ public:
+  explicit MeDoDCE(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoDCE() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "dce";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_DCE_H
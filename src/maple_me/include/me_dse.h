@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_DSE_H
+#define MAPLE_ME_INCLUDE_ME_DSE_H
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+
+namespace maple {
+// Removes field and element stores overwritten later in the same block before anything may read them. The chi
+// nodes of a store define the versions of its alias class; the store is dead when those versions only flow, through
+// the chis of the statements in between, into the chis of a store to the same base, field and type, and no mu or
+// read uses them on the way. The dead store disappears before rclowering, together with its write barrier.
+class DeadStoreElim {
+ public:
+  DeadStoreElim(MeFunction &f, bool enabledDebug) : func(f), ssaTab(*f.GetMeSSATab()), enabledDebug(enabledDebug) {}
+
+  ~DeadStoreElim() = default;
+
+  void Run();
+
+ private:
+  bool IsStoreVersion(const MeExpr &expr) const;
+  bool IsSafeExpr(MeExpr &expr, const MeExpr &base) const;
+  bool IsSafeStmt(MeStmt &stmt, const MeExpr &base, bool inTry) const;
+  bool IsSameLocation(IassignMeStmt &store, IassignMeStmt &other) const;
+  void FollowChis(MeStmt &stmt);
+  bool IsKilled(IassignMeStmt &store, IassignMeStmt &killer) const;
+  bool RemoveIfDead(BB &bb, IassignMeStmt &store);
+  MeFunction &func;
+  SSATab &ssaTab;
+  // the latest version of each alias class the store under test defines, and the chi first using its own version
+  std::map<OStIdx, VarMeExpr*> storeVersions;
+  std::map<OStIdx, ChiMeNode*> firstUses;
+  uint32 numStores = 0;
+  uint32 numRemovedStores = 0;
+  bool enabledDebug;
+};
+
+class MeDoDSE : public MeFuncPhase {
+ public:
+  explicit MeDoDSE(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoDSE() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "dse";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_DSE_H
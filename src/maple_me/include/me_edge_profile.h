@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_EDGE_PROFILE_H
+#define MAPLE_ME_INCLUDE_ME_EDGE_PROFILE_H
+#include <fstream>
+#include "me_function.h"
+#include "me_phase.h"
+
+namespace maple {
+// the counters of a module are named after this prefix and the module file name
+static constexpr char kEdgeCounterTabPrefixStr[] = "__edgeprof_counters";
+
+// execution counts of the CFG edges of a function, keyed by (source BBId, destination BBId)
+using EdgeCountMap = std::map<std::pair<uint32, uint32>, uint64>;
+
+// Edge profiling, run before ssatab so that the instrumented and the optimized builds see the same CFG.
+// With MeOption::edgeProfileGen, a counter is added on each CFG edge left out of a spanning tree (Knuth's minimal
+// instrumentation). The counters of a module live in one u64 array and the map file gets a line per counter:
+//     <index> <function> <source BBId> <destination BBId>
+// The edgeprofiledump module phase then makes the program append the counters to the map file name plus ".counts"
+// when it exits.
+// With MeOption::edgeProfileUse, the counters dumped as "<index> <count>" lines are matched with the map given by
+// MeOption::edgeProfileMap, the counts of the tree edges are recovered by flow conservation, and each BB gets its
+// execution count as frequency, which bblayout and later phases read.
+class EdgeProfile {
+ public:
+  EdgeProfile(MeFunction &f, bool enabledDebug) : func(f), enabledDebug(enabledDebug) {}
+
+  ~EdgeProfile() = default;
+
+  // returns the number of counters added from firstCounter on, 0 if the function is not instrumented
+  uint32 Instrument(MIRSymbol &counterTable, uint32 firstCounter, std::ostream &mapFile);
+  void SetFrequencies(const EdgeCountMap &counts);
+
+ private:
+  struct Edge {
+    BB *src;
+    BB *dst;
+    bool inTree;
+  };
+
+  void CollectEdges();
+  uint32 FindRoot(std::vector<uint32> &roots, uint32 id) const;
+  bool AddTreeEdge(std::vector<uint32> &roots, Edge &edge) const;
+  bool CanInstrument(const Edge &edge) const;
+  bool BuildSpanningTree();
+  BaseNode *CreateCounterAddr(const MIRSymbol &counterTable, uint32 index) const;
+  StmtNode *CreateIncrement(const MIRSymbol &counterTable, uint32 index) const;
+  void InsertIncrement(const Edge &edge, StmtNode &increment) const;
+  MeFunction &func;
+  // the CFG edges, plus the edges to the common exit BB and the virtual edge from the common exit to the common entry
+  std::vector<Edge> edges;
+  std::vector<uint32> numSuccs;
+  std::vector<uint32> numPreds;
+  bool enabledDebug;
+};
+
+class MeDoEdgeProfile : public MeFuncPhase {
+ public:
+  explicit MeDoEdgeProfile(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoEdgeProfile() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "edgeprofile";
+  }
+
+ private:
+  void ReadProfile();
+  // the phase object lives as long as the module is optimized, so the counter table and the profile are shared by
+  // all functions of the module
+  MIRSymbol *counterTable = nullptr;
+  uint32 numCounters = 0;
+  std::ofstream mapFile;
+  bool profileRead = false;
+  std::map<std::string, EdgeCountMap> edgeCounts;
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_EDGE_PROFILE_H
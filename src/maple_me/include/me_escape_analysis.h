@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_ESCAPE_ANALYSIS_H
+#define MAPLE_ME_INCLUDE_ME_ESCAPE_ANALYSIS_H
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+
+namespace maple {
+// how a parameter is used by a callee
+struct ParamSummary {
+  bool noEscape;  // never stored, returned, thrown or passed to unknown code
+  bool readOnly;  // additionally none of its fields is written
+};
+
+using EscapeSummaryMap = std::map<PUIdx, std::vector<ParamSummary>>;
+
+// Intraprocedural escape analysis of the objects allocated in a function. An allocation site does not escape when
+// every SSA value it may flow into (through local copies and phis) is only dereferenced, compared, locked or passed
+// to a direct callee whose summary shows the parameter does not escape. Callee summaries are computed from the MIR
+// body of the callee and shared by all functions of the module.
+// The result does not remove RC operations. A non-escaping object is still freed by the DecRef that the cleanup of
+// its local ref vars runs on normal exit and on unwinding, and that DecRef balances every IncRef made on the way.
+// Dropping the IncRef/DecRef of such objects needs runtime support for objects owned by a frame, which does not
+// exist; rclowering only uses the result to keep fresh objects initialized in place, and lockelision to drop locks.
+class EscapeAnalysis : public AnalysisResult {
+ public:
+  EscapeAnalysis(MemPool &memPool, MeFunction &f, EscapeSummaryMap &summaries, bool enabledDebug)
+      : AnalysisResult(&memPool),
+        func(f),
+        ssaTab(*f.GetMeSSATab()),
+        summaries(summaries),
+        enabledDebug(enabledDebug) {}
+
+  virtual ~EscapeAnalysis() = default;
+
+  void Run();
+  // true if expr is a local value all of whose possible allocation sites do not escape
+  bool IsNonEscaping(MeExpr &expr) const;
+  // true if the direct callee of call neither leaks nor writes to its i-th argument
+  bool IsReadOnlyCallArg(const CallMeStmt &call, size_t i);
+
+ private:
+  enum EscapeContext {
+    kEscapeUnsafe,
+    kEscapeLoadBase,
+    kEscapeStoreBase,
+    kEscapeCompare
+  };
+
+  bool IsLocalValue(const MeExpr &expr) const;
+  bool IsAllocation(const MeExpr &rhs) const;
+  MeExpr *GetCopySource(MeExpr &rhs) const;
+  bool IsRuntimeCheckCall(const MIRFunction &callee) const;
+  bool AllSitesNonEscaping(MeExpr &expr, std::set<const MeExpr*> &visited) const;
+  void CollectSites();
+  bool AddPointsTo(MeExpr &to, const MeExpr &from);
+  void PropagatePointsTo();
+  void MarkEscape(const MeExpr &value);
+  void VisitExpr(MeExpr &expr, EscapeContext context);
+  void VisitBaseExpr(MeExpr &base, EscapeContext context);
+  void VisitCallArgs(CallMeStmt &call);
+  void VisitStmt(MeStmt &stmt);
+  void MarkAddressTakenSites();
+  const std::vector<ParamSummary> &GetSummary(PUIdx puIdx, uint32 depth);
+  void ComputeSummary(const MIRFunction &callee, std::vector<ParamSummary> &summary, uint32 depth);
+  void VisitMIRExpr(const MIRFunction &callee, const BaseNode &expr, EscapeContext context,
+                    std::vector<ParamSummary> &summary, uint32 depth);
+  void VisitMIRBaseExpr(const MIRFunction &callee, const BaseNode &base, EscapeContext context,
+                        std::vector<ParamSummary> &summary, uint32 depth);
+  void VisitMIRStmt(const MIRFunction &callee, const StmtNode &stmt, std::vector<ParamSummary> &summary,
+                    uint32 depth);
+  MeFunction &func;
+  SSATab &ssaTab;
+  EscapeSummaryMap &summaries;
+  // callees whose summary is being computed, to cut recursion
+  std::set<PUIdx> pendingSummaries;
+  // allocation sites, indexed by the SSA value they define
+  std::map<const MeExpr*, uint32> siteOfValue;
+  std::vector<bool> siteEscapes;
+  // allocation sites each local SSA value may refer to
+  std::map<const MeExpr*, std::set<uint32>> pointsTo;
+  // local variables whose address is taken, any site stored into them escapes
+  std::set<OStIdx> addressTakenOsts;
+  bool enabledDebug;
+};
+
+class MeDoEscapeAnalysis : public MeFuncPhase {
+ public:
+  explicit MeDoEscapeAnalysis(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoEscapeAnalysis() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "escapeanalysis";
+  }
+
+ private:
+  // summaries survive across functions, the phase object lives as long as the module is optimized
+  EscapeSummaryMap summaries;
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_ESCAPE_ANALYSIS_H
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_IV_OPT_H
+#define MAPLE_ME_INCLUDE_ME_IV_OPT_H
+#include "dominance.h"
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_loop_analysis.h"
+#include "me_phase.h"
+
+namespace maple {
+// Induction variable optimizations on the natural loops found by meloop.
+// A basic IV is a phi at the loop head whose value from the latch adds a constant step to it. A derived IV is
+// biv * scale + offset, written as mul or shl by a constant plus an invariant offset. Each derived IV gets a new
+// preg kept in i64 alongside the basic IV (strength reduction: one add per iteration instead of the multiply), and
+// its uses read the preg, truncated back to 32 bits for i32. A signed less-than exit test of an i32 IV stepping by 1
+// is rewritten to compare the preg with the limit scaled the same way (linear function test replacement); the i64
+// preg never wraps around, so the test is exact. A basic IV left without other uses is removed by dce.
+class IVOpt {
+ public:
+  IVOpt(MeFunction &f, Dominance &dom, IdentifyLoops &identLoops, bool enabledDebug)
+      : func(f),
+        irMap(*f.GetIRMap()),
+        ssaTab(*f.GetMeSSATab()),
+        dom(dom),
+        identLoops(identLoops),
+        enabledDebug(enabledDebug) {}
+
+  virtual ~IVOpt() = default;
+
+  void Run();
+
+ private:
+  struct BasicIV {
+    MeExpr *phiValue;   // defined by the phi at the head
+    MeExpr *nextValue;  // value from the latch
+    MeExpr *init;       // value from the preheader
+    MeStmt *incStmt;    // defines nextValue
+    int64 step;
+  };
+
+  struct DerivedIV {
+    BasicIV *biv;
+    int64 scale;
+    MeExpr *offset;  // invariant i64 value, nullptr if none
+    RegMeExpr *phiReg;
+    RegMeExpr *nextReg;
+  };
+
+  bool IsInvariant(const LoopDesc &loop, MeExpr &expr) const;
+  bool GetIntConst(MeExpr &expr, int64 &value) const;
+  bool GetStep(MeExpr &rhs, const MeExpr &phiValue, int64 &step) const;
+  MeStmt *GetDefStmt(MeExpr &value) const;
+  void AddBasicIV(const LoopDesc &loop, MeExpr &phiValue, MeExpr &init, MeExpr &next);
+  void FindBasicIVs(const LoopDesc &loop);
+  bool MatchScaled(MeExpr &expr, BasicIV *&biv, bool &isNext, int64 &scale);
+  bool MatchDerived(const LoopDesc &loop, MeExpr &expr, BasicIV *&biv, bool &isNext, int64 &scale,
+                    MeExpr *&offset);
+  bool IsBeforeInc(const BasicIV &biv, MeStmt &stmt);
+  bool IsAfterInc(const BasicIV &biv, MeStmt &stmt);
+  MeExpr *ToI64(MeExpr &expr);
+  RegMeExpr *Materialize(const LoopDesc &loop, MeExpr &expr);
+  DerivedIV &GetDerivedIV(const LoopDesc &loop, BasicIV &biv, int64 scale, MeExpr *offset);
+  void CollectDerived(const LoopDesc &loop, MeExpr &expr, std::vector<MeExpr*> &exprs);
+  void ReduceInStmt(const LoopDesc &loop, MeStmt &stmt);
+  void ReplaceTest(const LoopDesc &loop, BB &bb);
+  void OptimizeLoop(const LoopDesc &loop);
+  MeFunction &func;
+  IRMap &irMap;
+  SSATab &ssaTab;
+  Dominance &dom;
+  IdentifyLoops &identLoops;
+  // results for the current loop
+  std::vector<BasicIV> basicIVs;
+  std::deque<DerivedIV> derivedIVs;
+  int32 preheaderIdx = 0;
+  int32 latchIdx = 0;
+  uint32 numReducedExprs = 0;
+  uint32 numReplacedTests = 0;
+  bool enabledDebug;
+};
+
+class MeDoIVOpt : public MeFuncPhase {
+ public:
+  explicit MeDoIVOpt(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoIVOpt() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "ivopt";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_IV_OPT_H
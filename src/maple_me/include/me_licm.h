@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_LICM_H
+#define MAPLE_ME_INCLUDE_ME_LICM_H
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_loop_analysis.h"
+#include "me_phase.h"
+
+namespace maple {
+// Hoists loop-invariant scalar expressions into a new register assigned at the end of the loop preheader. Operands
+// must be defined outside the loop, and memory reads must not be written in the loop: the mu of the load is defined
+// outside the loop, or the load is of a final field or an array length. An expression that may throw is only hoisted
+// when the loop would evaluate it first anyway, or when its base object is known to be non-null.
+class LICM {
+ public:
+  LICM(MeFunction &f, IdentifyLoops &identLoops, bool enabledDebug)
+      : func(f),
+        irMap(*f.GetIRMap()),
+        ssaTab(*f.GetMeSSATab()),
+        identLoops(identLoops),
+        enabledDebug(enabledDebug) {}
+
+  ~LICM() = default;
+
+  void Run();
+
+ private:
+  bool IsDefinedOutside(const LoopDesc &loop, MeExpr &expr) const;
+  bool IsNonNull(MeExpr &expr) const;
+  bool MayThrow(MeExpr &expr) const;
+  bool IsInvariant(const LoopDesc &loop, MeExpr &expr);
+  bool IsHoistable(const LoopDesc &loop, MeExpr &expr, bool canThrowFirst);
+  void CollectHoistable(const LoopDesc &loop, MeExpr &expr, bool &canThrowFirst, std::vector<MeExpr*> &exprs);
+  RegMeExpr *Hoist(const LoopDesc &loop, MeExpr &expr);
+  void HoistInBB(const LoopDesc &loop, BB &bb);
+  void HoistInLoop(const LoopDesc &loop);
+  MeFunction &func;
+  IRMap &irMap;
+  SSATab &ssaTab;
+  IdentifyLoops &identLoops;
+  // results for the current loop
+  std::map<const MeExpr*, bool> invariants;
+  std::map<const MeExpr*, RegMeExpr*> hoistedRegs;
+  // whether an expression that may throw in the first statement of the current loop can be hoisted
+  bool canHoistThrowing = false;
+  uint32 numHoisted = 0;
+  bool enabledDebug;
+};
+
+class MeDoLICM : public MeFuncPhase {
+ public:
+  explicit MeDoLICM(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoLICM() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "licm";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_LICM_H
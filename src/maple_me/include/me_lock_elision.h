@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_LOCK_ELISION_H
+#define MAPLE_ME_INCLUDE_ME_LOCK_ELISION_H
+#include "me_escape_analysis.h"
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+
+namespace maple {
+// Removes syncenter/syncexit that cannot matter:
+//  - monitor operations on objects that do not escape the function, no other thread can lock them;
+//  - nested operations on a monitor already held, found by a forward dataflow of the lock depth;
+//  - an exit immediately followed by an enter of the same monitor, the two regions are merged.
+// The chis of a removed statement are dropped without renaming their uses, which leaves stale versions in later
+// mu/chi lists. This is only sound because sync chis define non-local or address-taken osts, which no later phase
+// rewrites: rclowering and rcopt only look at must-defs, coalesce rejects such osts up front rather than through the
+// chi/mu lists, and emit gives all versions one symbol. A phase running after this one must not rely on the chi/mu
+// lists of memory being complete.
+// The phase runs before rclowering, so the escape analysis it reads describes the IR it changes; the RC calls
+// inserted later would otherwise appear as unknown uses of every allocation.
+class LockElision {
+ public:
+  LockElision(MeFunction &f, EscapeAnalysis &escapeAnalysis, bool enabledDebug)
+      : func(f), escapeAnalysis(escapeAnalysis), enabledDebug(enabledDebug) {}
+
+  virtual ~LockElision() = default;
+
+  void Run();
+
+ private:
+  bool IsSync(const MeStmt &stmt) const {
+    return stmt.GetOp() == OP_syncenter || stmt.GetOp() == OP_syncexit;
+  }
+
+  MeExpr *GetMonitor(const MeStmt &stmt) const;
+  int32 Step(const MeStmt &stmt, int32 depth) const;
+  bool IsSafeExpr(const MeExpr &expr) const;
+  bool IsSafeStmt(const MeStmt &stmt) const;
+  void RemoveSync(BB &bb, MeStmt &stmt, const char *reason);
+  void RemoveNonEscaping();
+  void ComputeDepths(std::vector<int32> &inDepths) const;
+  void RemoveNested();
+  MeStmt *FindAdjacentEnter(MeStmt &exit) const;
+  void MergeAdjacent();
+  MeFunction &func;
+  EscapeAnalysis &escapeAnalysis;
+  // the only monitor locked by the function, nullptr if there are several
+  MeExpr *monitor = nullptr;
+  uint32 numRemovedSyncs = 0;
+  bool enabledDebug;
+};
+
+class MeDoLockElision : public MeFuncPhase {
+ public:
+  explicit MeDoLockElision(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoLockElision() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "lockelision";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_LOCK_ELISION_H
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_LOOP_ANALYSIS_H
+#define MAPLE_ME_INCLUDE_ME_LOOP_ANALYSIS_H
+#include "dominance.h"
+#include "me_function.h"
+#include "me_phase.h"
+
+namespace maple {
+// A natural loop: the BBs reaching one of the latches without going through the head, which dominates them all.
+// Back edges sharing a head make a single loop.
+struct LoopDesc {
+  LoopDesc(MapleAllocator &alloc, BB &headBB)
+      : head(&headBB), latches(alloc.Adapter()), loopBBs(std::less<BBId>(), alloc.Adapter()) {}
+
+  bool Has(const BB &bb) const {
+    return loopBBs.find(bb.GetBBId()) != loopBBs.end();
+  }
+
+  BB *head;
+  MapleVector<BB*> latches;
+  MapleSet<BBId> loopBBs;
+  LoopDesc *parent = nullptr;
+  uint32 nestDepth = 1;
+  // the only predecessor of head outside the loop, if head is its only successor
+  BB *preheader = nullptr;
+};
+
+class IdentifyLoops : public AnalysisResult {
+ public:
+  IdentifyLoops(MemPool &memPool, MeFunction &f, Dominance &dom)
+      : AnalysisResult(&memPool),
+        alloc(&memPool),
+        func(f),
+        dom(dom),
+        meLoops(alloc.Adapter()),
+        bbLoops(f.GetAllBBs().size(), nullptr, alloc.Adapter()) {}
+
+  virtual ~IdentifyLoops() = default;
+
+  void Run();
+  void Dump() const;
+
+  // outer loops come before the loops nested in them
+  const MapleVector<LoopDesc*> &GetMeLoops() const {
+    return meLoops;
+  }
+
+  // the innermost loop containing bb
+  LoopDesc *GetBBLoop(const BB &bb) const {
+    return bb.GetBBId() < bbLoops.size() ? bbLoops[bb.GetBBId()] : nullptr;
+  }
+
+ private:
+  void CollectLoopBBs(LoopDesc &loop, BB &latch);
+  void SetParent(LoopDesc &loop);
+  void SetPreheader(LoopDesc &loop);
+  MapleAllocator alloc;
+  MeFunction &func;
+  Dominance &dom;
+  MapleVector<LoopDesc*> meLoops;
+  MapleVector<LoopDesc*> bbLoops;
+};
+
+class MeDoMeLoop : public MeFuncPhase {
+ public:
+  explicit MeDoMeLoop(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoMeLoop() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "meloop";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_LOOP_ANALYSIS_H
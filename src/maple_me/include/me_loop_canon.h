@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_LOOP_CANON_H
+#define MAPLE_ME_INCLUDE_ME_LOOP_CANON_H
+#include "me_function.h"
+#include "me_loop_analysis.h"
+#include "me_phase.h"
+
+namespace maple {
+// Gives each loop a preheader: an empty BB reached from every predecessor of the head outside the loop, where LICM
+// can place hoisted code. The preheaders are added to the CFG of the function in place, before ssatab, and the
+// dominance and loop results are invalidated.
+class LoopCanon {
+ public:
+  LoopCanon(MeFunction &f, IdentifyLoops &identLoops, bool enabledDebug)
+      : func(f), identLoops(identLoops), enabledDebug(enabledDebug) {}
+
+  ~LoopCanon() = default;
+
+  // returns true if any preheader was added
+  bool Run();
+
+ private:
+  // where the preheader of a loop goes, decided before any BB is added as that renumbers the BBs
+  struct PreheaderPlan {
+    BB *head;
+    std::vector<BB*> outsidePreds;
+    bool jumpsToHead;  // the BB falling into the head is in the loop, the preheader goes last and jumps to the head
+  };
+
+  bool IsBranchTo(const StmtNode &stmt, LabelIdx labelIdx) const;
+  void Retarget(StmtNode &stmt, LabelIdx from, LabelIdx to) const;
+  bool FallsThruTo(const BB &bb, const BB &succ) const;
+  bool PlanPreheader(const LoopDesc &loop, PreheaderPlan &plan);
+  void InsertPreheader(const PreheaderPlan &plan);
+  MeFunction &func;
+  IdentifyLoops &identLoops;
+  bool enabledDebug;
+};
+
+class MeDoLoopCanon : public MeFuncPhase {
+ public:
+  explicit MeDoLoopCanon(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoLoopCanon() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "loopcanon";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_LOOP_CANON_H
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_NULL_CHECK_OPT_H
+#define MAPLE_ME_INCLUDE_ME_NULL_CHECK_OPT_H
+#include "dominance.h"
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+
+namespace maple {
+// Removes assertnonnull statements on SSA values already proven non-null. A value is non-null when it is this,
+// a new allocation or a phi of non-null values, and, along dominator tree paths, after an earlier check or a kept
+// field access of the value inside the guard page, or on the non-null side of a comparison with null.
+class NullCheckOpt {
+ public:
+  NullCheckOpt(MeFunction &f, Dominance &dom, bool enabledDebug)
+      : func(f), ssaTab(*f.GetMeSSATab()), dom(dom), enabledDebug(enabledDebug) {}
+
+  ~NullCheckOpt() = default;
+
+  void TraverseBB(BB &bb);
+  void Finish() const;
+
+ private:
+  bool IsTrackedValue(const MeExpr &expr) const;
+  MeExpr *GetDefRHS(MeExpr &expr) const;
+  MeExpr *GetCopyRoot(MeExpr &expr) const;
+  bool IsThis(const MeExpr &expr) const;
+  bool IsNonNullValue(MeExpr &expr, std::set<const MeExpr*> &visited) const;
+  bool IsNonNull(MeExpr &value) const;
+  void AddFact(MeExpr &value);
+  void AddBranchFact(BB &bb);
+  bool IsGuardedAccess(const IvarMeExpr &ivar) const;
+  void CollectDerefs(MeExpr &expr, std::vector<MeExpr*> &bases) const;
+  void OptimizeStmts(BB &bb);
+  MeFunction &func;
+  SSATab &ssaTab;
+  Dominance &dom;
+  // number of facts on each value along the current dominator tree path
+  std::unordered_map<const MeExpr*, uint32> nonNullFacts;
+  std::vector<MeExpr*> factStack;
+  uint32 numChecks = 0;
+  uint32 numRemovedChecks = 0;
+  bool enabledDebug;
+};
+
+class MeDoNullCheckOpt : public MeFuncPhase {
+ public:
+  explicit MeDoNullCheckOpt(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoNullCheckOpt() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "nullcheckopt";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_NULL_CHECK_OPT_H
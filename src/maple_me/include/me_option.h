@@ -53,6 +53,10 @@ class MeOption {
   static bool lessThrowAlias;
   static bool finalFieldAlias;
   static bool regreadAtReturn;
+  static bool coldBBLayout;
+  static std::string edgeProfileGen;
+  static std::string edgeProfileUse;
+  static std::string edgeProfileMap;
   void SplitPhases(const std::string &str, std::unordered_set<std::string> &set) const;
   void SplitSkipPhases(const std::string &str) {
     SplitPhases(str, skipPhases);
@@ -15,6 +15,7 @@
 #ifndef MAPLE_ME_INCLUDE_ME_RC_LOWERING_H
 #define MAPLE_ME_INCLUDE_ME_RC_LOWERING_H
 #include "class_hierarchy.h"
+#include "me_escape_analysis.h"
 #include "me_function.h"
 #include "me_irmap.h"
 #include "me_phase.h"
@@ -23,12 +24,13 @@
 namespace maple {
 class RCLowering {
  public:
-  RCLowering(MeFunction &f, KlassHierarchy &kh, bool enabledDebug)
+  RCLowering(MeFunction &f, KlassHierarchy &kh, EscapeAnalysis &ea, bool enabledDebug)
       : func(f),
         mirModule(f.GetMIRModule()),
         irMap(*f.GetIRMap()),
         ssaTab(*f.GetMeSSATab()),
         klassHierarchy(kh),
+        escapeAnalysis(ea),
         enabledDebug(enabledDebug) {}
 
   virtual ~RCLowering() = default;
@@ -41,6 +43,18 @@ class RCLowering {
   void FastBBLower(BB &bb);
 
  private:
+  // fields of a fresh object that may already hold a non-null value
+  struct FreshObjectInfo {
+    bool constructed = false;
+    std::set<FieldID> initializedFields;
+
+    bool operator==(const FreshObjectInfo &other) const {
+      return constructed == other.constructed && initializedFields == other.initializedFields;
+    }
+  };
+  // objects allocated in this function that no other reference can reach yet
+  using FreshObjects = std::map<MeExpr*, FreshObjectInfo>;
+
   void MarkLocalRefVar();
   void MarkAllRefOpnds();
   void BBLower(BB &bb);
@@ -61,7 +75,12 @@ class RCLowering {
   MIRIntrinsicID PrepareVolatileCall(const MeStmt &stmt, const MIRIntrinsicID index = INTRN_UNDEFINED);
   IntrinsiccallMeStmt *CreateRCIntrinsic(const MIRIntrinsicID intrnID, const MeStmt &stmt, std::vector<MeExpr*> &opnds,
                                          bool assigned = false);
-  void InitializedObjectFields(MeStmt &stmt);
+  void RemovePublishedObjects(MeExpr &expr, bool isSafeUse, FreshObjects &objects) const;
+  void UpdateFreshObjectsAtCall(CallMeStmt &call, FreshObjects &objects);
+  void UpdateFreshObjects(MeStmt &stmt, FreshObjects &objects);
+  void MeetFreshObjects(FreshObjects &objects, const FreshObjects &predObjects) const;
+  bool GetFreshObjectsAtEntry(BB &bb, const std::map<BBId, FreshObjects> &objectsAtExit, FreshObjects &objects) const;
+  void ComputeFreshObjects();
   bool IsInitialized(IvarMeExpr &ivar);
   void PreprocessAssignMeStmt(MeStmt &stmt);
   void HandleAssignMeStmtRHS(MeStmt &stmt);
@@ -89,16 +108,18 @@ class RCLowering {
   IRMap &irMap;
   SSATab &ssaTab;
   KlassHierarchy &klassHierarchy;
+  EscapeAnalysis &escapeAnalysis;
   std::vector<MeStmt*> rets{};  // std::vector of return statement
   unsigned int tmpCount = 0;
   bool needSpecialHandleException = false;
   std::set<MIRSymbol*> assignedPtrSym;
   std::set<VarMeExpr*> tmpLocalRefVars;
-  std::set<MeExpr*> gcMallocObjects{};
   std::map<OStIdx, VarMeExpr*> cleanUpVars{};
   std::map<OStIdx, OriginalSt*> varOStMap{};
-  // used to store initialized map, help to optimize dec ref in first assignment
-  std::unordered_map<MeExpr*, MapleSet<FieldID>*> initializedFields{};
+  // fresh objects at the entry of each BB, help to optimize dec ref in first assignment
+  std::map<BBId, FreshObjects> freshObjectsAtEntry{};
+  // fresh objects at the statement being lowered
+  FreshObjects freshObjects{};
   bool enabledDebug;
 };
 
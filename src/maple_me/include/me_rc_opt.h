@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_RC_OPT_H
+#define MAPLE_ME_INCLUDE_ME_RC_OPT_H
+#include "dominance.h"
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+
+namespace maple {
+// Removes RC intrinsics inserted by rclowering that have no effect: inc/dec of null, and an IncRef whose object is
+// decremented again by a DecRef on the same SSA value that always executes exactly once after it, with nothing in
+// between that can release an object or throw.
+// Non-escaping allocations get no special treatment, see me_escape_analysis.h for why their RC operations stay.
+class RCOpt {
+ public:
+  RCOpt(MeFunction &f, Dominance &dom, bool enabledDebug) : func(f), dom(dom), enabledDebug(enabledDebug) {}
+
+  virtual ~RCOpt() = default;
+
+  void RemoveNullRCOps();
+  void PairIncDec();
+  void Finish() const;
+
+ private:
+  bool IsRCIntrinsic(const MeStmt &stmt, MIRIntrinsicID intrnID) const;
+  bool IsNonThrowingExpr(const MeExpr &expr) const;
+  bool IsRCNeutral(const MeStmt &stmt) const;
+  bool IsNeutralBB(const BB &bb) const;
+  bool IsPairingRegion(BB &incBB, BB &decBB) const;
+  MeStmt *FindMatchingDec(MeStmt &incStmt) const;
+  MeStmt *FindDecInBB(const MeStmt *stmt, const MeExpr &value, bool &reachedEnd) const;
+  void RemoveRCStmt(MeStmt &stmt);
+  MeFunction &func;
+  Dominance &dom;
+  uint32 numNullRCOps = 0;
+  uint32 numPairedOps = 0;
+  bool enabledDebug;
+};
+
+class MeDoRCOpt : public MeFuncPhase {
+ public:
+  explicit MeDoRCOpt(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoRCOpt() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "rcopt";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_RC_OPT_H
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_SCCP_H
+#define MAPLE_ME_INCLUDE_ME_SCCP_H
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+
+namespace maple {
+// Sparse conditional constant propagation (Wegman and Zadeck) over the integer SSA values of the function. Values
+// start undefined and only go down the lattice, a phi only meets the operands of its executable incoming edges and a
+// block is visited once one of its incoming edges is executable, so constants flow through phis of branches that are
+// never taken. Constant uses are then rewritten and never-taken conditional branch edges removed.
+class SCCP {
+ public:
+  SCCP(MeFunction &f, MeIRMap &irMap, bool enabledDebug)
+      : func(f), irMap(irMap), ssaTab(*f.GetMeSSATab()), enabledDebug(enabledDebug) {}
+
+  virtual ~SCCP() = default;
+
+  void Run();
+
+  bool IsCFGChanged() const {
+    return numPrunedEdges != 0;
+  }
+
+ private:
+  enum LatticeKind {
+    kLatticeTop,    // no definition reached yet
+    kLatticeConst,
+    kLatticeBottom  // not a constant
+  };
+
+  struct LatticeValue {
+    LatticeKind kind;
+    int64 value;
+  };
+
+  static LatticeValue Meet(LatticeValue value0, LatticeValue value1);
+  bool IsTrackedValue(MeExpr &expr) const;
+  LatticeValue GetValue(const MeExpr &expr) const;
+  void LowerValue(const MeExpr &value, LatticeValue newValue);
+  bool FoldUnary(Opcode op, PrimType primType, const OpMeExpr &expr, int64 opnd, int64 &result) const;
+  bool FoldBinary(Opcode op, PrimType primType, PrimType opndType, int64 opnd0, int64 opnd1, int64 &result) const;
+  LatticeValue Evaluate(MeExpr &expr) const;
+  template <typename PhiNode>
+  void VisitPhi(BB &bb, PhiNode &phi);
+  void CollectUses(MeExpr &expr, MeStmt &stmt);
+  void BuildUses();
+  void MarkEdge(BB &pred, BB &succ);
+  void VisitPhis(BB &bb);
+  void VisitStmt(MeStmt &stmt);
+  bool GetDecidedSucc(BB &bb, BB *&takenSucc, BB *&untakenSucc);
+  void VisitBranch(BB &bb);
+  void Propagate();
+  void FoldOpnd(MeStmt &stmt, MeExpr &expr);
+  void ReplaceConstants();
+  void PruneBranches();
+  MeFunction &func;
+  MeIRMap &irMap;
+  SSATab &ssaTab;
+  // lattice values of the SSA values that are not top
+  std::unordered_map<const MeExpr*, LatticeValue> values;
+  // statements and blocks with phis using each SSA value
+  std::unordered_map<const MeExpr*, std::vector<MeStmt*>> stmtUses;
+  std::unordered_map<const MeExpr*, std::vector<BB*>> phiUses;
+  std::vector<bool> bbExecutable;
+  std::set<std::pair<BBId, BBId>> edgeExecutable;
+  std::vector<std::pair<BB*, BB*>> edgeWorkList;
+  std::vector<MeStmt*> stmtWorkList;
+  std::vector<BB*> phiWorkList;
+  uint32 numFoldedExprs = 0;
+  uint32 numRemovedStmts = 0;
+  uint32 numPrunedEdges = 0;
+  bool enabledDebug;
+};
+
+class MeDoSCCP : public MeFuncPhase {
+ public:
+  explicit MeDoSCCP(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoSCCP() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "sccp";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_SCCP_H
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_SSA_PRE_H
+#define MAPLE_ME_INCLUDE_ME_SSA_PRE_H
+#include "dominance.h"
+#include "me_function.h"
+#include "me_irmap.h"
+#include "me_phase.h"
+
+namespace maple {
+// Partial redundancy elimination of first-order scalar expressions on the hash-consed IRMap: arithmetic whose
+// operands are variables, registers or constants, field loads (ivars with a variable base) and array lengths.
+// Occurrences of the same MeExpr dominated by an earlier one reuse its value from a new register. At a join block,
+// an expression whose value, translated through the phis of the join, is available from some predecessors is
+// computed on the other incoming edges and merged by a register phi, which removes the occurrence in the join.
+// Every round turns the expressions it replaces into registers, so the next round sees their parents as
+// first-order.
+class SSAPre {
+ public:
+  SSAPre(MeFunction &f, Dominance &dom, bool enabledDebug)
+      : func(f), irMap(*f.GetIRMap()), ssaTab(*f.GetMeSSATab()), dom(dom), enabledDebug(enabledDebug) {}
+
+  ~SSAPre() = default;
+
+  void Run();
+
+ private:
+  struct Occurrence {
+    MeStmt *stmt;
+    MeExpr *expr;
+    int32 leader;  // index of the dominating occurrence whose value is reused, -1 for a leader
+  };
+
+  // an expression occurring in a join block before any redefinition of its operands in the block
+  struct JoinCandidate {
+    BB *bb;
+    MeStmt *stmt;
+    MeExpr *expr;
+    int32 occIdx;                    // -1 until the occurrence is found to be a leader
+    std::vector<MeExpr*> predExprs;  // expr translated to the end of each predecessor
+    std::vector<int32> predLeaders;  // occurrence available at the end of each predecessor, or -1
+  };
+
+  bool IsLeafOpnd(const MeExpr &expr) const;
+  bool IsCandidate(MeExpr &expr) const;
+  void CollectCandidates(MeExpr &expr, std::vector<MeExpr*> &exprs) const;
+  void CollectCandidates(MeStmt &stmt, std::vector<MeExpr*> &exprs) const;
+  bool IsNonNull(MeExpr &expr) const;
+  bool MayThrow(MeExpr &expr) const;
+  MeExpr *TranslateOpnd(MeExpr &opnd, const BB &joinBB, size_t predIdx) const;
+  MeExpr *Translate(MeExpr &expr, const BB &joinBB, size_t predIdx);
+  bool IsUpwardExposed(MeExpr &expr, const BB &bb) const;
+  void CollectJoinCandidates();
+  void FindRedundancies(BB &bb);
+  void ResetRound();
+  bool PerformJoin(JoinCandidate &join);
+  bool RunRound();
+  MeFunction &func;
+  IRMap &irMap;
+  SSATab &ssaTab;
+  Dominance &dom;
+  std::vector<Occurrence> occurrences;
+  std::vector<JoinCandidate> joins;
+  std::map<std::pair<MeStmt*, MeExpr*>, size_t> joinOfOcc;
+  // join operands to look up at the end of each block
+  std::map<BBId, std::vector<std::pair<size_t, size_t>>> predEnds;
+  // leader available for each expression along the current dominator tree path
+  std::unordered_map<MeExpr*, int32> availLeaders;
+  std::vector<MeExpr*> availStack;
+  std::vector<bool> leaderUsed;
+  std::vector<RegMeExpr*> leaderRegs;
+  uint32 numReused = 0;
+  uint32 numInserted = 0;
+  bool enabledDebug;
+};
+
+class MeDoSSAPre : public MeFuncPhase {
+ public:
+  explicit MeDoSSAPre(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoSSAPre() = default;
+
+  AnalysisResult *Run(MeFunction*, MeFuncResultMgr*, ModuleResultMgr*) override;
+
+  std::string PhaseName() const override {
+    return "ssapre";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_SSA_PRE_H
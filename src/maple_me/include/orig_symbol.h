@@ -90,6 +90,12 @@ class OriginalSt {
     return symOrPreg.mirSt;
   }
 
+  // binds the ost to another symbol, used by coalescing right before emit
+  void SetMIRSymbol(MIRSymbol &mirSt) {
+    ASSERT(ostType == kSymbolOst, "OriginalSt must be SymbolOst");
+    symOrPreg.mirSt = &mirSt;
+  }
+
   bool HasAttr(AttrKind attrKind) const {
     if (ostType == kSymbolOst) {
       TypeAttrs typeAttr = symOrPreg.mirSt->GetAttrs();
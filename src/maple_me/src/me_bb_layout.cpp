@@ -314,13 +314,7 @@ void BBLayout::AddBB(BB &bb) {
   if (enabledDebug) {
     LogInfo::MapleLogger() << "bb id " << bb.GetBBId() << " kind is " << bb.StrAttribute();
   }
-  bool isTry = false;
-  if (func.GetIRMap() != nullptr) {
-    isTry = !bb.GetMeStmts().empty() && bb.GetMeStmts().front().GetOp() == OP_try;
-  } else {
-    isTry = !bb.GetStmtNodes().empty() && bb.GetStmtNodes().front().GetOpCode() == OP_try;
-  }
-  if (isTry) {
+  if (BBStartsWithTry(bb)) {
     ASSERT(!tryOutstanding, "BBLayout::AddBB: cannot lay out another try without ending the last one");
     tryOutstanding = true;
     if (enabledDebug) {
@@ -399,6 +393,117 @@ void BBLayout::ResolveUnconditionalFallThru(BB &bb, BB &nextBB) {
   }
 }
 
+bool BBLayout::BBStartsWithTry(const BB &bb) const {
+  if (func.GetIRMap() != nullptr) {
+    return !bb.GetMeStmts().empty() && bb.GetMeStmts().front().GetOp() == OP_try;
+  }
+  return !bb.GetStmtNodes().empty() && bb.GetStmtNodes().front().GetOpCode() == OP_try;
+}
+
+bool BBLayout::BBEndsWithThrow(const BB &bb) const {
+  if (func.GetIRMap() != nullptr) {
+    return !bb.GetMeStmts().empty() && bb.GetMeStmts().back().GetOp() == OP_throw;
+  }
+  return !bb.GetStmtNodes().empty() && bb.GetStmtNodes().back().GetOpCode() == OP_throw;
+}
+
+// Only meaningful when BB frequencies have been annotated from a profile, they are all 0 otherwise.
+bool BBLayout::IsHotterThan(const BB &bb1, const BB &bb2) const {
+  return bb1.GetFrequency() > bb2.GetFrequency();
+}
+
+// With a profile, a BB is cold if it never ran. Without one, catch handlers and throwing BBs are cold, and so is
+// any BB that can only be reached from cold BBs or can only lead to cold BBs.
+void BBLayout::MarkColdBBs(std::vector<bool> &isCold) const {
+  isCold.assign(func.GetAllBBs().size(), false);
+  bool hasProfile = func.GetFirstBB()->GetFrequency() > 0;
+  for (BB *bb : layoutBBs) {
+    isCold[bb->GetBBId()] = hasProfile ? (bb->GetFrequency() == 0)
+                                       : (bb->GetAttributes(kBBAttrIsCatch) || BBEndsWithThrow(*bb));
+  }
+  if (hasProfile) {
+    return;
+  }
+  auto allCold = [&isCold](const MapleVector<BB*> &bbs) {
+    return !bbs.empty() && std::all_of(bbs.begin(), bbs.end(), [&isCold](const BB *bb) {
+      return isCold[bb->GetBBId()];
+    });
+  };
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (BB *bb : layoutBBs) {
+      if (!isCold[bb->GetBBId()] && (allCold(bb->GetSucc()) || allCold(bb->GetPred()))) {
+        isCold[bb->GetBBId()] = true;
+        changed = true;
+      }
+    }
+  }
+}
+
+// return the BB that must be laid out right after bb, nullptr if bb does not fall through
+BB *BBLayout::GetLayoutFallthru(const BB &bb) const {
+  if ((bb.GetKind() != kBBFallthru && bb.GetKind() != kBBCondGoto) || bb.GetSucc().empty()) {
+    return nullptr;
+  }
+  BB *fallthru = bb.GetSucc().front();
+  return fallthru == func.GetCommonExitBB() ? nullptr : fallthru;
+}
+
+// Move the cold BBs outside of try regions to the end of the function, keeping their relative order. A moved BB
+// that falls through gets a goto, as does a BB that used to fall through into a moved one; if that would need a
+// new BB (a condgoto) or touch a try region, the layout is kept as is.
+void BBLayout::SinkColdBBs() {
+  std::vector<bool> isCold;
+  MarkColdBBs(isCold);
+  if (layoutBBs.empty() || isCold[layoutBBs.front()->GetBBId()]) {
+    // the whole function is cold
+    return;
+  }
+  std::vector<BB*> newLayout;
+  std::vector<BB*> coldBBs;
+  bool inTry = false;
+  for (BB *bb : layoutBBs) {
+    if (BBStartsWithTry(*bb)) {
+      inTry = true;
+    }
+    bool canMove = isCold[bb->GetBBId()] && !inTry && !bb->GetAttributes(kBBAttrIsTry);
+    (canMove ? coldBBs : newLayout).push_back(bb);
+    if (bb->GetAttributes(kBBAttrIsTryEnd)) {
+      inTry = false;
+    }
+  }
+  if (coldBBs.empty()) {
+    return;
+  }
+  newLayout.insert(newLayout.end(), coldBBs.begin(), coldBBs.end());
+  std::map<BB*, BB*> oldNext;
+  for (size_t i = 0; i + 1 < layoutBBs.size(); ++i) {
+    oldNext[layoutBBs[i]] = layoutBBs[i + 1];
+  }
+  std::vector<BB*> needGoto;
+  for (size_t i = 0; i < newLayout.size(); ++i) {
+    BB *bb = newLayout[i];
+    BB *next = (i + 1 < newLayout.size()) ? newLayout[i + 1] : nullptr;
+    BB *fallthru = GetLayoutFallthru(*bb);
+    if (fallthru == nullptr || fallthru == next || oldNext[bb] == next) {
+      continue;
+    }
+    if (bb->GetKind() == kBBCondGoto || bb->GetAttributes(kBBAttrIsTry) || bb->GetAttributes(kBBAttrIsTryEnd)) {
+      return;
+    }
+    needGoto.push_back(bb);
+  }
+  for (BB *bb : needGoto) {
+    CreateGoto(*bb, func, *GetLayoutFallthru(*bb));
+  }
+  layoutBBs.assign(newLayout.begin(), newLayout.end());
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "bblayout: moved " << coldBBs.size() << " cold BBs to the end of " << func.GetName() <<
+        ", " << needGoto.size() << " gotos added\n";
+  }
+}
+
 AnalysisResult *MeDoBBLayout::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) {
   // mempool used in analysisresult
   MemPool *layoutMp = NewMemPool();
@@ -414,14 +519,8 @@ AnalysisResult *MeDoBBLayout::Run(MeFunction *func, MeFuncResultMgr *funcResMgr,
     BB *nextBB = bbLayout->NextBB();
     if (nextBB != nullptr) {
       // check try-endtry correspondence
-      bool isTry = false;
-      if (func->GetIRMap() != nullptr) {
-        isTry = !nextBB->GetMeStmts().empty() && nextBB->GetMeStmts().front().GetOp() == OP_try;
-      } else {
-        auto &stmtNodes = nextBB->GetStmtNodes();
-        isTry = !stmtNodes.empty() && stmtNodes.front().GetOpCode() == OP_try;
-      }
-      ASSERT(!(isTry && bbLayout->GetTryOutstanding()), "cannot emit another try if last try has not been ended");
+      ASSERT(!(bbLayout->BBStartsWithTry(*nextBB) && bbLayout->GetTryOutstanding()),
+             "cannot emit another try if last try has not been ended");
       if (nextBB->GetAttributes(kBBAttrIsTryEnd)) {
         ASSERT(func->GetTryBBFromEndTryBB(nextBB) == nextBB ||
                bbLayout->IsBBLaidOut(func->GetTryBBFromEndTryBB(nextBB)->GetBBId()),
@@ -434,7 +533,9 @@ AnalysisResult *MeDoBBLayout::Run(MeFunction *func, MeFuncResultMgr *funcResMgr,
     } else if (bb->GetKind() == kBBCondGoto) {
       BB *fallthru = bbLayout->GetFallThruBBSkippingEmpty(*bb);
       BB *brTargetBB = bb->GetSucc(1);
-      if (brTargetBB != fallthru && fallthru->GetPred().size() > 1 && bbLayout->BBCanBeMoved(*brTargetBB, *bb)) {
+      if (brTargetBB != fallthru &&
+          (fallthru->GetPred().size() > 1 || bbLayout->IsHotterThan(*brTargetBB, *fallthru)) &&
+          bbLayout->BBCanBeMoved(*brTargetBB, *bb)) {
         // flip the sense of the condgoto and lay out brTargetBB right here
         LabelIdx fallthruLabel = func->GetOrCreateBBLabel(*fallthru);
         if (func->GetIRMap() != nullptr) {
@@ -517,6 +618,9 @@ AnalysisResult *MeDoBBLayout::Run(MeFunction *func, MeFuncResultMgr *funcResMgr,
     }
     bb = nextBB;
   }
+  if (MeOption::coldBBLayout) {
+    bbLayout->SinkColdBBs();
+  }
   if (bbLayout->IsNewBBInLayout()) {
     funcResMgr->InvalidAnalysisResult(MeFuncPhase_DOMINANCE, func);
   }
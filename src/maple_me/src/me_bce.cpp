@@ -0,0 +1,539 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_bce.h"
+
+// BCE works on the checks expanded in front of each array access:
+//     assertnonnull a
+//     intrinsiccall MPL_BOUNDARY_CHECK (ge u1 u32 (i, intrinsicop JAVA_ARRAY_LENGTH (a)))
+// The check throws when i is not below the length as unsigned values, i.e. unless 0 <= i < length. Facts are kept
+// along dominator tree paths like in castopt: an SSA value never changes, so a comparison dominating a check still
+// holds when the check is reached. Induction variables are handled by assuming, optimistically over phi cycles,
+// that every step keeps the value in range; a step is only trusted when a dominating comparison proves it cannot
+// wrap around.
+namespace maple {
+// copies left between an array access and the value it was computed from
+static constexpr uint32 kMaxCopyDepth = 8;
+
+static bool GetIntConst(MeExpr &expr, int64 &value) {
+  if (expr.GetMeOp() != kMeOpConst) {
+    return false;
+  }
+  MIRConst *constVal = static_cast<ConstMeExpr&>(expr).GetConstVal();
+  if (constVal->GetKind() != kConstInt) {
+    return false;
+  }
+  value = static_cast<MIRIntConst*>(constVal)->GetValue();
+  return true;
+}
+
+static BB *GetDefBB(MeExpr &expr) {
+  if (expr.GetMeOp() == kMeOpVar) {
+    return static_cast<VarMeExpr&>(expr).DefByBB();
+  }
+  if (expr.GetMeOp() == kMeOpReg) {
+    return static_cast<RegMeExpr&>(expr).DefByBB();
+  }
+  return nullptr;
+}
+
+static bool GetPhiOpnds(MeExpr &expr, std::vector<MeExpr*> &opnds, BB *&phiBB) {
+  if (expr.GetMeOp() == kMeOpVar && static_cast<VarMeExpr&>(expr).GetDefBy() == kDefByPhi) {
+    MeVarPhiNode &phi = static_cast<VarMeExpr&>(expr).GetDefPhi();
+    opnds.insert(opnds.end(), phi.GetOpnds().begin(), phi.GetOpnds().end());
+    phiBB = phi.GetDefBB();
+    return true;
+  }
+  if (expr.GetMeOp() == kMeOpReg && static_cast<RegMeExpr&>(expr).GetDefBy() == kDefByPhi) {
+    MeRegPhiNode &phi = static_cast<RegMeExpr&>(expr).GetDefPhi();
+    opnds.insert(opnds.end(), phi.GetOpnds().begin(), phi.GetOpnds().end());
+    phiBB = phi.GetDefBB();
+    return true;
+  }
+  return false;
+}
+
+bool BCE::IsBoundaryCheck(const MeStmt &stmt) const {
+  return stmt.GetOp() == OP_intrinsiccall &&
+         static_cast<const IntrinsiccallMeStmt&>(stmt).GetIntrinsic() == INTRN_MPL_BOUNDARY_CHECK;
+}
+
+MeExpr *BCE::GetDefRHS(MeExpr &expr) const {
+  MeStmt *defStmt = nullptr;
+  if (expr.GetMeOp() == kMeOpVar) {
+    auto &var = static_cast<VarMeExpr&>(expr);
+    defStmt = var.GetDefBy() == kDefByStmt ? var.GetDefStmt() : nullptr;
+  } else if (expr.GetMeOp() == kMeOpReg) {
+    auto &reg = static_cast<RegMeExpr&>(expr);
+    defStmt = reg.GetDefBy() == kDefByStmt ? reg.GetDefStmt() : nullptr;
+  }
+  if (defStmt == nullptr || (defStmt->GetOp() != OP_dassign && defStmt->GetOp() != OP_regassign)) {
+    return nullptr;
+  }
+  return defStmt->GetRHS();
+}
+
+MeExpr *BCE::GetCopyRoot(MeExpr &expr) const {
+  MeExpr *root = &expr;
+  for (uint32 depth = 0; depth < kMaxCopyDepth; ++depth) {
+    MeExpr *rhs = GetDefRHS(*root);
+    if (rhs == nullptr || (rhs->GetMeOp() != kMeOpVar && rhs->GetMeOp() != kMeOpReg) || rhs->IsVolatile(ssaTab)) {
+      break;
+    }
+    root = rhs;
+  }
+  return root;
+}
+
+// x + c, c + x or x - c on 32 bit integers
+bool BCE::GetStep(MeExpr &rhs, MeExpr *&base, int64 &step) const {
+  if (rhs.GetMeOp() != kMeOpOp || rhs.GetPrimType() != PTY_i32) {
+    return false;
+  }
+  if (rhs.GetOp() == OP_add) {
+    if (GetIntConst(*rhs.GetOpnd(1), step)) {
+      base = rhs.GetOpnd(0);
+      return true;
+    }
+    if (GetIntConst(*rhs.GetOpnd(0), step)) {
+      base = rhs.GetOpnd(1);
+      return true;
+    }
+  } else if (rhs.GetOp() == OP_sub && GetIntConst(*rhs.GetOpnd(1), step)) {
+    step = -step;
+    base = rhs.GetOpnd(0);
+    return true;
+  }
+  return false;
+}
+
+// the array whose length len is, if any
+MeExpr *BCE::GetLengthArray(MeExpr &len) const {
+  MeExpr *root = GetCopyRoot(len);
+  if (root->GetOp() != OP_intrinsicop || static_cast<NaryMeExpr*>(root)->GetIntrinsic() != INTRN_JAVA_ARRAY_LENGTH) {
+    return nullptr;
+  }
+  return GetCopyRoot(*root->GetOpnd(0));
+}
+
+// the size the array was allocated with, constSize is -1 unless it is a constant
+bool BCE::GetAllocSize(MeExpr &array, MeExpr *&size, int64 &constSize) const {
+  MeExpr *rhs = GetDefRHS(*GetCopyRoot(array));
+  if (rhs == nullptr || rhs->GetOp() != OP_gcmallocjarray) {
+    return false;
+  }
+  size = GetCopyRoot(*rhs->GetOpnd(0));
+  if (!GetIntConst(*size, constSize)) {
+    constSize = -1;
+  }
+  return true;
+}
+
+bool BCE::IsAtMostLength(MeExpr &bound, MeExpr &array) const {
+  MeExpr *root = GetCopyRoot(bound);
+  if (GetLengthArray(*root) == GetCopyRoot(array)) {
+    return true;
+  }
+  MeExpr *size = nullptr;
+  int64 constSize = -1;
+  if (!GetAllocSize(array, size, constSize)) {
+    return false;
+  }
+  int64 value = 0;
+  return size == root || (GetIntConst(*root, value) && value <= constSize);
+}
+
+// rhs == nullptr matches any right hand side
+bool BCE::HasFact(FactKind kind, const MeExpr *lhs, const MeExpr *rhs) const {
+  for (const Fact &fact : facts) {
+    if (fact.kind == kind && fact.lhs == lhs && (rhs == nullptr || fact.rhs == rhs)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// true if value is above some bound, so that value - 1 cannot wrap around
+bool BCE::HasLowerBound(const MeExpr &value) const {
+  int64 bound = 0;
+  for (const Fact &fact : facts) {
+    if ((fact.kind == kFactLT && fact.rhs == &value) || (fact.kind == kFactULT && fact.lhs == &value) ||
+        (fact.kind == kFactGE && fact.lhs == &value && GetIntConst(*fact.rhs, bound) && bound > INT32_MIN)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Facts of the current position cannot be used here: through a phi the value of an earlier iteration is reached.
+bool BCE::IsNonNegativeValue(MeExpr &expr, std::set<const MeExpr*> &visited) const {
+  int64 value = 0;
+  switch (expr.GetMeOp()) {
+    case kMeOpConst:
+      return GetIntConst(expr, value) && value >= 0;
+    case kMeOpNary:
+      return expr.GetOp() == OP_intrinsicop &&
+             static_cast<NaryMeExpr&>(expr).GetIntrinsic() == INTRN_JAVA_ARRAY_LENGTH;
+    case kMeOpOp:
+      if (expr.GetOp() == OP_band) {
+        return (GetIntConst(*expr.GetOpnd(0), value) && value >= 0) ||
+               (GetIntConst(*expr.GetOpnd(1), value) && value >= 0);
+      }
+      return expr.GetOp() == OP_lshr && GetIntConst(*expr.GetOpnd(1), value) && value > 0;
+    case kMeOpVar:
+    case kMeOpReg: {
+      if (expr.IsVolatile(ssaTab)) {
+        return false;
+      }
+      // optimistic on cycles, which all go through a phi
+      if (!visited.insert(&expr).second) {
+        return true;
+      }
+      std::vector<MeExpr*> opnds;
+      BB *phiBB = nullptr;
+      if (GetPhiOpnds(expr, opnds, phiBB)) {
+        for (MeExpr *opnd : opnds) {
+          if (!IsNonNegativeValue(*opnd, visited)) {
+            return false;
+          }
+        }
+        return true;
+      }
+      MeExpr *rhs = GetDefRHS(expr);
+      if (rhs == nullptr) {
+        return false;
+      }
+      MeExpr *base = nullptr;
+      int64 step = 0;
+      if (safeIncs.find(&expr) != safeIncs.end() && GetStep(*rhs, base, step) && step == 1) {
+        return IsNonNegativeValue(*base, visited);
+      }
+      return IsNonNegativeValue(*rhs, visited);
+    }
+    default:
+      return false;
+  }
+}
+
+bool BCE::IsNonNegative(MeExpr &index) const {
+  MeExpr *root = GetCopyRoot(index);
+  int64 bound = 0;
+  for (const Fact &fact : facts) {
+    if (fact.kind == kFactGE && fact.lhs == root && GetIntConst(*fact.rhs, bound) && bound >= 0) {
+      return true;
+    }
+    if (fact.kind == kFactLT && fact.rhs == root && GetIntConst(*fact.lhs, bound) && bound >= -1) {
+      return true;
+    }
+    std::set<const MeExpr*> visited;
+    if (fact.kind == kFactULT && fact.lhs == root && IsNonNegativeValue(*fact.rhs, visited)) {
+      return true;
+    }
+  }
+  std::set<const MeExpr*> visited;
+  return IsNonNegativeValue(*root, visited);
+}
+
+bool BCE::IsBelowLengthValue(MeExpr &expr, MeExpr &array, std::set<const MeExpr*> &visited) const {
+  MeExpr *base = nullptr;
+  int64 step = 0;
+  switch (expr.GetMeOp()) {
+    case kMeOpConst: {
+      MeExpr *size = nullptr;
+      int64 constSize = -1;
+      return GetAllocSize(array, size, constSize) && GetIntConst(expr, step) && step < constSize;
+    }
+    case kMeOpOp: {
+      // length - 1
+      std::set<const MeExpr*> baseVisited;
+      return GetStep(expr, base, step) && step == -1 && IsAtMostLength(*base, array) &&
+             IsNonNegativeValue(*base, baseVisited);
+    }
+    case kMeOpVar:
+    case kMeOpReg: {
+      if (expr.IsVolatile(ssaTab)) {
+        return false;
+      }
+      if (!visited.insert(&expr).second) {
+        return true;
+      }
+      std::vector<MeExpr*> opnds;
+      BB *phiBB = nullptr;
+      if (GetPhiOpnds(expr, opnds, phiBB)) {
+        // the array must be the same in all the iterations of the cycle
+        MeExpr *arrayRoot = GetCopyRoot(array);
+        if (arrayRoot->GetMeOp() != kMeOpVar && arrayRoot->GetMeOp() != kMeOpReg) {
+          return false;
+        }
+        BB *arrayDefBB = GetDefBB(*arrayRoot);
+        if (arrayDefBB != nullptr && (phiBB == nullptr || arrayDefBB == phiBB || !dom.Dominate(*arrayDefBB, *phiBB))) {
+          return false;
+        }
+        for (MeExpr *opnd : opnds) {
+          if (!IsBelowLengthValue(*opnd, array, visited)) {
+            return false;
+          }
+        }
+        return true;
+      }
+      MeExpr *rhs = GetDefRHS(expr);
+      if (rhs == nullptr) {
+        return false;
+      }
+      if (safeDecs.find(&expr) != safeDecs.end() && GetStep(*rhs, base, step) && step == -1) {
+        return IsBelowLengthValue(*base, array, visited);
+      }
+      return IsBelowLengthValue(*rhs, array, visited);
+    }
+    default:
+      return false;
+  }
+}
+
+bool BCE::IsBelowLength(MeExpr &index, MeExpr &array) const {
+  MeExpr *root = GetCopyRoot(index);
+  for (const Fact &fact : facts) {
+    if (fact.lhs != root || !IsAtMostLength(*fact.rhs, array)) {
+      continue;
+    }
+    std::set<const MeExpr*> visited;
+    if (fact.kind == kFactLT || (fact.kind == kFactULT && IsNonNegativeValue(*fact.rhs, visited))) {
+      return true;
+    }
+  }
+  std::set<const MeExpr*> visited;
+  return IsBelowLengthValue(*root, array, visited);
+}
+
+bool BCE::IsInBounds(MeExpr &index, MeExpr &array) const {
+  return IsNonNegative(index) && IsBelowLength(index, array);
+}
+
+void BCE::AddFact(FactKind kind, MeExpr &lhs, MeExpr &rhs) {
+  facts.push_back(Fact{kind, GetCopyRoot(lhs), GetCopyRoot(rhs)});
+}
+
+void BCE::AddBranchFacts(BB &bb) {
+  if (bb.GetPred().size() != 1) {
+    return;
+  }
+  BB *pred = bb.GetPred(0);
+  if (pred->GetKind() != kBBCondGoto || pred->GetMeStmts().empty() || pred->GetSucc().size() != 2 ||
+      pred->GetSucc(0) == pred->GetSucc(1)) {
+    return;
+  }
+  MeStmt *lastStmt = to_ptr(pred->GetMeStmts().rbegin());
+  if (!lastStmt->IsCondBr()) {
+    return;
+  }
+  MeExpr *cond = lastStmt->GetOpnd(0);
+  Opcode op = cond->GetOp();
+  if (cond->GetMeOp() != kMeOpOp || (op != OP_lt && op != OP_le && op != OP_gt && op != OP_ge)) {
+    return;
+  }
+  bool isTaken = (&bb == func.GetLabelBBAt(static_cast<CondGotoMeStmt*>(lastStmt)->GetOffset()));
+  bool holds = (isTaken == (lastStmt->GetOp() == OP_brtrue));
+  MeExpr &lhs = *cond->GetOpnd(0);
+  MeExpr &rhs = *cond->GetOpnd(1);
+  PrimType opndType = static_cast<OpMeExpr*>(cond)->GetOpndType();
+  if (opndType == PTY_i32) {
+    bool isLess = (op == OP_lt || op == OP_ge) ? holds == (op == OP_lt) : holds == (op == OP_gt);
+    bool swapped = (op == OP_le || op == OP_gt);
+    AddFact(isLess ? kFactLT : kFactGE, swapped ? rhs : lhs, swapped ? lhs : rhs);
+  } else if (opndType == PTY_u32) {
+    if ((op == OP_lt && holds) || (op == OP_ge && !holds)) {
+      AddFact(kFactULT, lhs, rhs);
+    } else if ((op == OP_gt && holds) || (op == OP_le && !holds)) {
+      AddFact(kFactULT, rhs, lhs);
+    }
+  }
+}
+
+void BCE::CollectStep(MeStmt &stmt) {
+  if (stmt.GetOp() != OP_dassign && stmt.GetOp() != OP_regassign) {
+    return;
+  }
+  MeExpr *lhs = stmt.GetLHS();
+  MeExpr *rhs = stmt.GetRHS();
+  MeExpr *base = nullptr;
+  int64 step = 0;
+  if (lhs == nullptr || rhs == nullptr || !GetStep(*rhs, base, step)) {
+    return;
+  }
+  MeExpr *root = GetCopyRoot(*base);
+  if (step == 1 && HasFact(kFactLT, root, nullptr)) {
+    (void)safeIncs.insert(lhs);
+  } else if (step == -1 && HasLowerBound(*root)) {
+    (void)safeDecs.insert(lhs);
+  }
+}
+
+void BCE::VisitStmts(BB &bb) {
+  MeStmt *nextStmt = nullptr;
+  for (MeStmt *stmt = to_ptr(bb.GetMeStmts().begin()); stmt != nullptr; stmt = nextStmt) {
+    nextStmt = stmt->GetNext();
+    if (!removing) {
+      CollectStep(*stmt);
+    }
+    if (!IsBoundaryCheck(*stmt) || stmt->NumMeStmtOpnds() != 1) {
+      continue;
+    }
+    MeExpr *cond = stmt->GetOpnd(0);
+    if (cond->GetOp() != OP_ge || static_cast<OpMeExpr*>(cond)->GetOpndType() != PTY_u32) {
+      continue;
+    }
+    MeExpr *index = cond->GetOpnd(0);
+    MeExpr *len = cond->GetOpnd(1);
+    MeExpr *array = GetLengthArray(*len);
+    if (array == nullptr) {
+      continue;
+    }
+    if (removing) {
+      ++numChecks;
+      if (IsInBounds(*index, *array)) {
+        if (enabledDebug) {
+          LogInfo::MapleLogger() << "bce: remove bounds check in BB " << bb.GetBBId() << '\n';
+        }
+        bb.RemoveMeStmt(stmt);
+        ++numRemovedChecks;
+        continue;
+      }
+    }
+    // from here on the index is known to be in bounds
+    AddFact(kFactULT, *index, *len);
+  }
+}
+
+void BCE::TraverseBB(BB &bb) {
+  // a handler may be entered before any fact of its try block holds
+  std::vector<Fact> outerFacts;
+  bool isCatch = bb.GetAttributes(kBBAttrIsCatch);
+  if (isCatch) {
+    outerFacts.swap(facts);
+  }
+  size_t factMark = facts.size();
+  AddBranchFacts(bb);
+  VisitStmts(bb);
+  const MapleSet<BBId> &domChildren = dom.GetDomChildren(bb.GetBBId());
+  for (const BBId &childID : domChildren) {
+    BB *child = func.GetBBFromID(childID);
+    if (child != nullptr) {
+      TraverseBB(*child);
+    }
+  }
+  (void)facts.erase(facts.begin() + static_cast<std::ptrdiff_t>(factMark), facts.end());
+  if (isCatch) {
+    outerFacts.swap(facts);
+  }
+}
+
+bool BCE::IsInvariant(const LoopDesc &loop, MeExpr &expr) const {
+  switch (expr.GetMeOp()) {
+    case kMeOpVar:
+    case kMeOpReg: {
+      BB *defBB = GetDefBB(expr);
+      return !expr.IsVolatile(ssaTab) && (defBB == nullptr || !loop.Has(*defBB));
+    }
+    case kMeOpConst:
+      return true;
+    case kMeOpNary:
+      return expr.GetOp() == OP_intrinsicop &&
+             static_cast<NaryMeExpr&>(expr).GetIntrinsic() == INTRN_JAVA_ARRAY_LENGTH &&
+             IsInvariant(loop, *expr.GetOpnd(0));
+    case kMeOpOp:
+      for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+        if (!IsInvariant(loop, *expr.GetOpnd(i))) {
+          return false;
+        }
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool BCE::IsHoistableCheck(const LoopDesc &loop, MeStmt &stmt) const {
+  if (stmt.GetOp() != OP_assertnonnull && !IsBoundaryCheck(stmt)) {
+    return false;
+  }
+  MapleMap<OStIdx, VarMeExpr*> *muList = stmt.GetMuList();
+  MapleMap<OStIdx, ChiMeNode*> *chiList = stmt.GetChiList();
+  if ((muList != nullptr && !muList->empty()) || (chiList != nullptr && !chiList->empty())) {
+    return false;
+  }
+  for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+    if (stmt.GetOpnd(i) == nullptr || !IsInvariant(loop, *stmt.GetOpnd(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Only the checks starting the head run as soon as the loop is entered; they move to the preheader in order, so
+// the first exception of the loop is unchanged.
+void BCE::HoistChecks(const LoopDesc &loop) {
+  if (loop.preheader == nullptr) {
+    return;
+  }
+  bool headInTry = loop.head->GetAttributes(kBBAttrIsTry);
+  bool preheaderInTry = loop.preheader->GetAttributes(kBBAttrIsTry);
+  if (headInTry != preheaderInTry || (headInTry && func.PrevBB(loop.head) != loop.preheader)) {
+    return;
+  }
+  MeStmt *nextStmt = nullptr;
+  for (MeStmt *stmt = to_ptr(loop.head->GetMeStmts().begin()); stmt != nullptr; stmt = nextStmt) {
+    nextStmt = stmt->GetNext();
+    if (!IsHoistableCheck(loop, *stmt)) {
+      break;
+    }
+    loop.head->RemoveMeStmt(stmt);
+    loop.preheader->InsertMeStmtLastBr(stmt);
+    ++numHoistedChecks;
+    if (enabledDebug) {
+      LogInfo::MapleLogger() << "bce: hoist check to BB " << loop.preheader->GetBBId() << '\n';
+    }
+  }
+}
+
+void BCE::Run() {
+  const MapleVector<LoopDesc*> &loops = identLoops.GetMeLoops();
+  for (auto it = loops.rbegin(); it != loops.rend(); ++it) {
+    HoistChecks(**it);
+  }
+  // steps are collected first, the increment of a loop is usually visited after the checks it guards
+  TraverseBB(*func.GetCommonEntryBB());
+  removing = true;
+  TraverseBB(*func.GetCommonEntryBB());
+  if (enabledDebug && numChecks != 0) {
+    LogInfo::MapleLogger() << "bce: " << func.GetName() << ": " << numRemovedChecks << " of " << numChecks
+                           << " bounds checks removed, " << numHoistedChecks << " checks hoisted\n";
+  }
+}
+
+AnalysisResult *MeDoBCE::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr*) {
+  auto *dom = static_cast<Dominance*>(funcResMgr->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_FATAL(dom != nullptr, "dominance phase has problem");
+  auto *identLoops = static_cast<IdentifyLoops*>(funcResMgr->GetAnalysisResult(MeFuncPhase_MELOOP, func));
+  CHECK_FATAL(identLoops != nullptr, "meloop phase has problem");
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  BCE bce(*func, *dom, *identLoops, DEBUGFUNC(func));
+  bce.Run();
+  return nullptr;
+}
+}  // namespace maple
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_cast_opt.h"
+#include "gen_check_cast.h"
+#include "name_mangler.h"
+
+// CastOpt works on the checkcasts lowered by gencheckcast:
+//     brfalse (ne v, 0) @join
+//       brfalse (ne &CLASSINFO_T, shadow(v)) @...
+//         [cache compare] call MCC_Reflect_Check_Casting_NoArray(&CLASSINFO_T, v)
+//                         or MCC_Reflect_ThrowCastException(&CLASSINFO_T, v, 0)
+//     @join
+// Once control reaches @join, v is either null or an instance of T. A later runtime call for a superclass or
+// implemented interface of T on the same SSA value can never throw and is removed. The inline compares around it
+// are left for later phases, only the runtime call is costly.
+namespace maple {
+// brfalse header -> shadow compare -> cache compare -> runtime call
+static constexpr uint32 kMaxCastRegionDepth = 3;
+
+bool CastOpt::IsTrackedValue(const MeExpr &expr) const {
+  if (expr.GetMeOp() == kMeOpReg) {
+    return true;
+  }
+  if (expr.GetMeOp() != kMeOpVar) {
+    return false;
+  }
+  const OriginalSt *ost = ssaTab.GetOriginalStFromID(static_cast<const VarMeExpr&>(expr).GetOStIdx());
+  return ost != nullptr && ost->IsLocal();
+}
+
+MeExpr *CastOpt::GetDefRHS(MeExpr &expr) const {
+  MeStmt *defStmt = nullptr;
+  if (expr.GetMeOp() == kMeOpVar) {
+    auto &var = static_cast<VarMeExpr&>(expr);
+    defStmt = var.GetDefBy() == kDefByStmt ? var.GetDefStmt() : nullptr;
+  } else if (expr.GetMeOp() == kMeOpReg) {
+    auto &reg = static_cast<RegMeExpr&>(expr);
+    defStmt = reg.GetDefBy() == kDefByStmt ? reg.GetDefStmt() : nullptr;
+  }
+  if (defStmt == nullptr || (defStmt->GetOp() != OP_dassign && defStmt->GetOp() != OP_regassign)) {
+    return nullptr;
+  }
+  return defStmt->GetRHS();
+}
+
+// Values connected by plain copies, e.g. the result of a lowered checkcast, share their facts.
+MeExpr *CastOpt::GetCopyRoot(MeExpr &expr) const {
+  MeExpr *root = &expr;
+  MeExpr *rhs = GetDefRHS(*root);
+  while (rhs != nullptr && IsTrackedValue(*rhs)) {
+    root = rhs;
+    rhs = GetDefRHS(*root);
+  }
+  return root;
+}
+
+Klass *CastOpt::GetClassInfoKlass(const MeExpr &expr) const {
+  if (expr.GetMeOp() != kMeOpAddrof) {
+    return nullptr;
+  }
+  const OriginalSt *ost = ssaTab.GetOriginalStFromID(static_cast<const AddrofMeExpr&>(expr).GetOstIdx());
+  if (ost == nullptr || !ost->IsSymbolOst()) {
+    return nullptr;
+  }
+  const std::string &name = ost->GetMIRSymbol()->GetName();
+  const std::string prefix = CLASSINFO_PREFIX_STR;
+  if (name.compare(0, prefix.size(), prefix) != 0) {
+    return nullptr;
+  }
+  return klassHierarchy.GetKlassFromName(name.substr(prefix.size()));
+}
+
+Klass *CastOpt::GetCheckKlass(TyIdx tyIdx) const {
+  MIRType *type = GlobalTables::GetTypeTable().GetTypeFromTyIdx(tyIdx);
+  if (type != nullptr && type->GetKind() == kTypePointer) {
+    tyIdx = static_cast<MIRPtrType*>(type)->GetPointedTyIdx();
+  }
+  return klassHierarchy.GetKlassFromTyIdx(tyIdx);
+}
+
+bool CastOpt::IsCastCheckCall(const MeStmt &stmt, bool &isThrow) const {
+  if (stmt.GetOp() != OP_call || stmt.NumMeStmtOpnds() < 2) {
+    return false;
+  }
+  const std::string &calleeName =
+      GlobalTables::GetFunctionTable().GetFunctionFromPuidx(static_cast<const CallMeStmt&>(stmt).GetPUIdx())->GetName();
+  isThrow = (calleeName == kMCCReflectThrowCastException);
+  return isThrow || calleeName == kMCCReflectCheckCastingNoArray;
+}
+
+// Find the null check heading the lowered cast made by call, and return the block where all its paths join.
+// gencheckcast builds the null check, the shadow compare, the cache compare and the call from one source
+// expression, so every compare up to the null check must test that expression (or its shadow) and the classinfo
+// of the call; any other branch means the call is not nested in its own cast region.
+BB *CastOpt::FindCastJoinBB(BB &bb, const MeStmt &call) const {
+  Klass *klass = GetClassInfoKlass(*call.GetOpnd(0));
+  const MeExpr *value = call.GetOpnd(1);
+  auto isShadow = [value](const MeExpr &expr) {
+    return expr.GetMeOp() == kMeOpIvar && static_cast<const IvarMeExpr&>(expr).GetBase() == value;
+  };
+  bool seenShadowCompare = false;
+  BB *header = dom.GetDom(bb.GetBBId());
+  for (uint32 depth = 0; depth < kMaxCastRegionDepth && header != nullptr; ++depth) {
+    if (header->GetKind() != kBBCondGoto || header->GetMeStmts().empty()) {
+      return nullptr;
+    }
+    MeStmt *lastStmt = to_ptr(header->GetMeStmts().rbegin());
+    MeExpr *cond = lastStmt->GetOp() == OP_brfalse ? lastStmt->GetOpnd(0) : nullptr;
+    if (cond == nullptr || cond->GetOp() != OP_ne) {
+      return nullptr;
+    }
+    if (cond->GetOpnd(0) == value && cond->GetOpnd(1)->IsZero()) {
+      if (!seenShadowCompare) {
+        return nullptr;
+      }
+      BB *joinBB = func.GetLabelBBAt(static_cast<CondGotoMeStmt*>(lastStmt)->GetOffset());
+      return (joinBB != nullptr && dom.Dominate(*header, *joinBB)) ? joinBB : nullptr;
+    }
+    if (!isShadow(*cond->GetOpnd(1))) {
+      return nullptr;
+    }
+    if (klass != nullptr && GetClassInfoKlass(*cond->GetOpnd(0)) == klass) {
+      seenShadowCompare = true;
+    } else if (seenShadowCompare) {
+      // the cache compare is nested inside the shadow compare
+      return nullptr;
+    }
+    header = dom.GetDom(header->GetBBId());
+  }
+  return nullptr;
+}
+
+void CastOpt::CollectJoinFacts() {
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB *bb = *bIt;
+    for (auto &stmt : bb->GetMeStmts()) {
+      bool isThrow = false;
+      if (!IsCastCheckCall(stmt, isThrow)) {
+        continue;
+      }
+      Klass *klass = GetClassInfoKlass(*stmt.GetOpnd(0));
+      MeExpr *value = stmt.GetOpnd(1);
+      if (klass == nullptr || !IsTrackedValue(*value)) {
+        continue;
+      }
+      BB *joinBB = FindCastJoinBB(*bb, stmt);
+      if (joinBB != nullptr) {
+        joinFacts[joinBB->GetBBId()].push_back(std::make_pair(GetCopyRoot(*value), klass));
+      }
+    }
+  }
+}
+
+// Match cond against instanceof(value), possibly compared with 0 or copied through a temp first.
+// polarity tells whether cond is nonzero exactly when the instanceof holds.
+bool CastOpt::GetInstanceOfFact(MeExpr &cond, bool &polarity, MeExpr *&value, Klass *&klass) const {
+  MeExpr *expr = &cond;
+  polarity = true;
+  while ((expr->GetOp() == OP_ne || expr->GetOp() == OP_eq) && expr->GetOpnd(1)->IsZero()) {
+    polarity = (polarity == (expr->GetOp() == OP_ne));
+    expr = expr->GetOpnd(0);
+  }
+  if (IsTrackedValue(*expr)) {
+    expr = GetDefRHS(*expr);
+  }
+  if (expr == nullptr || expr->GetMeOp() != kMeOpNary) {
+    return false;
+  }
+  auto *naryExpr = static_cast<NaryMeExpr*>(expr);
+  if (naryExpr->GetIntrinsic() != INTRN_JAVA_INSTANCE_OF || naryExpr->GetOpnds().empty()) {
+    return false;
+  }
+  value = naryExpr->GetOpnd(0);
+  klass = GetCheckKlass(naryExpr->GetTyIdx());
+  return klass != nullptr && IsTrackedValue(*value);
+}
+
+void CastOpt::AddBranchFact(BB &bb) {
+  if (bb.GetPred().size() != 1) {
+    return;
+  }
+  BB *pred = bb.GetPred(0);
+  if (pred->GetKind() != kBBCondGoto || pred->GetMeStmts().empty()) {
+    return;
+  }
+  MeStmt *lastStmt = to_ptr(pred->GetMeStmts().rbegin());
+  if (!lastStmt->IsCondBr()) {
+    return;
+  }
+  bool polarity = true;
+  MeExpr *value = nullptr;
+  Klass *klass = nullptr;
+  if (!GetInstanceOfFact(*lastStmt->GetOpnd(0), polarity, value, klass)) {
+    return;
+  }
+  bool isTaken = (&bb == func.GetLabelBBAt(static_cast<CondGotoMeStmt*>(lastStmt)->GetOffset()));
+  bool factOnTaken = ((lastStmt->GetOp() == OP_brtrue) == polarity);
+  if (isTaken == factOnTaken) {
+    AddFact(*GetCopyRoot(*value), *klass);
+  }
+}
+
+bool CastOpt::IsSubKlass(const Klass &sub, Klass &super) const {
+  if (&sub == &super) {
+    return true;
+  }
+  if (!super.IsInterface()) {
+    return klassHierarchy.IsSuperKlass(&super, &sub);
+  }
+  if (sub.IsInterface()) {
+    return klassHierarchy.IsSuperKlassForInterface(&super, const_cast<Klass*>(&sub));
+  }
+  for (const Klass *klass = &sub; klass != nullptr; klass = klass->GetSuperKlass()) {
+    if (klassHierarchy.IsInterfaceImplemented(&super, klass)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CastOpt::IsProven(MeExpr &value, Klass &klass) const {
+  auto it = provenKlasses.find(&value);
+  if (it == provenKlasses.end()) {
+    return false;
+  }
+  for (Klass *provenKlass : it->second) {
+    if (IsSubKlass(*provenKlass, klass)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void CastOpt::AddFact(MeExpr &value, Klass &klass) {
+  provenKlasses[&value].push_back(&klass);
+  factStack.push_back(&value);
+}
+
+void CastOpt::PopFacts(size_t mark) {
+  while (factStack.size() > mark) {
+    provenKlasses[factStack.back()].pop_back();
+    factStack.pop_back();
+  }
+}
+
+void CastOpt::OptimizeStmts(BB &bb) {
+  MeStmt *nextStmt = nullptr;
+  for (MeStmt *stmt = to_ptr(bb.GetMeStmts().begin()); stmt != nullptr; stmt = nextStmt) {
+    nextStmt = stmt->GetNext();
+    bool isThrow = false;
+    if (!IsCastCheckCall(*stmt, isThrow)) {
+      continue;
+    }
+    ++numChecks;
+    Klass *klass = GetClassInfoKlass(*stmt->GetOpnd(0));
+    MeExpr *value = stmt->GetOpnd(1);
+    if (klass == nullptr || !IsTrackedValue(*value) || !IsProven(*GetCopyRoot(*value), *klass)) {
+      continue;
+    }
+    if (enabledDebug) {
+      LogInfo::MapleLogger() << "castopt: remove proven " << (isThrow ? "cast exception" : "cast check") << " to "
+                             << klass->GetKlassName() << " in BB " << bb.GetBBId() << '\n';
+    }
+    bb.RemoveMeStmt(stmt);
+    ++numRemovedChecks;
+  }
+}
+
+void CastOpt::TraverseBB(BB &bb) {
+  size_t factMark = factStack.size();
+  auto it = joinFacts.find(bb.GetBBId());
+  if (it != joinFacts.end()) {
+    for (auto &fact : it->second) {
+      AddFact(*fact.first, *fact.second);
+    }
+  }
+  AddBranchFact(bb);
+  OptimizeStmts(bb);
+  const MapleSet<BBId> &domChildren = dom.GetDomChildren(bb.GetBBId());
+  for (const BBId &childID : domChildren) {
+    BB *child = func.GetBBFromID(childID);
+    if (child != nullptr) {
+      TraverseBB(*child);
+    }
+  }
+  PopFacts(factMark);
+}
+
+void CastOpt::Finish() const {
+  if (enabledDebug && numChecks != 0) {
+    LogInfo::MapleLogger() << "castopt: " << func.GetName() << ": " << numRemovedChecks << " of " << numChecks
+                           << " runtime cast checks removed\n";
+  }
+}
+
+AnalysisResult *MeDoCastOpt::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) {
+  auto *kh = static_cast<KlassHierarchy*>(moduleResMgr->GetAnalysisResult(MoPhase_CHA, &func->GetMIRModule()));
+  ASSERT(kh != nullptr, "KlassHierarchy has problem");
+  auto *dom = static_cast<Dominance*>(funcResMgr->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_FATAL(dom != nullptr, "dominance phase has problem");
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  CastOpt castOpt(*func, *dom, *kh, DEBUGFUNC(func));
+  castOpt.CollectJoinFacts();
+  castOpt.TraverseBB(*func->GetCommonEntryBB());
+  castOpt.Finish();
+  return nullptr;
+}
+}  // namespace maple
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_clinit_opt.h"
+
+// Initializing a class initializes its superclasses first, so once a check of a class has completed, later checks
+// of the class or any of its superclasses are no-ops. A check that completes normally dominates everything after it
+// in its block. Outside try blocks a failing check leaves the function, so it also covers its dominator subtree;
+// inside a try block the handler and code after it can be reached without the check completing.
+namespace maple {
+Klass *ClinitOpt::GetClinitCheckKlass(const StmtNode &stmt) const {
+  if (stmt.GetOpCode() != OP_intrinsiccallwithtype) {
+    return nullptr;
+  }
+  auto &intrinsicCall = static_cast<const IntrinsiccallNode&>(stmt);
+  if (intrinsicCall.GetIntrinsic() != INTRN_JAVA_CLINIT_CHECK) {
+    return nullptr;
+  }
+  MIRType *classType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(intrinsicCall.GetTyIdx());
+  if (classType == nullptr || classType->GetNameStrIdx() == 0) {
+    return nullptr;
+  }
+  return klassHierarchy.GetKlassFromStrIdx(classType->GetNameStrIdx());
+}
+
+bool ClinitOpt::IsInitialized(const Klass &klass) const {
+  for (Klass *initializedKlass : initializedKlasses) {
+    if (initializedKlass == &klass || (klass.IsClass() && klassHierarchy.IsSuperKlass(&klass, initializedKlass))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ClinitOpt::TraverseBB(BB &bb) {
+  size_t klassMark = initializedKlasses.size();
+  std::vector<StmtNode*> redundantChecks;
+  for (auto &stmt : bb.GetStmtNodes()) {
+    Klass *klass = GetClinitCheckKlass(stmt);
+    if (klass == nullptr) {
+      continue;
+    }
+    ++numChecks;
+    if (!klassHierarchy.NeedClinitCheckRecursively(*klass) || IsInitialized(*klass)) {
+      redundantChecks.push_back(&stmt);
+    } else {
+      initializedKlasses.push_back(klass);
+    }
+  }
+  for (StmtNode *stmt : redundantChecks) {
+    if (enabledDebug) {
+      LogInfo::MapleLogger() << "clinitopt: remove check of " << GetClinitCheckKlass(*stmt)->GetKlassName()
+                             << " in BB " << bb.GetBBId() << '\n';
+    }
+    bb.RemoveStmtNode(stmt);
+    ++numRemovedChecks;
+  }
+  if (bb.GetAttributes(kBBAttrIsTry)) {
+    initializedKlasses.resize(klassMark);
+  }
+  const MapleSet<BBId> &domChildren = dom.GetDomChildren(bb.GetBBId());
+  for (const BBId &childID : domChildren) {
+    BB *child = func.GetBBFromID(childID);
+    if (child != nullptr) {
+      TraverseBB(*child);
+    }
+  }
+  initializedKlasses.resize(klassMark);
+}
+
+void ClinitOpt::Finish() const {
+  if (enabledDebug && numChecks != 0) {
+    LogInfo::MapleLogger() << "clinitopt: " << func.GetName() << ": " << numRemovedChecks << " of " << numChecks
+                           << " clinit checks removed\n";
+  }
+}
+
+AnalysisResult *MeDoClinitOpt::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) {
+  auto *kh = static_cast<KlassHierarchy*>(moduleResMgr->GetAnalysisResult(MoPhase_CHA, &func->GetMIRModule()));
+  ASSERT(kh != nullptr, "KlassHierarchy has problem");
+  auto *dom = static_cast<Dominance*>(funcResMgr->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_FATAL(dom != nullptr, "dominance phase has problem");
+  ClinitOpt clinitOpt(*func, *dom, *kh, DEBUGFUNC(func));
+  clinitOpt.TraverseBB(*func->GetCommonEntryBB());
+  clinitOpt.Finish();
+  return nullptr;
+}
+}  // namespace maple
@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_coalesce.h"
+
+// Interference is computed on whole variables: a definition interferes with every candidate live after it, except
+// the source of a copy, which holds the same value. Blocks in a try region keep the live-ins of their handlers live
+// throughout, as an exception may leave at any statement, and the candidates live at function entry (formals and
+// uninitialized reads) interfere with each other.
+namespace maple {
+bool Coalescer::IsQualified(const MeExpr &expr) const {
+  if (expr.GetMeOp() == kMeOpReg) {
+    PrimType primType = expr.GetPrimType();
+    return static_cast<const RegMeExpr&>(expr).GetRegIdx() >= 0 && primType != PTY_ref && primType != PTY_agg;
+  }
+  const auto &var = static_cast<const VarMeExpr&>(expr);
+  const OriginalSt *ost = ssaTab.GetOriginalStFromID(var.GetOStIdx());
+  if (ost == nullptr || !ost->IsSymbolOst() || !ost->IsLocal() || ost->IsVolatile() || ost->IsAddressTaken() ||
+      ost->GetFieldID() != 0 || var.GetFieldID() != 0) {
+    return false;
+  }
+  const MIRSymbol *symbol = ost->GetMIRSymbol();
+  if (symbol->GetStorageClass() != kScAuto && symbol->GetStorageClass() != kScFormal) {
+    return false;
+  }
+  PrimType primType = symbol->GetType()->GetPrimType();
+  return primType != PTY_ref && primType != PTY_agg;
+}
+
+void Coalescer::VisitValue(MeExpr &expr) {
+  bool isReg = expr.GetMeOp() == kMeOpReg;
+  OStIdx ostIdx = isReg ? static_cast<RegMeExpr&>(expr).GetOstIdx() : static_cast<VarMeExpr&>(expr).GetOStIdx();
+  if (!IsQualified(expr)) {
+    (void)disqualifiedOsts.insert(ostIdx);
+    return;
+  }
+  auto candIt = candidateOfOst.find(ostIdx);
+  if (candIt == candidateOfOst.end()) {
+    Candidate cand;
+    cand.ostIdx = ostIdx;
+    cand.isReg = isReg;
+    cand.isFormal = !isReg && ssaTab.GetOriginalStFromID(ostIdx)->IsFormal();
+    cand.typeKey = isReg ? expr.GetPrimType() : ssaTab.GetMIRSymbolFromID(ostIdx)->GetTyIdx().GetIdx();
+    candIt = candidateOfOst.insert(std::make_pair(ostIdx, candidates.size())).first;
+    candidates.push_back(cand);
+  }
+  if (isReg) {
+    (void)candidates[candIt->second].regs.insert(static_cast<RegMeExpr*>(&expr));
+  }
+}
+
+void Coalescer::VisitExpr(MeExpr &expr) {
+  switch (expr.GetMeOp()) {
+    case kMeOpVar:
+    case kMeOpReg:
+      VisitValue(expr);
+      return;
+    case kMeOpAddrof:
+      (void)disqualifiedOsts.insert(static_cast<AddrofMeExpr&>(expr).GetOstIdx());
+      return;
+    case kMeOpIvar: {
+      VarMeExpr *mu = static_cast<IvarMeExpr&>(expr).GetMu();
+      if (mu != nullptr) {
+        (void)disqualifiedOsts.insert(mu->GetOStIdx());
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    VisitExpr(*expr.GetOpnd(i));
+  }
+}
+
+void Coalescer::VisitStmt(MeStmt &stmt) {
+  for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+    VisitExpr(*stmt.GetOpnd(i));
+  }
+  if (stmt.GetOp() == OP_dassign || stmt.GetOp() == OP_regassign) {
+    VisitValue(*stmt.GetLHS());
+  }
+  if (stmt.GetMustDefList() != nullptr) {
+    for (auto &mustDef : *stmt.GetMustDefList()) {
+      VisitValue(*mustDef.GetLHS());
+    }
+  }
+  if (stmt.GetChiList() != nullptr) {
+    for (auto &chiPair : *stmt.GetChiList()) {
+      (void)disqualifiedOsts.insert(chiPair.first);
+    }
+  }
+  if (stmt.GetMuList() != nullptr) {
+    for (auto &muPair : *stmt.GetMuList()) {
+      (void)disqualifiedOsts.insert(muPair.first);
+    }
+  }
+}
+
+void Coalescer::CollectCandidates() {
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB &bb = **bIt;
+    for (auto &phiPair : bb.GetMevarPhiList()) {
+      VisitValue(*phiPair.second->GetLHS());
+      for (VarMeExpr *opnd : phiPair.second->GetOpnds()) {
+        VisitValue(*opnd);
+      }
+    }
+    for (auto &phiPair : bb.GetMeregphiList()) {
+      VisitValue(*phiPair.second->GetLHS());
+      for (RegMeExpr *opnd : phiPair.second->GetOpnds()) {
+        VisitValue(*opnd);
+      }
+    }
+    for (auto &stmt : bb.GetMeStmts()) {
+      VisitStmt(stmt);
+    }
+  }
+  // keep the qualified candidates only
+  std::vector<Candidate> allCandidates;
+  allCandidates.swap(candidates);
+  candidateOfOst.clear();
+  for (Candidate &cand : allCandidates) {
+    if (disqualifiedOsts.find(cand.ostIdx) == disqualifiedOsts.end()) {
+      candidateOfOst[cand.ostIdx] = candidates.size();
+      candidates.push_back(cand);
+    }
+  }
+}
+
+int32 Coalescer::GetCandidate(const MeExpr &expr) const {
+  if (expr.GetMeOp() != kMeOpVar && expr.GetMeOp() != kMeOpReg) {
+    return -1;
+  }
+  OStIdx ostIdx = expr.GetMeOp() == kMeOpReg ? static_cast<const RegMeExpr&>(expr).GetOstIdx()
+                                             : static_cast<const VarMeExpr&>(expr).GetOStIdx();
+  auto candIt = candidateOfOst.find(ostIdx);
+  return candIt == candidateOfOst.end() ? -1 : static_cast<int32>(candIt->second);
+}
+
+// the candidate copied by stmt into another candidate, -1 if stmt is not such a copy
+int32 Coalescer::GetCopySource(const MeStmt &stmt) const {
+  if ((stmt.GetOp() != OP_dassign && stmt.GetOp() != OP_regassign) || GetCandidate(*stmt.GetLHS()) < 0) {
+    return -1;
+  }
+  return GetCandidate(*stmt.GetRHS());
+}
+
+void Coalescer::AddUses(MeExpr &expr, std::set<uint32> &live) const {
+  int32 cand = GetCandidate(expr);
+  if (cand >= 0) {
+    (void)live.insert(static_cast<uint32>(cand));
+    return;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    AddUses(*expr.GetOpnd(i), live);
+  }
+}
+
+void Coalescer::AddDefs(MeStmt &stmt, std::vector<uint32> &defs) const {
+  if (stmt.GetOp() == OP_dassign || stmt.GetOp() == OP_regassign) {
+    int32 cand = GetCandidate(*stmt.GetLHS());
+    if (cand >= 0) {
+      defs.push_back(static_cast<uint32>(cand));
+    }
+  }
+  if (stmt.GetMustDefList() != nullptr) {
+    for (auto &mustDef : *stmt.GetMustDefList()) {
+      int32 cand = GetCandidate(*mustDef.GetLHS());
+      if (cand >= 0) {
+        defs.push_back(static_cast<uint32>(cand));
+      }
+    }
+  }
+}
+
+void Coalescer::AddInterference(uint32 def, const std::set<uint32> &live, int32 copySrc) {
+  for (uint32 other : live) {
+    if (other != def && static_cast<int32>(other) != copySrc) {
+      (void)interference[def].insert(other);
+      (void)interference[other].insert(def);
+    }
+  }
+}
+
+std::set<uint32> Coalescer::GetLiveOut(BB &bb) const {
+  std::set<uint32> live;
+  for (BB *succ : bb.GetSucc()) {
+    live.insert(liveIns[succ->GetBBId()].begin(), liveIns[succ->GetBBId()].end());
+    for (size_t i = 0; i < succ->GetPred().size(); ++i) {
+      if (succ->GetPred(i) != &bb) {
+        continue;
+      }
+      for (auto &phiPair : succ->GetMevarPhiList()) {
+        AddUses(*phiPair.second->GetOpnd(i), live);
+      }
+      for (auto &phiPair : succ->GetMeregphiList()) {
+        AddUses(*phiPair.second->GetOpnd(i), live);
+      }
+    }
+  }
+  return live;
+}
+
+std::set<uint32> Coalescer::GetLiveIn(BB &bb, bool addInterference) {
+  std::set<uint32> live = GetLiveOut(bb);
+  std::set<uint32> handlerLive;
+  if (bb.GetAttributes(kBBAttrIsTry)) {
+    for (BB *succ : bb.GetSucc()) {
+      if (succ->GetAttributes(kBBAttrIsCatch)) {
+        handlerLive.insert(liveIns[succ->GetBBId()].begin(), liveIns[succ->GetBBId()].end());
+      }
+    }
+  }
+  for (MeStmt *stmt = to_ptr(bb.GetMeStmts().rbegin()); stmt != nullptr; stmt = stmt->GetPrev()) {
+    std::vector<uint32> defs;
+    AddDefs(*stmt, defs);
+    for (uint32 def : defs) {
+      if (addInterference) {
+        AddInterference(def, live, GetCopySource(*stmt));
+        AddInterference(def, handlerLive, GetCopySource(*stmt));
+      }
+      if (handlerLive.find(def) == handlerLive.end()) {
+        (void)live.erase(def);
+      }
+    }
+    for (size_t i = 0; i < stmt->NumMeStmtOpnds(); ++i) {
+      AddUses(*stmt->GetOpnd(i), live);
+    }
+  }
+  // phis define their variables together at block entry
+  std::vector<uint32> phiDefs;
+  for (auto &phiPair : bb.GetMevarPhiList()) {
+    int32 cand = GetCandidate(*phiPair.second->GetLHS());
+    if (cand >= 0) {
+      phiDefs.push_back(static_cast<uint32>(cand));
+    }
+  }
+  for (auto &phiPair : bb.GetMeregphiList()) {
+    int32 cand = GetCandidate(*phiPair.second->GetLHS());
+    if (cand >= 0) {
+      phiDefs.push_back(static_cast<uint32>(cand));
+    }
+  }
+  for (uint32 def : phiDefs) {
+    if (addInterference) {
+      AddInterference(def, live, -1);
+    }
+  }
+  for (uint32 def : phiDefs) {
+    (void)live.erase(def);
+  }
+  return live;
+}
+
+void Coalescer::ComputeLiveness() {
+  std::vector<BB*> bbs;
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    bbs.push_back(*bIt);
+  }
+  liveIns.resize(func.NumBBs());
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto bbIt = bbs.rbegin(); bbIt != bbs.rend(); ++bbIt) {
+      std::set<uint32> liveIn = GetLiveIn(**bbIt, false);
+      if (liveIn != liveIns[(*bbIt)->GetBBId()]) {
+        liveIns[(*bbIt)->GetBBId()] = liveIn;
+        changed = true;
+      }
+    }
+  }
+}
+
+void Coalescer::BuildInterference() {
+  interference.resize(candidates.size());
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB &bb = **bIt;
+    (void)GetLiveIn(bb, true);
+    if (bb.GetAttributes(kBBAttrIsEntry)) {
+      for (uint32 cand : liveIns[bb.GetBBId()]) {
+        AddInterference(cand, liveIns[bb.GetBBId()], -1);
+      }
+    }
+  }
+}
+
+uint32 Coalescer::FindRep(uint32 idx) {
+  while (reps[idx] != idx) {
+    reps[idx] = reps[reps[idx]];
+    idx = reps[idx];
+  }
+  return idx;
+}
+
+bool Coalescer::Interferes(uint32 rep1, uint32 rep2) {
+  for (uint32 other : interference[rep1]) {
+    if (FindRep(other) == rep2) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// A merged class is represented by its formal if it has one, so the parameter keeps its symbol; two formals are
+// never merged.
+void Coalescer::CoalesceCopies() {
+  reps.resize(candidates.size());
+  for (uint32 i = 0; i < reps.size(); ++i) {
+    reps[i] = i;
+  }
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    for (auto &stmt : (*bIt)->GetMeStmts()) {
+      int32 src = GetCopySource(stmt);
+      if (src < 0) {
+        continue;
+      }
+      uint32 srcRep = FindRep(static_cast<uint32>(src));
+      uint32 dstRep = FindRep(static_cast<uint32>(GetCandidate(*stmt.GetLHS())));
+      Candidate &srcCand = candidates[srcRep];
+      Candidate &dstCand = candidates[dstRep];
+      if (srcRep == dstRep || srcCand.isReg != dstCand.isReg || srcCand.typeKey != dstCand.typeKey ||
+          (srcCand.isFormal && dstCand.isFormal) || Interferes(srcRep, dstRep)) {
+        continue;
+      }
+      uint32 rep = dstCand.isFormal ? dstRep : srcRep;
+      uint32 merged = rep == srcRep ? dstRep : srcRep;
+      reps[merged] = rep;
+      interference[rep].insert(interference[merged].begin(), interference[merged].end());
+    }
+  }
+}
+
+void Coalescer::Rewrite() {
+  for (uint32 i = 0; i < candidates.size(); ++i) {
+    uint32 rep = FindRep(i);
+    if (rep == i) {
+      continue;
+    }
+    OriginalSt *repOst = ssaTab.GetOriginalStFromID(candidates[rep].ostIdx);
+    if (candidates[i].isReg) {
+      for (RegMeExpr *reg : candidates[i].regs) {
+        reg->SetRegIdx(static_cast<PregIdx16>(repOst->GetPregIdx()));
+      }
+    } else {
+      ssaTab.GetOriginalStFromID(candidates[i].ostIdx)->SetMIRSymbol(*repOst->GetMIRSymbol());
+    }
+    if (enabledDebug) {
+      LogInfo::MapleLogger() << "coalesce: ost " << candidates[i].ostIdx.idx << " into ost "
+                             << candidates[rep].ostIdx.idx << '\n';
+    }
+  }
+  // copies inside a class now assign a variable to itself
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB &bb = **bIt;
+    MeStmt *nextStmt = nullptr;
+    for (MeStmt *stmt = to_ptr(bb.GetMeStmts().begin()); stmt != nullptr; stmt = nextStmt) {
+      nextStmt = stmt->GetNext();
+      int32 src = GetCopySource(*stmt);
+      if (src >= 0 && FindRep(static_cast<uint32>(src)) ==
+                      FindRep(static_cast<uint32>(GetCandidate(*stmt->GetLHS())))) {
+        bb.RemoveMeStmt(stmt);
+        ++numRemovedCopies;
+      }
+    }
+  }
+}
+
+void Coalescer::Run() {
+  CollectCandidates();
+  if (candidates.empty()) {
+    return;
+  }
+  ComputeLiveness();
+  BuildInterference();
+  CoalesceCopies();
+  Rewrite();
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "coalesce: " << func.GetName() << ": " << numRemovedCopies << " copies removed\n";
+  }
+}
+
+AnalysisResult *MeDoCoalesce::Run(MeFunction *func, MeFuncResultMgr*, ModuleResultMgr*) {
+  if (func->GetIRMap() == nullptr || func->GetMeSSATab() == nullptr) {
+    return nullptr;
+  }
+  Coalescer coalescer(*func, DEBUGFUNC(func));
+  coalescer.Run();
+  return nullptr;
+}
+}  // namespace maple
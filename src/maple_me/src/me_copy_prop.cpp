@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_copy_prop.h"
+
+namespace maple {
+OStIdx CopyProp::GetOStIdx(const MeExpr &expr) const {
+  return expr.GetMeOp() == kMeOpVar ? static_cast<const VarMeExpr&>(expr).GetOStIdx()
+                                    : static_cast<const RegMeExpr&>(expr).GetOstIdx();
+}
+
+// a local variable or an ordinary preg, which only change through assignments seen in the function
+bool CopyProp::IsCopySource(const MeExpr &expr) const {
+  if (expr.GetMeOp() == kMeOpReg) {
+    return static_cast<const RegMeExpr&>(expr).GetRegIdx() >= 0;
+  }
+  if (expr.GetMeOp() != kMeOpVar) {
+    return false;
+  }
+  const OriginalSt *ost = ssaTab.GetOriginalStFromID(static_cast<const VarMeExpr&>(expr).GetOStIdx());
+  if (ost == nullptr || !ost->IsSymbolOst() || !ost->IsLocal() || ost->IsVolatile()) {
+    return false;
+  }
+  MIRStorageClass storageClass = ost->GetMIRSymbol()->GetStorageClass();
+  return storageClass == kScAuto || storageClass == kScFormal;
+}
+
+// the source of a copy between two values of the same type, nullptr if stmt is not such a copy
+MeExpr *CopyProp::GetCopyRHS(const MeStmt &stmt) const {
+  MeExpr *lhs = nullptr;
+  if (stmt.GetOp() == OP_dassign) {
+    lhs = stmt.GetVarLHS();
+    if (lhs->IsVolatile(ssaTab)) {
+      return nullptr;
+    }
+  } else if (stmt.GetOp() == OP_regassign) {
+    lhs = stmt.GetLHS();
+  } else {
+    return nullptr;
+  }
+  MeExpr *rhs = stmt.GetRHS();
+  if (!IsCopySource(*rhs) || rhs->GetPrimType() != lhs->GetPrimType()) {
+    return nullptr;
+  }
+  return rhs;
+}
+
+void CopyProp::CountDef(const MeExpr &lhs) {
+  if (lhs.GetMeOp() == kMeOpVar || lhs.GetMeOp() == kMeOpReg) {
+    ++numDefs[GetOStIdx(lhs)];
+  }
+}
+
+void CopyProp::CountDefs() {
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB &bb = **bIt;
+    for (auto &phiPair : bb.GetMevarPhiList()) {
+      CountDef(*phiPair.second->GetLHS());
+    }
+    for (auto &phiPair : bb.GetMeregphiList()) {
+      CountDef(*phiPair.second->GetLHS());
+    }
+    for (auto &stmt : bb.GetMeStmts()) {
+      if (stmt.GetOp() == OP_dassign || stmt.GetOp() == OP_regassign) {
+        CountDef(*stmt.GetLHS());
+      }
+      if (stmt.GetChiList() != nullptr) {
+        for (auto &chiPair : *stmt.GetChiList()) {
+          CountDef(*chiPair.second->GetLHS());
+        }
+      }
+      if (stmt.GetMustDefList() != nullptr) {
+        for (auto &mustDef : *stmt.GetMustDefList()) {
+          CountDef(*mustDef.GetLHS());
+        }
+      }
+    }
+  }
+}
+
+// true if value is the only version of its variable that can be read, so the variable holds it wherever the
+// value is available
+bool CopyProp::IsSingleDef(const MeExpr &value) const {
+  MeDefBy defBy = value.GetMeOp() == kMeOpVar ? static_cast<const VarMeExpr&>(value).GetDefBy()
+                                              : static_cast<const RegMeExpr&>(value).GetDefBy();
+  auto defIt = numDefs.find(GetOStIdx(value));
+  uint32 count = defIt == numDefs.end() ? 0 : defIt->second;
+  return count == (defBy == kDefByNo ? 0 : 1);
+}
+
+void CopyProp::CollectCopies() {
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    for (auto &stmt : (*bIt)->GetMeStmts()) {
+      MeExpr *rhs = GetCopyRHS(stmt);
+      if (rhs != nullptr && IsSingleDef(*rhs)) {
+        globalCopies[stmt.GetLHS()] = rhs;
+      }
+    }
+  }
+}
+
+void CopyProp::CollectLeaves(MeExpr &expr, std::vector<MeExpr*> &leaves) const {
+  if (expr.GetMeOp() == kMeOpVar || expr.GetMeOp() == kMeOpReg) {
+    leaves.push_back(&expr);
+    return;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    CollectLeaves(*expr.GetOpnd(i), leaves);
+  }
+}
+
+// the value a use of value can read instead, through chains of copies
+MeExpr *CopyProp::GetRoot(MeExpr &value) const {
+  MeExpr *root = &value;
+  while (true) {
+    auto localIt = localCopies.find(root);
+    if (localIt != localCopies.end()) {
+      root = localIt->second;
+      continue;
+    }
+    auto globalIt = globalCopies.find(root);
+    if (globalIt == globalCopies.end()) {
+      return root;
+    }
+    root = globalIt->second;
+  }
+}
+
+// a new version of the variable of lhs ends the copies from it in the current block
+void CopyProp::KillLocalCopies(const MeExpr &lhs) {
+  if (lhs.GetMeOp() != kMeOpVar && lhs.GetMeOp() != kMeOpReg) {
+    return;
+  }
+  OStIdx ostIdx = GetOStIdx(lhs);
+  for (auto copyIt = localCopies.begin(); copyIt != localCopies.end();) {
+    if (GetOStIdx(*copyIt->second) == ostIdx) {
+      copyIt = localCopies.erase(copyIt);
+    } else {
+      ++copyIt;
+    }
+  }
+}
+
+void CopyProp::PropagateInStmt(MeStmt &stmt) {
+  std::vector<MeExpr*> leaves;
+  for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+    CollectLeaves(*stmt.GetOpnd(i), leaves);
+  }
+  for (MeExpr *leaf : leaves) {
+    MeExpr *root = GetRoot(*leaf);
+    if (root != leaf && irMap.ReplaceMeExprStmt(stmt, *leaf, *root)) {
+      ++numReplacedUses;
+      if (enabledDebug) {
+        LogInfo::MapleLogger() << "copyprop: replace mx" << leaf->GetExprID() << " by mx" << root->GetExprID()
+                               << " in BB " << stmt.GetBB()->GetBBId() << '\n';
+      }
+    }
+  }
+  if (stmt.GetOp() == OP_dassign || stmt.GetOp() == OP_regassign) {
+    KillLocalCopies(*stmt.GetLHS());
+  }
+  if (stmt.GetChiList() != nullptr) {
+    for (auto &chiPair : *stmt.GetChiList()) {
+      KillLocalCopies(*chiPair.second->GetLHS());
+    }
+  }
+  if (stmt.GetMustDefList() != nullptr) {
+    for (auto &mustDef : *stmt.GetMustDefList()) {
+      KillLocalCopies(*mustDef.GetLHS());
+    }
+  }
+  MeExpr *rhs = GetCopyRHS(stmt);
+  if (rhs != nullptr && GetOStIdx(*rhs) != GetOStIdx(*stmt.GetLHS())) {
+    localCopies[stmt.GetLHS()] = rhs;
+  }
+}
+
+void CopyProp::Run() {
+  CountDefs();
+  CollectCopies();
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    localCopies.clear();
+    for (auto &stmt : (*bIt)->GetMeStmts()) {
+      PropagateInStmt(stmt);
+    }
+  }
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "copyprop: " << func.GetName() << ": " << numReplacedUses << " uses replaced\n";
+  }
+}
+
+AnalysisResult *MeDoCopyProp::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr*) {
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  CopyProp copyProp(*func, *func->GetIRMap(), DEBUGFUNC(func));
+  copyProp.Run();
+  return nullptr;
+}
+}  // namespace maple
@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_dce.h"
+#include "me_cfg.h"
+
+// Roots of the liveness are the statements other than assignments to local variables and registers, the
+// assignments whose right hand side may throw (a field load through a possibly null base is the null check of the
+// access), and the branches leaving a loop, so that a loop which may not terminate is never removed.
+// A live phi makes live the branches ending its predecessors, which select the operand it takes.
+//
+// A dead conditional branch has no live block control dependent on it, so both of its successors reach the
+// immediate post-dominator without doing anything live; it becomes a goto to the post-dominator and the blocks in
+// between are deleted as unreachable. The post-dominator must not have a live phi, which would need an operand for
+// the new edge. As in sccp the CFG is updated in place and the dominance and loop analyses are invalidated.
+namespace maple {
+bool AggressiveDCE::HasSideEffect(MeExpr &expr) const {
+  switch (expr.GetMeOp()) {
+    case kMeOpIvar:
+    case kMeOpGcmalloc:
+    case kMeOpNary:
+      return true;
+    case kMeOpVar:
+    case kMeOpReg:
+      return expr.IsVolatile(ssaTab);
+    default:
+      break;
+  }
+  Opcode op = expr.GetOp();
+  if (kOpcodeInfo.MayThrowException(op) || op == OP_gcmallocjarray || op == OP_gcpermallocjarray) {
+    return true;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    MeExpr *opnd = expr.GetOpnd(i);
+    if (opnd != nullptr && HasSideEffect(*opnd)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool AggressiveDCE::IsEssential(MeStmt &stmt) const {
+  switch (stmt.GetOp()) {
+    case OP_dassign: {
+      auto *lhs = static_cast<VarMeExpr*>(stmt.GetLHS());
+      const OriginalSt *ost = ssaTab.GetOriginalStFromID(lhs->GetOStIdx());
+      MapleMap<OStIdx, ChiMeNode*> *chiList = stmt.GetChiList();
+      if (!ost->IsLocal() || lhs->IsVolatile(ssaTab) || (chiList != nullptr && !chiList->empty())) {
+        return true;
+      }
+      return HasSideEffect(*stmt.GetRHS());
+    }
+    case OP_regassign: {
+      // special registers such as the return value
+      if (static_cast<RegMeExpr*>(stmt.GetLHS())->GetRegIdx() < 0) {
+        return true;
+      }
+      return HasSideEffect(*stmt.GetRHS());
+    }
+    case OP_brtrue:
+    case OP_brfalse:
+      return HasSideEffect(*stmt.GetOpnd(0));
+    case OP_goto:
+    case OP_comment:
+      return false;
+    default:
+      return true;
+  }
+}
+
+// marks the branches bb is control dependent on
+void AggressiveDCE::MarkBBLive(BB &bb) {
+  if (liveBBs[bb.GetBBId()]) {
+    return;
+  }
+  liveBBs[bb.GetBBId()] = true;
+  for (BBId bbID : dom.GetPdomFrontierItem(bb.GetBBId())) {
+    BB *branchBB = func.GetBBFromID(bbID);
+    if (branchBB != nullptr) {
+      MarkBranchLive(*branchBB);
+    }
+  }
+}
+
+void AggressiveDCE::MarkBranchLive(BB &bb) {
+  if (bb.GetMeStmts().empty()) {
+    return;
+  }
+  MeStmt *lastStmt = to_ptr(bb.GetMeStmts().rbegin());
+  if (lastStmt->IsCondBr() || lastStmt->GetOp() == OP_switch) {
+    MarkStmtLive(*lastStmt);
+  }
+}
+
+void AggressiveDCE::MarkStmtLive(MeStmt &stmt) {
+  if (!liveStmts.insert(&stmt).second) {
+    return;
+  }
+  stmtWorkList.push_back(&stmt);
+  MarkBBLive(*stmt.GetBB());
+}
+
+void AggressiveDCE::MarkValueLive(MeExpr &value) {
+  if (liveValues.insert(&value).second) {
+    valueWorkList.push_back(&value);
+  }
+}
+
+void AggressiveDCE::MarkExprLive(MeExpr &expr) {
+  switch (expr.GetMeOp()) {
+    case kMeOpVar:
+    case kMeOpReg:
+      MarkValueLive(expr);
+      return;
+    case kMeOpIvar: {
+      VarMeExpr *mu = static_cast<IvarMeExpr&>(expr).GetMu();
+      if (mu != nullptr) {
+        MarkValueLive(*mu);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    MeExpr *opnd = expr.GetOpnd(i);
+    if (opnd != nullptr) {
+      MarkExprLive(*opnd);
+    }
+  }
+}
+
+void AggressiveDCE::MarkMuListLive(MapleMap<OStIdx, VarMeExpr*> &muList) {
+  for (auto &muPair : muList) {
+    if (muPair.second != nullptr) {
+      MarkValueLive(*muPair.second);
+    }
+  }
+}
+
+template <typename PhiNode>
+void AggressiveDCE::VisitPhi(PhiNode &phi) {
+  BB *bb = phi.GetDefBB();
+  MarkBBLive(*bb);
+  for (size_t i = 0; i < phi.GetOpnds().size(); ++i) {
+    MarkValueLive(*phi.GetOpnd(i));
+    BB *pred = bb->GetPred(i);
+    MarkBBLive(*pred);
+    MarkBranchLive(*pred);
+  }
+}
+
+// makes the definition of value live
+void AggressiveDCE::VisitValue(MeExpr &value) {
+  if (value.GetMeOp() == kMeOpReg) {
+    auto &reg = static_cast<RegMeExpr&>(value);
+    switch (reg.GetDefBy()) {
+      case kDefByStmt:
+        MarkStmtLive(*reg.GetDefStmt());
+        break;
+      case kDefByPhi:
+        VisitPhi(reg.GetDefPhi());
+        break;
+      case kDefByMustDef:
+        MarkStmtLive(*reg.GetDefMustDef().GetBase());
+        break;
+      default:
+        break;
+    }
+    return;
+  }
+  auto &var = static_cast<VarMeExpr&>(value);
+  switch (var.GetDefBy()) {
+    case kDefByStmt:
+      MarkStmtLive(*var.GetDefStmt());
+      break;
+    case kDefByPhi:
+      VisitPhi(var.GetDefPhi());
+      break;
+    case kDefByChi: {
+      // a may-def may keep the previous value
+      ChiMeNode &chi = var.GetDefChi();
+      MarkStmtLive(*chi.GetBase());
+      MarkValueLive(*chi.GetRHS());
+      break;
+    }
+    case kDefByMustDef:
+      MarkStmtLive(*var.GetDefMustDef().GetBase());
+      break;
+    default:
+      break;
+  }
+}
+
+void AggressiveDCE::VisitStmt(MeStmt &stmt) {
+  for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+    MeExpr *opnd = stmt.GetOpnd(i);
+    if (opnd != nullptr) {
+      MarkExprLive(*opnd);
+    }
+  }
+  MapleMap<OStIdx, VarMeExpr*> *muList = stmt.GetMuList();
+  if (muList != nullptr) {
+    MarkMuListLive(*muList);
+  }
+}
+
+void AggressiveDCE::MarkEssentials() {
+  liveBBs.assign(func.GetAllBBs().size(), false);
+  // the entry and exit are live, they end every path
+  liveBBs[func.GetCommonEntryBB()->GetBBId()] = true;
+  liveBBs[func.GetCommonExitBB()->GetBBId()] = true;
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    for (auto &stmt : (*bIt)->GetMeStmts()) {
+      if (IsEssential(stmt)) {
+        MarkStmtLive(stmt);
+      }
+    }
+  }
+  for (LoopDesc *loop : loops.GetMeLoops()) {
+    for (BBId bbID : loop->loopBBs) {
+      BB *bb = func.GetBBFromID(bbID);
+      if (bb == nullptr) {
+        continue;
+      }
+      for (BB *succ : bb->GetSucc()) {
+        if (!loop->Has(*succ)) {
+          MarkBranchLive(*bb);
+          break;
+        }
+      }
+    }
+  }
+}
+
+void AggressiveDCE::Propagate() {
+  while (!stmtWorkList.empty() || !valueWorkList.empty()) {
+    if (!stmtWorkList.empty()) {
+      MeStmt *stmt = stmtWorkList.back();
+      stmtWorkList.pop_back();
+      VisitStmt(*stmt);
+    } else {
+      MeExpr *value = valueWorkList.back();
+      valueWorkList.pop_back();
+      VisitValue(*value);
+    }
+  }
+}
+
+void AggressiveDCE::RemoveDeadPhis(BB &bb) {
+  for (auto it = bb.GetMevarPhiList().begin(); it != bb.GetMevarPhiList().end();) {
+    if (liveValues.find(it->second->GetLHS()) == liveValues.end()) {
+      it = bb.GetMevarPhiList().erase(it);
+      ++numRemovedPhis;
+    } else {
+      ++it;
+    }
+  }
+  for (auto it = bb.GetMeregphiList().begin(); it != bb.GetMeregphiList().end();) {
+    if (liveValues.find(it->second->GetLHS()) == liveValues.end()) {
+      it = bb.GetMeregphiList().erase(it);
+      ++numRemovedPhis;
+    } else {
+      ++it;
+    }
+  }
+}
+
+bool AggressiveDCE::RemoveDeadBranch(BB &bb) {
+  if (bb.GetKind() != kBBCondGoto || bb.GetMeStmts().empty() || bb.GetSucc().size() != kCondGotoSuccNum) {
+    return false;
+  }
+  MeStmt *lastStmt = to_ptr(bb.GetMeStmts().rbegin());
+  if (!lastStmt->IsCondBr() || liveStmts.find(lastStmt) != liveStmts.end()) {
+    return false;
+  }
+  BB *pdomBB = dom.GetPdom(bb.GetBBId());
+  if (pdomBB == nullptr || pdomBB == func.GetCommonExitBB() || pdomBB == &bb ||
+      !pdomBB->GetMevarPhiList().empty() || !pdomBB->GetMeregphiList().empty()) {
+    return false;
+  }
+  std::vector<BB*> succs(bb.GetSucc().begin(), bb.GetSucc().end());
+  for (BB *succ : succs) {
+    bb.RemoveSucc(succ);
+    if (succ->GetPred().size() == 1) {
+      func.GetTheCfg()->ConvertPhis2IdentityAssigns(*succ);
+    }
+  }
+  // the phis of the MIR level are only the input of the IR map, they have no operand for the new edge
+  pdomBB->ClearPhiList();
+  bb.AddSuccBB(pdomBB);
+  GotoNode stmt(OP_goto);
+  GotoMeStmt *newGoto = func.GetIRMap()->New<GotoMeStmt>(&stmt);
+  newGoto->SetOffset(func.GetOrCreateBBLabel(*pdomBB));
+  bb.InsertMeStmtBefore(lastStmt, newGoto);
+  bb.RemoveMeStmt(lastStmt);
+  bb.SetKind(kBBGoto);
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "dce: BB " << bb.GetBBId() << " jumps to its post-dominator BB " << pdomBB->GetBBId()
+                           << '\n';
+  }
+  return true;
+}
+
+void AggressiveDCE::RemoveDeadCode() {
+  std::vector<BB*> bbs;
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    bbs.push_back(*bIt);
+  }
+  for (BB *bb : bbs) {
+    RemoveDeadPhis(*bb);
+    MeStmt *nextStmt = nullptr;
+    for (MeStmt *stmt = to_ptr(bb->GetMeStmts().begin()); stmt != nullptr; stmt = nextStmt) {
+      nextStmt = stmt->GetNext();
+      Opcode op = stmt->GetOp();
+      if ((op == OP_dassign || op == OP_regassign) && liveStmts.find(stmt) == liveStmts.end()) {
+        bb->RemoveMeStmt(stmt);
+      }
+    }
+  }
+  for (BB *bb : bbs) {
+    if (RemoveDeadBranch(*bb)) {
+      ++numRemovedBranches;
+    }
+  }
+  if (numRemovedBranches != 0) {
+    func.GetTheCfg()->UnreachCodeAnalysis(true);
+  }
+}
+
+uint32 AggressiveDCE::CountStmts() const {
+  uint32 count = 0;
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    count += static_cast<uint32>(std::distance((*bIt)->GetMeStmts().begin(), (*bIt)->GetMeStmts().end()));
+  }
+  return count;
+}
+
+void AggressiveDCE::Run() {
+  uint32 numStmts = CountStmts();
+  MarkEssentials();
+  Propagate();
+  RemoveDeadCode();
+  // the gotos replacing dead branches are not counted as removed
+  numRemovedStmts = numStmts + numRemovedBranches - CountStmts();
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "dce: " << func.GetName() << ": " << numRemovedStmts << " statements, "
+                           << numRemovedPhis << " phis and " << numRemovedBranches << " branches removed\n";
+  }
+}
+
+AnalysisResult *MeDoDCE::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr*) {
+  auto *dom = static_cast<Dominance*>(funcResMgr->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_FATAL(dom != nullptr, "dominance phase has problem");
+  auto *loops = static_cast<IdentifyLoops*>(funcResMgr->GetAnalysisResult(MeFuncPhase_MELOOP, func));
+  CHECK_FATAL(loops != nullptr, "meloop phase has problem");
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  AggressiveDCE dce(*func, *dom, *loops, DEBUGFUNC(func));
+  dce.Run();
+  if (dce.IsCFGChanged()) {
+    funcResMgr->InvalidAnalysisResult(MeFuncPhase_DOMINANCE, func);
+    funcResMgr->InvalidAnalysisResult(MeFuncPhase_MELOOP, func);
+  }
+  return nullptr;
+}
+}  // namespace maple
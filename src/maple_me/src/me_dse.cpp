@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_dse.h"
+
+// Dropping a store must not be observable:
+//  - nothing between the dead store and the killing store, nor the values they store, reads the versions of the
+//    dead store or may trap; a read through the same base cannot trap once the dead store completed;
+//  - if the base is null, the killing store throws the same exception instead, after the statements in between ran;
+//    in a try block the handler may see the locals they assign, so only stores through the base may run there;
+//  - volatile stores are kept.
+namespace maple {
+bool DeadStoreElim::IsStoreVersion(const MeExpr &expr) const {
+  if (expr.GetMeOp() != kMeOpVar) {
+    return false;
+  }
+  auto versionIt = storeVersions.find(static_cast<const VarMeExpr&>(expr).GetOStIdx());
+  return versionIt != storeVersions.end() && versionIt->second == &expr;
+}
+
+// true if expr neither traps nor reads the versions of the store through base
+bool DeadStoreElim::IsSafeExpr(MeExpr &expr, const MeExpr &base) const {
+  switch (expr.GetMeOp()) {
+    case kMeOpVar:
+      return !IsStoreVersion(expr);
+    case kMeOpReg:
+    case kMeOpConst:
+    case kMeOpConststr:
+    case kMeOpConststr16:
+    case kMeOpAddrof:
+    case kMeOpAddroffunc:
+    case kMeOpSizeoftype:
+    case kMeOpFieldsDist:
+      return true;
+    case kMeOpIvar: {
+      auto &ivar = static_cast<IvarMeExpr&>(expr);
+      return ivar.GetBase() == &base && !ivar.IsVolatile() &&
+             (ivar.GetMu() == nullptr || !IsStoreVersion(*ivar.GetMu()));
+    }
+    case kMeOpOp:
+      if (expr.GetOp() == OP_div || expr.GetOp() == OP_rem || expr.IsGcmalloc() ||
+          expr.GetOp() == OP_resolveinterfacefunc || expr.GetOp() == OP_resolvevirtualfunc) {
+        return false;
+      }
+      break;
+    case kMeOpNary:
+      // element addresses are computed without trapping, intrinsics may throw
+      if (expr.GetOp() != OP_array) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    if (!IsSafeExpr(*expr.GetOpnd(i), base)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DeadStoreElim::IsSafeStmt(MeStmt &stmt, const MeExpr &base, bool inTry) const {
+  switch (stmt.GetOp()) {
+    case OP_dassign: {
+      VarMeExpr *lhs = stmt.GetVarLHS();
+      const OriginalSt *ost = ssaTab.GetOriginalStFromID(lhs->GetOStIdx());
+      return !inTry && ost != nullptr && ost->IsLocal() && !lhs->IsVolatile(ssaTab) && IsSafeExpr(*stmt.GetRHS(), base);
+    }
+    case OP_regassign:
+      return !inTry && IsSafeExpr(*stmt.GetRHS(), base);
+    case OP_iassign: {
+      auto &iassign = static_cast<IassignMeStmt&>(stmt);
+      return iassign.GetLHSVal()->GetBase() == &base && !iassign.GetLHSVal()->IsVolatile() &&
+             IsSafeExpr(*iassign.GetRHS(), base);
+    }
+    case OP_assertnonnull:
+      return stmt.GetOpnd(0) == &base;
+    case OP_comment:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool DeadStoreElim::IsSameLocation(IassignMeStmt &store, IassignMeStmt &other) const {
+  IvarMeExpr *lhs = store.GetLHSVal();
+  IvarMeExpr *otherLHS = other.GetLHSVal();
+  return lhs->GetBase() == otherLHS->GetBase() && lhs->GetFieldID() == otherLHS->GetFieldID() &&
+         lhs->GetTyIdx() == otherLHS->GetTyIdx() && store.GetTyIdx() == other.GetTyIdx();
+}
+
+// moves the versions of the store past the chis of stmt
+void DeadStoreElim::FollowChis(MeStmt &stmt) {
+  MapleMap<OStIdx, ChiMeNode*> *chiList = stmt.GetChiList();
+  if (chiList == nullptr) {
+    return;
+  }
+  for (auto &chiPair : *chiList) {
+    auto versionIt = storeVersions.find(chiPair.first);
+    if (versionIt == storeVersions.end() || chiPair.second->GetRHS() != versionIt->second) {
+      continue;
+    }
+    (void)firstUses.insert(std::make_pair(chiPair.first, chiPair.second));
+    versionIt->second = chiPair.second->GetLHS();
+  }
+}
+
+// The killer overwrites the location of the store, and its chis take every version of the store, so none of them
+// is live after it.
+bool DeadStoreElim::IsKilled(IassignMeStmt &store, IassignMeStmt &killer) const {
+  if (!IsSameLocation(store, killer) || killer.GetLHSVal()->IsVolatile()) {
+    return false;
+  }
+  for (auto &versionPair : storeVersions) {
+    auto chiIt = killer.GetChiList()->find(versionPair.first);
+    if (chiIt == killer.GetChiList()->end() || chiIt->second->GetRHS() != versionPair.second) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DeadStoreElim::RemoveIfDead(BB &bb, IassignMeStmt &store) {
+  IvarMeExpr *lhs = store.GetLHSVal();
+  MeExpr &base = *lhs->GetBase();
+  storeVersions.clear();
+  firstUses.clear();
+  if (lhs->IsVolatile() || !IsSafeExpr(*store.GetRHS(), base)) {
+    return false;
+  }
+  for (auto &chiPair : *store.GetChiList()) {
+    storeVersions[chiPair.first] = chiPair.second->GetLHS();
+  }
+  bool inTry = bb.GetAttributes(kBBAttrIsTry);
+  for (MeStmt *stmt = store.GetNext(); stmt != nullptr; stmt = stmt->GetNext()) {
+    if (stmt->GetOp() == OP_iassign && IsSameLocation(store, static_cast<IassignMeStmt&>(*stmt))) {
+      auto &killer = static_cast<IassignMeStmt&>(*stmt);
+      // the killer may store a value read from the location
+      if (!IsSafeExpr(*killer.GetRHS(), base) || !IsKilled(store, killer)) {
+        return false;
+      }
+      FollowChis(killer);
+      // the versions the store defined now come from before it
+      for (auto &chiPair : *store.GetChiList()) {
+        firstUses[chiPair.first]->SetRHS(chiPair.second->GetRHS());
+      }
+      bb.RemoveMeStmt(&store);
+      return true;
+    }
+    if (!IsSafeStmt(*stmt, base, inTry)) {
+      return false;
+    }
+    FollowChis(*stmt);
+  }
+  return false;
+}
+
+void DeadStoreElim::Run() {
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB &bb = **bIt;
+    MeStmt *nextStmt = nullptr;
+    for (MeStmt *stmt = to_ptr(bb.GetMeStmts().begin()); stmt != nullptr; stmt = nextStmt) {
+      nextStmt = stmt->GetNext();
+      if (stmt->GetOp() != OP_iassign) {
+        continue;
+      }
+      ++numStores;
+      if (RemoveIfDead(bb, static_cast<IassignMeStmt&>(*stmt))) {
+        ++numRemovedStores;
+        if (enabledDebug) {
+          LogInfo::MapleLogger() << "dse: remove dead store in BB " << bb.GetBBId() << '\n';
+        }
+      }
+    }
+  }
+  if (enabledDebug && numStores != 0) {
+    LogInfo::MapleLogger() << "dse: " << func.GetName() << ": " << numRemovedStores << " of " << numStores
+                           << " stores removed\n";
+  }
+}
+
+AnalysisResult *MeDoDSE::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr*) {
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  DeadStoreElim dse(*func, DEBUGFUNC(func));
+  dse.Run();
+  return nullptr;
+}
+}  // namespace maple
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_edge_profile.h"
+#include <sstream>
+#include "me_option.h"
+#include "mir_builder.h"
+
+// The common exit BB is joined to the common entry BB by a virtual edge, so that the counts of every function
+// execution form a circulation: at each BB the incoming counts add up to the outgoing ones. The counts of the edges
+// out of a spanning tree then determine all the others. Exception edges and critical edges cannot carry a counter
+// without splitting them, so they are put in the tree first; a function whose tree cannot take all of them is left
+// alone. Flow conservation is exact for functions that return or throw out normally; counts around an exception
+// raised in the middle of a BB are approximate.
+namespace maple {
+void EdgeProfile::CollectEdges() {
+  BB *commonEntry = func.GetCommonEntryBB();
+  BB *commonExit = func.GetCommonExitBB();
+  edges.clear();
+  numSuccs.assign(func.GetAllBBs().size(), 0);
+  numPreds.assign(func.GetAllBBs().size(), 0);
+  edges.push_back(Edge{ commonExit, commonEntry, false });
+  for (auto bIt = func.valid_begin(); bIt != func.valid_end(); ++bIt) {
+    BB *bb = *bIt;
+    if (bb == commonExit) {
+      continue;
+    }
+    for (BB *succ : bb->GetSucc()) {
+      edges.push_back(Edge{ bb, succ, false });
+    }
+    if (bb != commonEntry && bb->IsPredBB(*commonExit)) {
+      edges.push_back(Edge{ bb, commonExit, false });
+    }
+  }
+  for (size_t i = 1; i < edges.size(); ++i) {
+    ++numSuccs[edges[i].src->UintID()];
+    ++numPreds[edges[i].dst->UintID()];
+  }
+}
+
+uint32 EdgeProfile::FindRoot(std::vector<uint32> &roots, uint32 id) const {
+  while (roots[id] != id) {
+    roots[id] = roots[roots[id]];
+    id = roots[id];
+  }
+  return id;
+}
+
+// adds edge to the tree unless it closes a cycle
+bool EdgeProfile::AddTreeEdge(std::vector<uint32> &roots, Edge &edge) const {
+  uint32 srcRoot = FindRoot(roots, edge.src->UintID());
+  uint32 dstRoot = FindRoot(roots, edge.dst->UintID());
+  if (srcRoot == dstRoot) {
+    return false;
+  }
+  roots[srcRoot] = dstRoot;
+  edge.inTree = true;
+  return true;
+}
+
+// a counter goes at the end of a source BB with a single successor or at the start of a destination BB with a single
+// predecessor, the common entry and exit BBs hold no code
+bool EdgeProfile::CanInstrument(const Edge &edge) const {
+  if (edge.dst->GetAttributes(kBBAttrIsCatch)) {
+    return false;
+  }
+  if (edge.src != func.GetCommonEntryBB() && edge.src != func.GetCommonExitBB() &&
+      numSuccs[edge.src->UintID()] == 1) {
+    return true;
+  }
+  return edge.dst != func.GetCommonExitBB() && edge.dst != func.GetCommonEntryBB() &&
+         numPreds[edge.dst->UintID()] == 1;
+}
+
+bool EdgeProfile::BuildSpanningTree() {
+  std::vector<uint32> roots(func.GetAllBBs().size());
+  for (uint32 i = 0; i < roots.size(); ++i) {
+    roots[i] = i;
+  }
+  for (Edge &edge : edges) {
+    if (!CanInstrument(edge) && !AddTreeEdge(roots, edge)) {
+      if (enabledDebug) {
+        LogInfo::MapleLogger() << "edgeprofile: " << func.GetName() << ": edge BB " << edge.src->GetBBId()
+                               << " -> BB " << edge.dst->GetBBId() << " cannot be counted\n";
+      }
+      return false;
+    }
+  }
+  for (Edge &edge : edges) {
+    if (!edge.inTree) {
+      (void)AddTreeEdge(roots, edge);
+    }
+  }
+  return true;
+}
+
+BaseNode *EdgeProfile::CreateCounterAddr(const MIRSymbol &counterTable, uint32 index) const {
+  MIRBuilder *mirBuilder = func.GetMIRModule().GetMIRBuilder();
+  ArrayNode *addr = mirBuilder->CreateExprArray(*counterTable.GetType(), mirBuilder->CreateExprAddrof(0, counterTable),
+                                                mirBuilder->CreateIntConst(index, PTY_i32));
+  addr->SetBoundsCheck(false);
+  return addr;
+}
+
+// counters[index] = counters[index] + 1
+StmtNode *EdgeProfile::CreateIncrement(const MIRSymbol &counterTable, uint32 index) const {
+  MIRBuilder *mirBuilder = func.GetMIRModule().GetMIRBuilder();
+  MIRType *counterType = GlobalTables::GetTypeTable().GetUInt64();
+  MIRType *counterPtrType = GlobalTables::GetTypeTable().GetOrCreatePointerType(*counterType);
+  BaseNode *count = mirBuilder->CreateExprIread(*counterType, *counterPtrType, 0,
+                                                CreateCounterAddr(counterTable, index));
+  BaseNode *newCount = mirBuilder->CreateExprBinary(OP_add, *counterType, count,
+                                                    mirBuilder->CreateIntConst(1, PTY_u64));
+  return mirBuilder->CreateStmtIassign(*counterPtrType, 0, CreateCounterAddr(counterTable, index), newCount);
+}
+
+void EdgeProfile::InsertIncrement(const Edge &edge, StmtNode &increment) const {
+  if (edge.src != func.GetCommonEntryBB() && numSuccs[edge.src->UintID()] == 1) {
+    BB &bb = *edge.src;
+    if (bb.IsEmpty()) {
+      bb.AddStmtNode(&increment);
+      return;
+    }
+    StmtNode *last = bb.GetLast();
+    switch (last->GetOpCode()) {
+      case OP_goto:
+      case OP_brfalse:
+      case OP_brtrue:
+      case OP_switch:
+      case OP_return:
+      case OP_throw:
+      case OP_gosub:
+      case OP_retsub:
+        bb.InsertStmtBefore(last, &increment);
+        break;
+      default:
+        bb.AddStmtNode(&increment);
+        break;
+    }
+    return;
+  }
+  // the counter goes after the statements opening a try or catch block
+  BB &bb = *edge.dst;
+  for (auto &stmt : bb.GetStmtNodes()) {
+    Opcode op = stmt.GetOpCode();
+    if (op != OP_try && op != OP_catch && op != OP_jscatch && op != OP_finally) {
+      bb.InsertStmtBefore(&stmt, &increment);
+      return;
+    }
+  }
+  bb.AddStmtNode(&increment);
+}
+
+uint32 EdgeProfile::Instrument(MIRSymbol &counterTable, uint32 firstCounter, std::ostream &mapFile) {
+  CollectEdges();
+  if (!BuildSpanningTree()) {
+    return 0;
+  }
+  uint32 numCounters = 0;
+  for (const Edge &edge : edges) {
+    if (!edge.inTree) {
+      ++numCounters;
+    }
+  }
+  if (numCounters == 0) {
+    return 0;
+  }
+  // grow the table before the counters are addressed, earlier functions index the table with a smaller bound
+  MIRArrayType *tableType =
+      GlobalTables::GetTypeTable().GetOrCreateArrayType(*GlobalTables::GetTypeTable().GetUInt64(),
+                                                        firstCounter + numCounters);
+  counterTable.SetTyIdx(tableType->GetTypeIndex());
+  uint32 index = firstCounter;
+  for (const Edge &edge : edges) {
+    if (edge.inTree) {
+      continue;
+    }
+    InsertIncrement(edge, *CreateIncrement(counterTable, index));
+    mapFile << index << " " << func.GetName() << " " << edge.src->UintID() << " " << edge.dst->UintID() << '\n';
+    ++index;
+  }
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "edgeprofile: " << func.GetName() << ": " << numCounters << " counters for "
+                           << (edges.size() - 1) << " edges\n";
+  }
+  return numCounters;
+}
+
+void EdgeProfile::SetFrequencies(const EdgeCountMap &counts) {
+  CollectEdges();
+  std::vector<uint64> edgeCounts(edges.size(), 0);
+  std::vector<bool> known(edges.size(), false);
+  std::vector<std::vector<size_t>> inEdges(func.GetAllBBs().size());
+  std::vector<std::vector<size_t>> outEdges(func.GetAllBBs().size());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    outEdges[edges[i].src->UintID()].push_back(i);
+    inEdges[edges[i].dst->UintID()].push_back(i);
+    auto it = counts.find(std::make_pair(edges[i].src->UintID(), edges[i].dst->UintID()));
+    if (it != counts.end()) {
+      edgeCounts[i] = it->second;
+      known[i] = true;
+    }
+  }
+  // when all but one edge on a side of a BB are known, the last one makes up the difference with the other side
+  auto solveSide = [&edgeCounts, &known](const std::vector<size_t> &side, const std::vector<size_t> &otherSide) {
+    uint64 otherSum = 0;
+    for (size_t i : otherSide) {
+      if (!known[i]) {
+        return false;
+      }
+      otherSum += edgeCounts[i];
+    }
+    uint64 sum = 0;
+    size_t unknownEdge = 0;
+    size_t numUnknown = 0;
+    for (size_t i : side) {
+      if (known[i]) {
+        sum += edgeCounts[i];
+      } else {
+        unknownEdge = i;
+        ++numUnknown;
+      }
+    }
+    if (numUnknown != 1) {
+      return false;
+    }
+    edgeCounts[unknownEdge] = otherSum > sum ? otherSum - sum : 0;
+    known[unknownEdge] = true;
+    return true;
+  };
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t id = 0; id < inEdges.size(); ++id) {
+      changed = solveSide(outEdges[id], inEdges[id]) || changed;
+      changed = solveSide(inEdges[id], outEdges[id]) || changed;
+    }
+  }
+  for (auto bIt = func.valid_begin(); bIt != func.valid_end(); ++bIt) {
+    BB *bb = *bIt;
+    uint64 count = 0;
+    for (size_t i : inEdges[bb->UintID()]) {
+      count += edgeCounts[i];
+    }
+    bb->SetFrequency(static_cast<uint32>(std::min<uint64>(count, UINT32_MAX)));
+    if (enabledDebug) {
+      LogInfo::MapleLogger() << "edgeprofile: " << func.GetName() << ": BB " << bb->GetBBId() << " count " << count
+                             << '\n';
+    }
+  }
+}
+
+void MeDoEdgeProfile::ReadProfile() {
+  std::ifstream mapIn(MeOption::edgeProfileMap);
+  std::ifstream countsIn(MeOption::edgeProfileUse);
+  if (!mapIn.is_open() || !countsIn.is_open()) {
+    LogInfo::MapleLogger() << "edgeprofile: cannot read " << MeOption::edgeProfileUse << " with map "
+                           << MeOption::edgeProfileMap << '\n';
+    return;
+  }
+  std::map<uint32, uint64> countOfCounter;
+  std::string line;
+  while (std::getline(countsIn, line)) {
+    std::istringstream fields(line);
+    uint32 index = 0;
+    uint64 count = 0;
+    if (fields >> index >> count) {
+      countOfCounter[index] += count;
+    }
+  }
+  while (std::getline(mapIn, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    uint32 index = 0;
+    std::string funcName;
+    uint32 srcID = 0;
+    uint32 dstID = 0;
+    if (!(fields >> index >> funcName >> srcID >> dstID)) {
+      continue;
+    }
+    // a counter missing from the dump never ran
+    auto it = countOfCounter.find(index);
+    edgeCounts[funcName][std::make_pair(srcID, dstID)] = (it == countOfCounter.end()) ? 0 : it->second;
+  }
+}
+
+AnalysisResult *MeDoEdgeProfile::Run(MeFunction *func, MeFuncResultMgr*, ModuleResultMgr*) {
+  EdgeProfile edgeProfile(*func, DEBUGFUNC(func));
+  if (!MeOption::edgeProfileGen.empty()) {
+    if (counterTable == nullptr) {
+      MIRModule &mirModule = func->GetMIRModule();
+      std::string tableName = kEdgeCounterTabPrefixStr + mirModule.GetFileNameAsPostfix();
+      counterTable = mirModule.GetMIRBuilder()->GetOrCreateGlobalDecl(
+          tableName, *GlobalTables::GetTypeTable().GetOrCreateArrayType(*GlobalTables::GetTypeTable().GetUInt64(), 1));
+      mapFile.open(MeOption::edgeProfileGen, std::ios::trunc);
+      CHECK_FATAL(mapFile.is_open(), "cannot write %s", MeOption::edgeProfileGen.c_str());
+      mapFile << "# counters in " << tableName << '\n';
+    }
+    numCounters += edgeProfile.Instrument(*counterTable, numCounters, mapFile);
+    mapFile.flush();
+  } else if (!MeOption::edgeProfileUse.empty()) {
+    if (!profileRead) {
+      ReadProfile();
+      profileRead = true;
+    }
+    auto it = edgeCounts.find(func->GetName());
+    if (it != edgeCounts.end()) {
+      edgeProfile.SetFrequencies(it->second);
+    }
+  }
+  return nullptr;
+}
+}  // namespace maple
@@ -0,0 +1,478 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_escape_analysis.h"
+#include "gen_check_cast.h"
+#include "name_mangler.h"
+
+// EscapeAnalysis works in three steps:
+// 1. every dassign/regassign of a gcmalloc or gcmallocjarray is an allocation site; a site assigned to a
+//    non-local variable escapes right away.
+// 2. the sites each local SSA value may refer to are propagated along copies and phis until nothing changes.
+// 3. every use of a value is classified. Dereferencing it, comparing it, locking it or passing it to a direct
+//    callee that does not leak the parameter is safe; any other use (storing it into memory or a global,
+//    returning or throwing it, passing it to unknown code) makes all the sites it may refer to escape.
+// Parameter summaries of callees are computed on demand from their MIR bodies with the same classification.
+namespace maple {
+// summaries of callees of callees are computed only up to this depth
+static constexpr uint32 kMaxSummaryDepth = 3;
+// the empty summary means every parameter escapes
+static const std::vector<ParamSummary> kEscapingSummary;
+static const std::string kJavaLangObjectInit =
+    std::string(NameMangler::kJavaLangObjectStr) + NameMangler::kCinitStr + "_29V";
+
+bool EscapeAnalysis::IsLocalValue(const MeExpr &expr) const {
+  if (expr.GetMeOp() == kMeOpReg) {
+    return true;
+  }
+  if (expr.GetMeOp() != kMeOpVar) {
+    return false;
+  }
+  const OriginalSt *ost = ssaTab.GetOriginalStFromID(static_cast<const VarMeExpr&>(expr).GetOStIdx());
+  return ost != nullptr && ost->IsLocal();
+}
+
+bool EscapeAnalysis::IsAllocation(const MeExpr &rhs) const {
+  return rhs.GetMeOp() == kMeOpGcmalloc || rhs.GetOp() == OP_gcmallocjarray;
+}
+
+// return the local value rhs copies, or nullptr if rhs computes something new
+MeExpr *EscapeAnalysis::GetCopySource(MeExpr &rhs) const {
+  MeExpr *source = &rhs;
+  if (rhs.GetOp() == OP_retype) {
+    source = rhs.GetOpnd(0);
+  }
+  return IsLocalValue(*source) ? source : nullptr;
+}
+
+// the runtime checks of a lowered checkcast only look at the class of their argument
+bool EscapeAnalysis::IsRuntimeCheckCall(const MIRFunction &callee) const {
+  const std::string &name = callee.GetName();
+  return name == kMCCReflectCheckCastingNoArray || name == kMCCReflectCheckCastingArray ||
+         name == kMCCReflectThrowCastException;
+}
+
+void EscapeAnalysis::CollectSites() {
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    for (auto &stmt : (*bIt)->GetMeStmts()) {
+      if ((stmt.GetOp() != OP_dassign && stmt.GetOp() != OP_regassign) || !IsAllocation(*stmt.GetRHS())) {
+        continue;
+      }
+      MeExpr *lhs = stmt.GetLHS();
+      uint32 site = static_cast<uint32>(siteEscapes.size());
+      siteEscapes.push_back(!IsLocalValue(*lhs));
+      siteOfValue[lhs] = site;
+      pointsTo[lhs].insert(site);
+    }
+  }
+}
+
+bool EscapeAnalysis::AddPointsTo(MeExpr &to, const MeExpr &from) {
+  auto it = pointsTo.find(&from);
+  if (it == pointsTo.end()) {
+    return false;
+  }
+  std::set<uint32> &toSites = pointsTo[&to];
+  size_t oldSize = toSites.size();
+  toSites.insert(it->second.begin(), it->second.end());
+  return toSites.size() != oldSize;
+}
+
+void EscapeAnalysis::PropagatePointsTo() {
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    auto eIt = func.valid_end();
+    for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+      BB *bb = *bIt;
+      for (auto &phiPair : bb->GetMevarPhiList()) {
+        MeVarPhiNode *phi = phiPair.second;
+        if (!phi->GetIsLive()) {
+          continue;
+        }
+        for (VarMeExpr *opnd : phi->GetOpnds()) {
+          changed = AddPointsTo(*phi->GetLHS(), *opnd) || changed;
+        }
+      }
+      for (auto &phiPair : bb->GetMeregphiList()) {
+        MeRegPhiNode *phi = phiPair.second;
+        if (!phi->GetIsLive()) {
+          continue;
+        }
+        for (RegMeExpr *opnd : phi->GetOpnds()) {
+          changed = AddPointsTo(*phi->GetLHS(), *opnd) || changed;
+        }
+      }
+      for (auto &stmt : bb->GetMeStmts()) {
+        if (stmt.GetOp() != OP_dassign && stmt.GetOp() != OP_regassign) {
+          continue;
+        }
+        MeExpr *source = GetCopySource(*stmt.GetRHS());
+        if (source != nullptr && IsLocalValue(*stmt.GetLHS())) {
+          changed = AddPointsTo(*stmt.GetLHS(), *source) || changed;
+        }
+      }
+    }
+  }
+}
+
+void EscapeAnalysis::MarkEscape(const MeExpr &value) {
+  auto it = pointsTo.find(&value);
+  if (it == pointsTo.end()) {
+    return;
+  }
+  for (uint32 site : it->second) {
+    siteEscapes[site] = true;
+  }
+}
+
+void EscapeAnalysis::VisitExpr(MeExpr &expr, EscapeContext context) {
+  switch (expr.GetMeOp()) {
+    case kMeOpVar:
+    case kMeOpReg:
+      if (context == kEscapeUnsafe) {
+        MarkEscape(expr);
+      }
+      return;
+    case kMeOpIvar:
+      VisitBaseExpr(*static_cast<IvarMeExpr&>(expr).GetBase(), kEscapeLoadBase);
+      return;
+    case kMeOpAddrof: {
+      OStIdx ostIdx = static_cast<AddrofMeExpr&>(expr).GetOstIdx();
+      const OriginalSt *ost = ssaTab.GetOriginalStFromID(ostIdx);
+      if (ost != nullptr && ost->IsLocal()) {
+        addressTakenOsts.insert(ostIdx);
+      }
+      return;
+    }
+    default:
+      break;
+  }
+  EscapeContext opndContext = kEscapeUnsafe;
+  if (kOpcodeInfo.IsCompare(expr.GetOp())) {
+    opndContext = kEscapeCompare;
+  } else if (expr.GetOp() == OP_retype) {
+    opndContext = context;
+  } else if (expr.GetOp() == OP_intrinsicop) {
+    MIRIntrinsicID intrinsic = static_cast<NaryMeExpr&>(expr).GetIntrinsic();
+    if (intrinsic == INTRN_JAVA_ARRAY_LENGTH || intrinsic == INTRN_JAVA_INSTANCE_OF) {
+      opndContext = kEscapeCompare;
+    }
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    VisitExpr(*expr.GetOpnd(i), opndContext);
+  }
+}
+
+// base is the address operand of a load or store, for arrays only the array object itself is dereferenced
+void EscapeAnalysis::VisitBaseExpr(MeExpr &base, EscapeContext context) {
+  if (base.GetOp() != OP_array) {
+    VisitExpr(base, context);
+    return;
+  }
+  VisitExpr(*base.GetOpnd(0), context);
+  for (size_t i = 1; i < base.GetNumOpnds(); ++i) {
+    VisitExpr(*base.GetOpnd(i), kEscapeUnsafe);
+  }
+}
+
+void EscapeAnalysis::VisitCallArgs(CallMeStmt &call) {
+  MIRFunction *callee = GlobalTables::GetFunctionTable().GetFunctionFromPuidx(call.GetPUIdx());
+  if (IsRuntimeCheckCall(*callee)) {
+    for (size_t i = 0; i < call.NumMeStmtOpnds(); ++i) {
+      VisitExpr(*call.GetOpnd(i), kEscapeCompare);
+    }
+    return;
+  }
+  const std::vector<ParamSummary> &summary = GetSummary(call.GetPUIdx(), 0);
+  for (size_t i = 0; i < call.NumMeStmtOpnds(); ++i) {
+    bool noEscape = i < summary.size() && summary[i].noEscape;
+    VisitExpr(*call.GetOpnd(i), noEscape ? kEscapeCompare : kEscapeUnsafe);
+  }
+}
+
+void EscapeAnalysis::VisitStmt(MeStmt &stmt) {
+  switch (stmt.GetOp()) {
+    case OP_dassign:
+    case OP_regassign: {
+      // copies into local values are tracked by the points-to sets
+      if (IsLocalValue(*stmt.GetLHS()) && GetCopySource(*stmt.GetRHS()) != nullptr) {
+        return;
+      }
+      VisitExpr(*stmt.GetRHS(), kEscapeUnsafe);
+      return;
+    }
+    case OP_iassign:
+      VisitBaseExpr(*stmt.GetOpnd(0), kEscapeStoreBase);
+      VisitExpr(*stmt.GetOpnd(1), kEscapeUnsafe);
+      return;
+    case OP_brtrue:
+    case OP_brfalse:
+    case OP_syncenter:
+    case OP_syncexit:
+    case OP_assertnonnull:
+    case OP_eval:
+      for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+        VisitExpr(*stmt.GetOpnd(i), kEscapeCompare);
+      }
+      return;
+    case OP_call:
+    case OP_callassigned:
+      VisitCallArgs(static_cast<CallMeStmt&>(stmt));
+      return;
+    default:
+      for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+        VisitExpr(*stmt.GetOpnd(i), kEscapeUnsafe);
+      }
+      return;
+  }
+}
+
+// a local variable whose address is taken can be modified behind our back
+void EscapeAnalysis::MarkAddressTakenSites() {
+  if (addressTakenOsts.empty()) {
+    return;
+  }
+  for (auto &valuePair : pointsTo) {
+    const MeExpr *value = valuePair.first;
+    if (value->GetMeOp() == kMeOpVar &&
+        addressTakenOsts.find(static_cast<const VarMeExpr*>(value)->GetOStIdx()) != addressTakenOsts.end()) {
+      MarkEscape(*value);
+    }
+  }
+}
+
+const std::vector<ParamSummary> &EscapeAnalysis::GetSummary(PUIdx puIdx, uint32 depth) {
+  auto it = summaries.find(puIdx);
+  if (it != summaries.end()) {
+    return it->second;
+  }
+  // the body of the function being optimized has already been replaced by the MeIR
+  if (depth > kMaxSummaryDepth || puIdx == func.GetMirFunc()->GetPuidx() ||
+      pendingSummaries.find(puIdx) != pendingSummaries.end()) {
+    return kEscapingSummary;
+  }
+  MIRFunction *callee = GlobalTables::GetFunctionTable().GetFunctionFromPuidx(puIdx);
+  if (callee == nullptr) {
+    return kEscapingSummary;
+  }
+  std::vector<ParamSummary> summary;
+  if (callee->GetName() == kJavaLangObjectInit) {
+    // java.lang.Object.<init> does nothing, but its body is not part of the module
+    summary.assign(callee->GetFormalCount(), ParamSummary{ true, true });
+  } else if (callee->GetBody() != nullptr) {
+    summary.assign(callee->GetFormalCount(), ParamSummary{ true, true });
+    pendingSummaries.insert(puIdx);
+    ComputeSummary(*callee, summary, depth);
+    pendingSummaries.erase(puIdx);
+  }
+  return summaries[puIdx] = summary;
+}
+
+void EscapeAnalysis::ComputeSummary(const MIRFunction &callee, std::vector<ParamSummary> &summary, uint32 depth) {
+  for (const StmtNode *stmt = callee.GetBody()->GetFirst(); stmt != nullptr; stmt = stmt->GetNext()) {
+    VisitMIRStmt(callee, *stmt, summary, depth);
+  }
+}
+
+void EscapeAnalysis::VisitMIRExpr(const MIRFunction &callee, const BaseNode &expr, EscapeContext context,
+                                  std::vector<ParamSummary> &summary, uint32 depth) {
+  Opcode op = expr.GetOpCode();
+  if (op == OP_dread || op == OP_addrof) {
+    StIdx stIdx = static_cast<const AddrofNode&>(expr).GetStIdx();
+    for (size_t i = 0; i < summary.size(); ++i) {
+      if (callee.GetFormal(i)->GetStIdx() != stIdx) {
+        continue;
+      }
+      if (op == OP_addrof || context == kEscapeUnsafe) {
+        summary[i] = ParamSummary{ false, false };
+      } else if (context == kEscapeStoreBase) {
+        summary[i].readOnly = false;
+      }
+    }
+    return;
+  }
+  if (op == OP_iread) {
+    VisitMIRBaseExpr(callee, *expr.Opnd(0), kEscapeLoadBase, summary, depth);
+    return;
+  }
+  EscapeContext opndContext = kEscapeUnsafe;
+  if (kOpcodeInfo.IsCompare(op)) {
+    opndContext = kEscapeCompare;
+  } else if (op == OP_retype) {
+    opndContext = context;
+  } else if (op == OP_intrinsicop) {
+    MIRIntrinsicID intrinsic = static_cast<const IntrinsicopNode&>(expr).GetIntrinsic();
+    if (intrinsic == INTRN_JAVA_ARRAY_LENGTH || intrinsic == INTRN_JAVA_INSTANCE_OF) {
+      opndContext = kEscapeCompare;
+    }
+  }
+  for (size_t i = 0; i < expr.NumOpnds(); ++i) {
+    VisitMIRExpr(callee, *expr.Opnd(i), opndContext, summary, depth);
+  }
+}
+
+void EscapeAnalysis::VisitMIRBaseExpr(const MIRFunction &callee, const BaseNode &base, EscapeContext context,
+                                      std::vector<ParamSummary> &summary, uint32 depth) {
+  if (base.GetOpCode() != OP_array) {
+    VisitMIRExpr(callee, base, context, summary, depth);
+    return;
+  }
+  VisitMIRExpr(callee, *base.Opnd(0), context, summary, depth);
+  for (size_t i = 1; i < base.NumOpnds(); ++i) {
+    VisitMIRExpr(callee, *base.Opnd(i), kEscapeUnsafe, summary, depth);
+  }
+}
+
+void EscapeAnalysis::VisitMIRStmt(const MIRFunction &callee, const StmtNode &stmt,
+                                  std::vector<ParamSummary> &summary, uint32 depth) {
+  switch (stmt.GetOpCode()) {
+    case OP_iassign:
+      VisitMIRBaseExpr(callee, *stmt.Opnd(0), kEscapeStoreBase, summary, depth);
+      VisitMIRExpr(callee, *stmt.Opnd(1), kEscapeUnsafe, summary, depth);
+      return;
+    case OP_brtrue:
+    case OP_brfalse:
+    case OP_syncenter:
+    case OP_syncexit:
+    case OP_assertnonnull:
+    case OP_eval:
+      for (size_t i = 0; i < stmt.NumOpnds(); ++i) {
+        VisitMIRExpr(callee, *stmt.Opnd(i), kEscapeCompare, summary, depth);
+      }
+      return;
+    case OP_call:
+    case OP_callassigned: {
+      PUIdx calleePUIdx = static_cast<const CallNode&>(stmt).GetPUIdx();
+      MIRFunction *calleeOfCallee = GlobalTables::GetFunctionTable().GetFunctionFromPuidx(calleePUIdx);
+      bool isRuntimeCheck = IsRuntimeCheckCall(*calleeOfCallee);
+      const std::vector<ParamSummary> &calleeSummary =
+          isRuntimeCheck ? kEscapingSummary : GetSummary(calleePUIdx, depth + 1);
+      for (size_t i = 0; i < stmt.NumOpnds(); ++i) {
+        EscapeContext context = kEscapeUnsafe;
+        if (isRuntimeCheck || (i < calleeSummary.size() && calleeSummary[i].readOnly)) {
+          context = kEscapeLoadBase;
+        } else if (i < calleeSummary.size() && calleeSummary[i].noEscape) {
+          context = kEscapeStoreBase;
+        }
+        VisitMIRExpr(callee, *stmt.Opnd(i), context, summary, depth);
+      }
+      return;
+    }
+    case OP_block:
+    case OP_if:
+    case OP_while:
+    case OP_dowhile:
+    case OP_doloop:
+      // structured control flow is not expected in lowered Java bodies, give up on it
+      summary.assign(summary.size(), ParamSummary{ false, false });
+      return;
+    default:
+      for (size_t i = 0; i < stmt.NumOpnds(); ++i) {
+        VisitMIRExpr(callee, *stmt.Opnd(i), kEscapeUnsafe, summary, depth);
+      }
+      return;
+  }
+}
+
+void EscapeAnalysis::Run() {
+  CollectSites();
+  if (siteEscapes.empty()) {
+    return;
+  }
+  PropagatePointsTo();
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    for (auto &stmt : (*bIt)->GetMeStmts()) {
+      VisitStmt(stmt);
+    }
+  }
+  MarkAddressTakenSites();
+  if (enabledDebug) {
+    size_t numNonEscaping = static_cast<size_t>(std::count(siteEscapes.begin(), siteEscapes.end(), false));
+    LogInfo::MapleLogger() << "escapeanalysis: " << numNonEscaping << " of " << siteEscapes.size() <<
+        " allocations do not escape in " << func.GetName() << '\n';
+  }
+}
+
+bool EscapeAnalysis::AllSitesNonEscaping(MeExpr &expr, std::set<const MeExpr*> &visited) const {
+  if (!visited.insert(&expr).second) {
+    return true;
+  }
+  auto siteIt = siteOfValue.find(&expr);
+  if (siteIt != siteOfValue.end()) {
+    return !siteEscapes[siteIt->second];
+  }
+  if (expr.GetMeOp() == kMeOpVar) {
+    auto &var = static_cast<VarMeExpr&>(expr);
+    if (var.GetDefBy() == kDefByPhi) {
+      for (VarMeExpr *opnd : var.GetDefPhi().GetOpnds()) {
+        if (!AllSitesNonEscaping(*opnd, visited)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    MeStmt *defStmt = var.GetDefBy() == kDefByStmt ? var.GetDefStmt() : nullptr;
+    MeExpr *source = (defStmt != nullptr && defStmt->GetOp() == OP_dassign) ? GetCopySource(*defStmt->GetRHS())
+                                                                             : nullptr;
+    return source != nullptr && AllSitesNonEscaping(*source, visited);
+  }
+  if (expr.GetMeOp() == kMeOpReg) {
+    auto &reg = static_cast<RegMeExpr&>(expr);
+    if (reg.GetDefBy() == kDefByPhi) {
+      for (RegMeExpr *opnd : reg.GetDefPhi().GetOpnds()) {
+        if (!AllSitesNonEscaping(*opnd, visited)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    MeStmt *defStmt = reg.GetDefBy() == kDefByStmt ? reg.GetDefStmt() : nullptr;
+    MeExpr *source = (defStmt != nullptr && defStmt->GetOp() == OP_regassign) ? GetCopySource(*defStmt->GetRHS())
+                                                                               : nullptr;
+    return source != nullptr && AllSitesNonEscaping(*source, visited);
+  }
+  return false;
+}
+
+// Every definition reaching expr must come from a non-escaping site, a value of unknown origin (a parameter,
+// a load, a call result) may be anything.
+bool EscapeAnalysis::IsNonEscaping(MeExpr &expr) const {
+  if (siteEscapes.empty() || !IsLocalValue(expr)) {
+    return false;
+  }
+  std::set<const MeExpr*> visited;
+  return AllSitesNonEscaping(expr, visited);
+}
+
+bool EscapeAnalysis::IsReadOnlyCallArg(const CallMeStmt &call, size_t i) {
+  const std::vector<ParamSummary> &summary = GetSummary(call.GetPUIdx(), 0);
+  return i < summary.size() && summary[i].readOnly;
+}
+
+AnalysisResult *MeDoEscapeAnalysis::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr*) {
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  MemPool *escapeMp = NewMemPool();
+  EscapeAnalysis *escapeAnalysis = escapeMp->New<EscapeAnalysis>(*escapeMp, *func, summaries, DEBUGFUNC(func));
+  escapeAnalysis->Run();
+  return escapeAnalysis;
+}
+}  // namespace maple
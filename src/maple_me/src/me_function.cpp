@@ -404,6 +404,8 @@ void MeFunction::Prepare(unsigned long rangeNum) {
   mirLowerer.Init();
   mirLowerer.SetLowerME();
   mirLowerer.SetLowerExpandArray();
+  // bce only runs at O2, there it removes the checks this expansion makes redundant
+  mirLowerer.SetOptArrayMrtAll(MeOption::optLevel >= MeOption::kLevelTwo);
   ASSERT(CurFunction() != nullptr, "nullptr check");
   mirLowerer.LowerFunc(*CurFunction());
   CreateBasicBlocks();
@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_iv_opt.h"
+
+// The new preg of a derived IV follows the versions of its basic IV: the phi at the head, and the next value
+// assigned right after the increment of the basic IV. Emit gives all versions one preg, so a use may only read the
+// phi value before the increment and the next value after it, within the same iteration; uses elsewhere, and uses
+// in handlers, are left alone.
+namespace maple {
+// limits keeping biv * scale + offset exact in i64
+static constexpr int64 kMaxScale = 0x7fffffff;
+static constexpr int64 kMaxShift32 = 30;
+static constexpr int64 kMaxShift64 = 62;
+
+bool IVOpt::IsInvariant(const LoopDesc &loop, MeExpr &expr) const {
+  BB *defBB = nullptr;
+  if (expr.GetMeOp() == kMeOpConst) {
+    return static_cast<ConstMeExpr&>(expr).GetConstVal()->GetKind() == kConstInt;
+  } else if (expr.GetMeOp() == kMeOpVar) {
+    if (expr.IsVolatile(ssaTab)) {
+      return false;
+    }
+    defBB = static_cast<VarMeExpr&>(expr).DefByBB();
+  } else if (expr.GetMeOp() == kMeOpReg) {
+    defBB = static_cast<RegMeExpr&>(expr).DefByBB();
+  } else {
+    return false;
+  }
+  return defBB == nullptr || !loop.Has(*defBB);
+}
+
+bool IVOpt::GetIntConst(MeExpr &expr, int64 &value) const {
+  if (expr.GetMeOp() != kMeOpConst) {
+    return false;
+  }
+  MIRConst *constVal = static_cast<ConstMeExpr&>(expr).GetConstVal();
+  if (constVal->GetKind() != kConstInt) {
+    return false;
+  }
+  value = static_cast<MIRIntConst*>(constVal)->GetValue();
+  return true;
+}
+
+// rhs is phiValue plus or minus a constant
+bool IVOpt::GetStep(MeExpr &rhs, const MeExpr &phiValue, int64 &step) const {
+  if (rhs.GetOp() == OP_add) {
+    if (rhs.GetOpnd(0) == &phiValue && GetIntConst(*rhs.GetOpnd(1), step)) {
+      return step != 0;
+    }
+    if (rhs.GetOpnd(1) == &phiValue && GetIntConst(*rhs.GetOpnd(0), step)) {
+      return step != 0;
+    }
+  } else if (rhs.GetOp() == OP_sub && rhs.GetOpnd(0) == &phiValue && GetIntConst(*rhs.GetOpnd(1), step)) {
+    step = -step;
+    return step != 0;
+  }
+  return false;
+}
+
+MeStmt *IVOpt::GetDefStmt(MeExpr &value) const {
+  if (value.GetMeOp() == kMeOpVar) {
+    auto &var = static_cast<VarMeExpr&>(value);
+    return var.GetDefBy() == kDefByStmt ? var.GetDefStmt() : nullptr;
+  }
+  if (value.GetMeOp() == kMeOpReg) {
+    auto &reg = static_cast<RegMeExpr&>(value);
+    return reg.GetDefBy() == kDefByStmt ? reg.GetDefStmt() : nullptr;
+  }
+  return nullptr;
+}
+
+void IVOpt::AddBasicIV(const LoopDesc &loop, MeExpr &phiValue, MeExpr &init, MeExpr &next) {
+  PrimType primType = phiValue.GetPrimType();
+  if (primType != PTY_i32 && primType != PTY_i64) {
+    return;
+  }
+  MeStmt *incStmt = GetDefStmt(next);
+  if (incStmt == nullptr || (incStmt->GetOp() != OP_dassign && incStmt->GetOp() != OP_regassign) ||
+      !loop.Has(*incStmt->GetBB()) || incStmt->GetBB()->GetAttributes(kBBAttrIsCatch)) {
+    return;
+  }
+  int64 step = 0;
+  if (!GetStep(*incStmt->GetRHS(), phiValue, step) || step > kMaxScale || step < -kMaxScale) {
+    return;
+  }
+  BasicIV biv = { &phiValue, &next, &init, incStmt, step };
+  basicIVs.push_back(biv);
+}
+
+void IVOpt::FindBasicIVs(const LoopDesc &loop) {
+  basicIVs.clear();
+  for (auto &phiPair : loop.head->GetMevarPhiList()) {
+    MeVarPhiNode *phi = phiPair.second;
+    const OriginalSt *ost = ssaTab.GetOriginalStFromID(phiPair.first);
+    if (ost == nullptr || !ost->IsLocal() || ost->IsVolatile()) {
+      continue;
+    }
+    AddBasicIV(loop, *phi->GetLHS(), *phi->GetOpnd(preheaderIdx), *phi->GetOpnd(latchIdx));
+  }
+  for (auto &phiPair : loop.head->GetMeregphiList()) {
+    MeRegPhiNode *phi = phiPair.second;
+    if (phi->GetLHS()->GetRegIdx() < 0) {
+      continue;
+    }
+    AddBasicIV(loop, *phi->GetLHS(), *phi->GetOpnd(preheaderIdx), *phi->GetOpnd(latchIdx));
+  }
+}
+
+// expr is biv * scale, as a mul or shl by a constant of a value of a basic IV
+bool IVOpt::MatchScaled(MeExpr &expr, BasicIV *&biv, bool &isNext, int64 &scale) {
+  if (expr.GetOp() != OP_mul && expr.GetOp() != OP_shl) {
+    return false;
+  }
+  MeExpr *value = expr.GetOpnd(0);
+  int64 constVal = 0;
+  if (!GetIntConst(*expr.GetOpnd(1), constVal)) {
+    if (expr.GetOp() != OP_mul || !GetIntConst(*expr.GetOpnd(0), constVal)) {
+      return false;
+    }
+    value = expr.GetOpnd(1);
+  }
+  if (expr.GetOp() == OP_shl) {
+    int64 maxShift = expr.GetPrimType() == PTY_i64 ? kMaxShift64 : kMaxShift32;
+    if (constVal < 1 || constVal > maxShift) {
+      return false;
+    }
+    scale = static_cast<int64>(1) << constVal;
+  } else {
+    scale = constVal;
+  }
+  if (scale == 0 || scale > kMaxScale || scale < -kMaxScale) {
+    return false;
+  }
+  for (BasicIV &candidate : basicIVs) {
+    if ((value == candidate.phiValue || value == candidate.nextValue) &&
+        expr.GetPrimType() == candidate.phiValue->GetPrimType()) {
+      biv = &candidate;
+      isNext = value == candidate.nextValue;
+      return true;
+    }
+  }
+  return false;
+}
+
+// expr is biv * scale + offset, offset is returned as an i64 value
+bool IVOpt::MatchDerived(const LoopDesc &loop, MeExpr &expr, BasicIV *&biv, bool &isNext, int64 &scale,
+                         MeExpr *&offset) {
+  offset = nullptr;
+  if (MatchScaled(expr, biv, isNext, scale)) {
+    return true;
+  }
+  if (expr.GetOp() == OP_add) {
+    for (size_t i = 0; i < kOperandNumBinary; ++i) {
+      MeExpr *addend = expr.GetOpnd(1 - i);
+      if (MatchScaled(*expr.GetOpnd(i), biv, isNext, scale) && addend->GetPrimType() == expr.GetPrimType() &&
+          IsInvariant(loop, *addend)) {
+        offset = ToI64(*addend);
+        return true;
+      }
+    }
+    return false;
+  }
+  int64 constVal = 0;
+  if (expr.GetOp() == OP_sub && MatchScaled(*expr.GetOpnd(0), biv, isNext, scale) &&
+      GetIntConst(*expr.GetOpnd(1), constVal) && constVal > -kMaxScale && constVal < kMaxScale) {
+    offset = irMap.CreateIntConstMeExpr(-constVal, PTY_i64);
+    return true;
+  }
+  return false;
+}
+
+// the phi value of biv is current at stmt
+bool IVOpt::IsBeforeInc(const BasicIV &biv, MeStmt &stmt) {
+  BB *incBB = biv.incStmt->GetBB();
+  if (stmt.GetBB() != incBB) {
+    return !dom.Dominate(*incBB, *stmt.GetBB());
+  }
+  for (MeStmt *next = &stmt; next != nullptr; next = next->GetNext()) {
+    if (next == biv.incStmt) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// the next value of biv is current at stmt
+bool IVOpt::IsAfterInc(const BasicIV &biv, MeStmt &stmt) {
+  BB *incBB = biv.incStmt->GetBB();
+  if (stmt.GetBB() != incBB) {
+    return dom.Dominate(*incBB, *stmt.GetBB());
+  }
+  for (MeStmt *next = biv.incStmt->GetNext(); next != nullptr; next = next->GetNext()) {
+    if (next == &stmt) {
+      return true;
+    }
+  }
+  return false;
+}
+
+MeExpr *IVOpt::ToI64(MeExpr &expr) {
+  return expr.GetPrimType() == PTY_i64 ? &expr : irMap.CreateMeExprTypeCvt(PTY_i64, expr.GetPrimType(), expr);
+}
+
+// evaluates expr once at the end of the preheader
+RegMeExpr *IVOpt::Materialize(const LoopDesc &loop, MeExpr &expr) {
+  RegMeExpr *reg = irMap.CreateRegMeExpr(expr.GetPrimType());
+  loop.preheader->InsertMeStmtLastBr(irMap.CreateRegassignMeStmt(*reg, expr, *loop.preheader));
+  return reg;
+}
+
+IVOpt::DerivedIV &IVOpt::GetDerivedIV(const LoopDesc &loop, BasicIV &biv, int64 scale, MeExpr *offset) {
+  for (DerivedIV &derived : derivedIVs) {
+    if (derived.biv == &biv && derived.scale == scale && derived.offset == offset) {
+      return derived;
+    }
+  }
+  MeExpr *initValue = irMap.CreateMeExprBinary(OP_mul, PTY_i64, *ToI64(*biv.init),
+                                               *irMap.CreateIntConstMeExpr(scale, PTY_i64));
+  if (offset != nullptr) {
+    initValue = irMap.CreateMeExprBinary(OP_add, PTY_i64, *initValue, *offset);
+  }
+  RegMeExpr *initReg = Materialize(loop, *initValue);
+  RegMeExpr *phiReg = irMap.CreateRegMeExprVersion(*initReg);
+  RegMeExpr *nextReg = irMap.CreateRegMeExprVersion(*initReg);
+  MeExpr *nextValue = irMap.CreateMeExprBinary(OP_add, PTY_i64, *phiReg,
+                                               *irMap.CreateIntConstMeExpr(biv.step * scale, PTY_i64));
+  BB *incBB = biv.incStmt->GetBB();
+  incBB->InsertMeStmtAfter(biv.incStmt, irMap.CreateRegassignMeStmt(*nextReg, *nextValue, *incBB));
+  MeRegPhiNode *phi = irMap.CreateMeRegPhi(*phiReg);
+  phi->SetDefBB(loop.head);
+  for (size_t i = 0; i < loop.head->GetPred().size(); ++i) {
+    RegMeExpr *opnd = static_cast<int32>(i) == preheaderIdx ? initReg : nextReg;
+    phi->GetOpnds().push_back(opnd);
+    (void)opnd->GetPhiUseSet().insert(phi);
+  }
+  (void)loop.head->GetMeregphiList().insert(std::make_pair(phiReg->GetOstIdx(), phi));
+  DerivedIV derived = { &biv, scale, offset, phiReg, nextReg };
+  derivedIVs.push_back(derived);
+  return derivedIVs.back();
+}
+
+void IVOpt::CollectDerived(const LoopDesc &loop, MeExpr &expr, std::vector<MeExpr*> &exprs) {
+  BasicIV *biv = nullptr;
+  bool isNext = false;
+  int64 scale = 0;
+  MeExpr *offset = nullptr;
+  if (MatchDerived(loop, expr, biv, isNext, scale, offset)) {
+    exprs.push_back(&expr);
+    return;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    MeExpr *opnd = expr.GetOpnd(i);
+    if (opnd != nullptr) {
+      CollectDerived(loop, *opnd, exprs);
+    }
+  }
+}
+
+void IVOpt::ReduceInStmt(const LoopDesc &loop, MeStmt &stmt) {
+  std::vector<MeExpr*> exprs;
+  for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+    MeExpr *opnd = stmt.GetOpnd(i);
+    if (opnd != nullptr) {
+      CollectDerived(loop, *opnd, exprs);
+    }
+  }
+  for (MeExpr *expr : exprs) {
+    BasicIV *biv = nullptr;
+    bool isNext = false;
+    int64 scale = 0;
+    MeExpr *offset = nullptr;
+    (void)MatchDerived(loop, *expr, biv, isNext, scale, offset);
+    if (isNext ? !IsAfterInc(*biv, stmt) : !IsBeforeInc(*biv, stmt)) {
+      continue;
+    }
+    DerivedIV &derived = GetDerivedIV(loop, *biv, scale, offset);
+    MeExpr *value = isNext ? derived.nextReg : derived.phiReg;
+    if (expr->GetPrimType() != PTY_i64) {
+      value = irMap.CreateMeExprTypeCvt(expr->GetPrimType(), PTY_i64, *value);
+    }
+    if (irMap.ReplaceMeExprStmt(stmt, *expr, *value)) {
+      ++numReducedExprs;
+      if (enabledDebug) {
+        LogInfo::MapleLogger() << "ivopt: reduce in BB " << stmt.GetBB()->GetBBId() << ": ";
+        expr->Dump(&irMap);
+        LogInfo::MapleLogger() << '\n';
+      }
+    }
+  }
+}
+
+// An exit test biv < limit, run on every iteration and leaving the loop when false, is replaced by a test of a
+// derived IV with a positive scale. Stepping by 1, the basic IV never passes the limit, so it never wraps around
+// and matches the exact i64 value of the derived IV; a test of the next value additionally needs the initial value
+// to be below the maximum.
+void IVOpt::ReplaceTest(const LoopDesc &loop, BB &bb) {
+  if (bb.GetKind() != kBBCondGoto || bb.GetAttributes(kBBAttrIsCatch) || bb.IsMeStmtEmpty() ||
+      !dom.Dominate(bb, *loop.latches.front())) {
+    return;
+  }
+  MeStmt *brStmt = to_ptr(bb.GetMeStmts().rbegin());
+  MeExpr *cond = brStmt->IsCondBr() ? brStmt->GetOpnd(0) : nullptr;
+  if (cond == nullptr || cond->GetMeOp() != kMeOpOp || (cond->GetOp() != OP_lt && cond->GetOp() != OP_gt) ||
+      static_cast<OpMeExpr*>(cond)->GetOpndType() != PTY_i32) {
+    return;
+  }
+  bool stayOnTrue = brStmt->GetOp() == OP_brtrue;
+  if (!loop.Has(*bb.GetSucc(stayOnTrue ? 1 : 0)) || loop.Has(*bb.GetSucc(stayOnTrue ? 0 : 1))) {
+    return;
+  }
+  MeExpr *ivValue = cond->GetOp() == OP_lt ? cond->GetOpnd(0) : cond->GetOpnd(1);
+  MeExpr *limit = cond->GetOp() == OP_lt ? cond->GetOpnd(1) : cond->GetOpnd(0);
+  if (limit->GetPrimType() != PTY_i32 || !IsInvariant(loop, *limit)) {
+    return;
+  }
+  for (DerivedIV &derived : derivedIVs) {
+    BasicIV &biv = *derived.biv;
+    if ((ivValue != biv.phiValue && ivValue != biv.nextValue) || biv.phiValue->GetPrimType() != PTY_i32 ||
+        biv.step != 1 || derived.scale <= 0) {
+      continue;
+    }
+    bool isNext = ivValue == biv.nextValue;
+    int64 initVal = 0;
+    if (isNext && (!GetIntConst(*biv.init, initVal) || initVal >= INT32_MAX)) {
+      return;
+    }
+    if (isNext ? !IsAfterInc(biv, *brStmt) : !IsBeforeInc(biv, *brStmt)) {
+      return;
+    }
+    MeExpr *scaledLimit = irMap.CreateMeExprBinary(OP_mul, PTY_i64, *ToI64(*limit),
+                                                   *irMap.CreateIntConstMeExpr(derived.scale, PTY_i64));
+    if (derived.offset != nullptr) {
+      scaledLimit = irMap.CreateMeExprBinary(OP_add, PTY_i64, *scaledLimit, *derived.offset);
+    }
+    RegMeExpr *limitReg = Materialize(loop, *scaledLimit);
+    RegMeExpr *ivReg = isNext ? derived.nextReg : derived.phiReg;
+    MeExpr *newCond = cond->GetOp() == OP_lt
+                          ? irMap.CreateMeExprCompare(OP_lt, cond->GetPrimType(), PTY_i64, *ivReg, *limitReg)
+                          : irMap.CreateMeExprCompare(OP_gt, cond->GetPrimType(), PTY_i64, *limitReg, *ivReg);
+    if (irMap.ReplaceMeExprStmt(*brStmt, *cond, *newCond)) {
+      ++numReplacedTests;
+      if (enabledDebug) {
+        LogInfo::MapleLogger() << "ivopt: replace exit test in BB " << bb.GetBBId() << '\n';
+      }
+    }
+    return;
+  }
+}
+
+void IVOpt::OptimizeLoop(const LoopDesc &loop) {
+  BB *head = loop.head;
+  if (loop.preheader == nullptr || loop.latches.size() != 1 || head->GetPred().size() != 2) {
+    return;
+  }
+  preheaderIdx = head->GetPred(0) == loop.preheader ? 0 : 1;
+  latchIdx = 1 - preheaderIdx;
+  if (head->GetPred(latchIdx) != loop.latches.front()) {
+    return;
+  }
+  FindBasicIVs(loop);
+  if (basicIVs.empty()) {
+    return;
+  }
+  derivedIVs.clear();
+  for (BBId bbID : loop.loopBBs) {
+    BB *bb = func.GetBBFromID(bbID);
+    if (bb == nullptr || bb->GetAttributes(kBBAttrIsCatch)) {
+      continue;
+    }
+    for (auto &stmt : bb->GetMeStmts()) {
+      ReduceInStmt(loop, stmt);
+    }
+  }
+  for (BBId bbID : loop.loopBBs) {
+    BB *bb = func.GetBBFromID(bbID);
+    if (bb != nullptr) {
+      ReplaceTest(loop, *bb);
+    }
+  }
+}
+
+void IVOpt::Run() {
+  const MapleVector<LoopDesc*> &loops = identLoops.GetMeLoops();
+  for (auto it = loops.rbegin(); it != loops.rend(); ++it) {
+    OptimizeLoop(**it);
+  }
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "ivopt: " << func.GetName() << ": " << numReducedExprs << " expressions reduced, "
+                           << numReplacedTests << " exit tests replaced\n";
+  }
+}
+
+AnalysisResult *MeDoIVOpt::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr*) {
+  auto *dom = static_cast<Dominance*>(funcResMgr->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_FATAL(dom != nullptr, "dominance phase has problem");
+  auto *identLoops = static_cast<IdentifyLoops*>(funcResMgr->GetAnalysisResult(MeFuncPhase_MELOOP, func));
+  CHECK_FATAL(identLoops != nullptr, "meloop phase has problem");
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  IVOpt ivOpt(*func, *dom, *identLoops, DEBUGFUNC(func));
+  ivOpt.Run();
+  return nullptr;
+}
+}  // namespace maple
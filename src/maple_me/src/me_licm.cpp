@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_licm.h"
+#include "me_option.h"
+
+// Natural loops are processed innermost first, so an expression hoisted into the preheader of an inner loop can be
+// hoisted again by the enclosing loop. The preheader ends with a goto or falls into the head, and the definitions of
+// the operands of an invariant expression dominate it, so the new register assignment dominates all its uses.
+namespace maple {
+static bool IsPureOp(Opcode op) {
+  switch (op) {
+    case OP_add:
+    case OP_sub:
+    case OP_mul:
+    case OP_band:
+    case OP_bior:
+    case OP_bxor:
+    case OP_shl:
+    case OP_lshr:
+    case OP_ashr:
+    case OP_neg:
+    case OP_bnot:
+    case OP_lnot:
+    case OP_abs:
+    case OP_max:
+    case OP_min:
+    case OP_cvt:
+    case OP_retype:
+    case OP_sext:
+    case OP_zext:
+    case OP_extractbits:
+    case OP_cmp:
+    case OP_cmpl:
+    case OP_cmpg:
+    case OP_eq:
+    case OP_ne:
+    case OP_lt:
+    case OP_le:
+    case OP_gt:
+    case OP_ge:
+    case OP_select:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool LICM::IsDefinedOutside(const LoopDesc &loop, MeExpr &expr) const {
+  BB *defBB = nullptr;
+  if (expr.GetMeOp() == kMeOpVar) {
+    defBB = static_cast<VarMeExpr&>(expr).DefByBB();
+  } else if (expr.GetMeOp() == kMeOpReg) {
+    defBB = static_cast<RegMeExpr&>(expr).DefByBB();
+  } else {
+    return false;
+  }
+  // values without definition come from the function entry
+  return defBB == nullptr || !loop.Has(*defBB);
+}
+
+// this of an instance method, or a newly allocated object
+bool LICM::IsNonNull(MeExpr &expr) const {
+  MeStmt *defStmt = nullptr;
+  if (expr.GetMeOp() == kMeOpVar) {
+    auto &var = static_cast<VarMeExpr&>(expr);
+    MIRFunction *mirFunc = func.GetMirFunc();
+    if (var.GetDefBy() == kDefByNo && !mirFunc->IsStatic() && mirFunc->GetFormalCount() > 0 &&
+        ssaTab.GetMIRSymbolFromID(var.GetOStIdx()) == mirFunc->GetFormal(0)) {
+      return true;
+    }
+    defStmt = var.GetDefBy() == kDefByStmt ? var.GetDefStmt() : nullptr;
+  } else if (expr.GetMeOp() == kMeOpReg) {
+    auto &reg = static_cast<RegMeExpr&>(expr);
+    defStmt = reg.GetDefBy() == kDefByStmt ? reg.GetDefStmt() : nullptr;
+  }
+  if (defStmt == nullptr || defStmt->GetRHS() == nullptr) {
+    return false;
+  }
+  MeExpr *rhs = defStmt->GetRHS();
+  return rhs->GetMeOp() == kMeOpGcmalloc || rhs->GetOp() == OP_gcmallocjarray || rhs->GetOp() == OP_gcpermallocjarray;
+}
+
+bool LICM::MayThrow(MeExpr &expr) const {
+  if (expr.GetMeOp() == kMeOpIvar) {
+    MeExpr *base = static_cast<IvarMeExpr&>(expr).GetBase();
+    return !IsNonNull(*base) || MayThrow(*base);
+  }
+  if (expr.GetOp() == OP_intrinsicop && static_cast<NaryMeExpr&>(expr).GetIntrinsic() == INTRN_JAVA_ARRAY_LENGTH) {
+    MeExpr *array = expr.GetOpnd(0);
+    return !IsNonNull(*array) || MayThrow(*array);
+  }
+  if (kOpcodeInfo.MayThrowException(expr.GetOp())) {
+    return true;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    if (MayThrow(*expr.GetOpnd(i))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool LICM::IsInvariant(const LoopDesc &loop, MeExpr &expr) {
+  auto it = invariants.find(&expr);
+  if (it != invariants.end()) {
+    return it->second;
+  }
+  bool invariant = false;
+  switch (expr.GetMeOp()) {
+    case kMeOpVar:
+      invariant = !expr.IsVolatile(ssaTab) && IsDefinedOutside(loop, expr);
+      break;
+    case kMeOpReg:
+      invariant = IsDefinedOutside(loop, expr);
+      break;
+    case kMeOpConst:
+    case kMeOpConststr:
+    case kMeOpConststr16:
+    case kMeOpAddrof:
+    case kMeOpAddroffunc:
+    case kMeOpSizeoftype:
+    case kMeOpFieldsDist:
+      invariant = true;
+      break;
+    case kMeOpIvar: {
+      auto &ivar = static_cast<IvarMeExpr&>(expr);
+      VarMeExpr *mu = ivar.GetMu();
+      bool memoryInvariant = (mu != nullptr && IsDefinedOutside(loop, *mu)) ||
+                             (ivar.IsFinal() && !func.GetMirFunc()->IsConstructor());
+      invariant = !ivar.IsVolatile() && memoryInvariant && IsInvariant(loop, *ivar.GetBase());
+      break;
+    }
+    case kMeOpNary: {
+      // array lengths never change
+      auto &nary = static_cast<NaryMeExpr&>(expr);
+      invariant = nary.GetOp() == OP_intrinsicop && nary.GetIntrinsic() == INTRN_JAVA_ARRAY_LENGTH &&
+                  IsInvariant(loop, *nary.GetOpnd(0));
+      break;
+    }
+    case kMeOpOp: {
+      invariant = IsPureOp(expr.GetOp());
+      for (size_t i = 0; invariant && i < expr.GetNumOpnds(); ++i) {
+        invariant = IsInvariant(loop, *expr.GetOpnd(i));
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  invariants[&expr] = invariant;
+  return invariant;
+}
+
+// scalars only: hoisted references and addresses would have to be tracked by RC lowering and the collector
+bool LICM::IsHoistable(const LoopDesc &loop, MeExpr &expr, bool canThrowFirst) {
+  MeExprOp meOp = expr.GetMeOp();
+  if (meOp != kMeOpOp && meOp != kMeOpNary && meOp != kMeOpIvar) {
+    return false;
+  }
+  PrimType primType = expr.GetPrimType();
+  if ((!IsPrimitivePureScalar(primType) && !IsPrimitiveFloat(primType)) || GetPrimTypeSize(primType) < 4) {
+    return false;
+  }
+  if (meOp == kMeOpOp) {
+    bool allConst = true;
+    for (size_t i = 0; allConst && i < expr.GetNumOpnds(); ++i) {
+      allConst = expr.GetOpnd(i)->GetMeOp() == kMeOpConst;
+    }
+    if (allConst) {
+      return false;
+    }
+  }
+  if (!IsInvariant(loop, expr)) {
+    return false;
+  }
+  return !MayThrow(expr) || (canThrowFirst && canHoistThrowing);
+}
+
+// Operands are visited in evaluation order. canThrowFirst holds until the first expression that may throw: that one
+// can still be hoisted, as nothing before it in the loop may throw, but any later one would then raise its exception
+// ahead of one staying in the loop.
+void LICM::CollectHoistable(const LoopDesc &loop, MeExpr &expr, bool &canThrowFirst, std::vector<MeExpr*> &exprs) {
+  if (IsHoistable(loop, expr, canThrowFirst)) {
+    exprs.push_back(&expr);
+    if (MayThrow(expr)) {
+      canThrowFirst = false;
+    }
+    return;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    MeExpr *opnd = expr.GetOpnd(i);
+    if (opnd != nullptr) {
+      CollectHoistable(loop, *opnd, canThrowFirst, exprs);
+    }
+  }
+  if (MayThrow(expr)) {
+    canThrowFirst = false;
+  }
+}
+
+RegMeExpr *LICM::Hoist(const LoopDesc &loop, MeExpr &expr) {
+  auto it = hoistedRegs.find(&expr);
+  if (it != hoistedRegs.end()) {
+    return it->second;
+  }
+  RegMeExpr *reg = irMap.CreateRegMeExpr(expr.GetPrimType());
+  RegassignMeStmt *regAssign = irMap.CreateRegassignMeStmt(*reg, expr, *loop.preheader);
+  loop.preheader->InsertMeStmtLastBr(regAssign);
+  hoistedRegs[&expr] = reg;
+  ++numHoisted;
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "licm: hoist to BB " << loop.preheader->GetBBId() << ": ";
+    expr.Dump(&irMap);
+    LogInfo::MapleLogger() << '\n';
+  }
+  return reg;
+}
+
+void LICM::HoistInBB(const LoopDesc &loop, BB &bb) {
+  // only the first statement of the head is sure to run as soon as the loop is entered
+  bool canThrowFirst = &bb == loop.head;
+  for (auto &stmt : bb.GetMeStmts()) {
+    std::vector<MeExpr*> exprs;
+    for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+      MeExpr *opnd = stmt.GetOpnd(i);
+      if (opnd != nullptr) {
+        CollectHoistable(loop, *opnd, canThrowFirst, exprs);
+      }
+    }
+    for (MeExpr *expr : exprs) {
+      (void)irMap.ReplaceMeExprStmt(stmt, *expr, *Hoist(loop, *expr));
+    }
+    canThrowFirst = false;
+  }
+}
+
+void LICM::HoistInLoop(const LoopDesc &loop) {
+  if (loop.preheader == nullptr) {
+    return;
+  }
+  invariants.clear();
+  hoistedRegs.clear();
+  // an exception thrown by the preheader must reach the handler the head would have reached
+  bool headInTry = loop.head->GetAttributes(kBBAttrIsTry);
+  bool preheaderInTry = loop.preheader->GetAttributes(kBBAttrIsTry);
+  canHoistThrowing = headInTry == preheaderInTry && (!headInTry || func.PrevBB(loop.head) == loop.preheader);
+  HoistInBB(loop, *loop.head);
+  for (BBId bbID : loop.loopBBs) {
+    BB *bb = func.GetBBFromID(bbID);
+    if (bb != nullptr && bb != loop.head) {
+      HoistInBB(loop, *bb);
+    }
+  }
+}
+
+void LICM::Run() {
+  const MapleVector<LoopDesc*> &loops = identLoops.GetMeLoops();
+  for (auto it = loops.rbegin(); it != loops.rend(); ++it) {
+    HoistInLoop(**it);
+  }
+  if (enabledDebug && numHoisted != 0) {
+    LogInfo::MapleLogger() << "licm: " << func.GetName() << ": " << numHoisted << " expressions hoisted\n";
+  }
+}
+
+AnalysisResult *MeDoLICM::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr*) {
+  auto *identLoops = static_cast<IdentifyLoops*>(funcResMgr->GetAnalysisResult(MeFuncPhase_MELOOP, func));
+  CHECK_FATAL(identLoops != nullptr, "meloop phase has problem");
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  LICM licm(*func, *identLoops, DEBUGFUNC(func));
+  licm.Run();
+  return nullptr;
+}
+}  // namespace maple
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_lock_elision.h"
+
+// Nested operations are elided only when every monitor operation of the function works on the same value, as a
+// copy or another load of the object would change the lock depth unseen. With the depth known exactly before every
+// operation, dropping the enters at depth >= 1 and the exits at depth >= 2 keeps the monitor held exactly where it
+// was. Blocks in a try region pass to their handlers the depth at every statement, which must agree.
+namespace maple {
+static constexpr int32 kDepthUnset = -1;
+static constexpr int32 kDepthConflict = -2;
+// blocks followed from a syncexit to the next syncenter
+static constexpr uint32 kMaxMergeBBs = 4;
+
+static int32 JoinDepth(int32 depth1, int32 depth2) {
+  if (depth1 == kDepthUnset) {
+    return depth2;
+  }
+  if (depth2 == kDepthUnset) {
+    return depth1;
+  }
+  return depth1 == depth2 ? depth1 : kDepthConflict;
+}
+
+// the monitor operand of a sync statement, through local copies
+MeExpr *LockElision::GetMonitor(const MeStmt &stmt) const {
+  MeExpr *value = stmt.GetOpnd(0);
+  while (true) {
+    MeStmt *defStmt = nullptr;
+    if (value->GetMeOp() == kMeOpVar && static_cast<VarMeExpr*>(value)->GetDefBy() == kDefByStmt) {
+      defStmt = static_cast<VarMeExpr*>(value)->GetDefStmt();
+    } else if (value->GetMeOp() == kMeOpReg && static_cast<RegMeExpr*>(value)->GetDefBy() == kDefByStmt) {
+      defStmt = static_cast<RegMeExpr*>(value)->GetDefStmt();
+    }
+    if (defStmt == nullptr || (defStmt->GetOp() != OP_dassign && defStmt->GetOp() != OP_regassign) ||
+        (defStmt->GetRHS()->GetMeOp() != kMeOpVar && defStmt->GetRHS()->GetMeOp() != kMeOpReg)) {
+      return value;
+    }
+    value = defStmt->GetRHS();
+  }
+}
+
+int32 LockElision::Step(const MeStmt &stmt, int32 depth) const {
+  if (depth < 0 || !IsSync(stmt) || GetMonitor(stmt) != monitor) {
+    return depth;
+  }
+  if (stmt.GetOp() == OP_syncenter) {
+    return depth + 1;
+  }
+  return depth == 0 ? kDepthConflict : depth - 1;
+}
+
+// cannot throw nor touch a monitor
+bool LockElision::IsSafeExpr(const MeExpr &expr) const {
+  switch (expr.GetMeOp()) {
+    case kMeOpVar:
+    case kMeOpReg:
+    case kMeOpConst:
+    case kMeOpConststr:
+    case kMeOpConststr16:
+    case kMeOpAddrof:
+    case kMeOpSizeoftype:
+      return true;
+    case kMeOpOp:
+      if (expr.GetOp() == OP_div || expr.GetOp() == OP_rem || expr.IsGcmalloc() ||
+          expr.GetOp() == OP_resolveinterfacefunc || expr.GetOp() == OP_resolvevirtualfunc) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    if (!IsSafeExpr(*expr.GetOpnd(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool LockElision::IsSafeStmt(const MeStmt &stmt) const {
+  switch (stmt.GetOp()) {
+    case OP_comment:
+    case OP_goto:
+      return true;
+    case OP_regassign:
+      return IsSafeExpr(*stmt.GetRHS());
+    case OP_dassign: {
+      const OriginalSt *ost = func.GetMeSSATab()->GetOriginalStFromID(stmt.GetVarLHS()->GetOStIdx());
+      return ost != nullptr && ost->IsLocal() && !ost->IsVolatile() && IsSafeExpr(*stmt.GetRHS());
+    }
+    default:
+      return false;
+  }
+}
+
+void LockElision::RemoveSync(BB &bb, MeStmt &stmt, const char *reason) {
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "lockelision: remove " << kOpcodeInfo.GetTableItemAt(stmt.GetOp()).name << " in BB "
+                           << bb.GetBBId() << ", " << reason << '\n';
+  }
+  // the chi defs go away with the stmt, see the invariant in me_lock_elision.h
+  bb.RemoveMeStmt(&stmt);
+  ++numRemovedSyncs;
+}
+
+void LockElision::RemoveNonEscaping() {
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB &bb = **bIt;
+    MeStmt *nextStmt = nullptr;
+    for (MeStmt *stmt = to_ptr(bb.GetMeStmts().begin()); stmt != nullptr; stmt = nextStmt) {
+      nextStmt = stmt->GetNext();
+      if (IsSync(*stmt) && escapeAnalysis.IsNonEscaping(*stmt->GetOpnd(0))) {
+        RemoveSync(bb, *stmt, "non-escaping monitor");
+      }
+    }
+  }
+}
+
+void LockElision::ComputeDepths(std::vector<int32> &inDepths) const {
+  inDepths.assign(func.NumBBs(), kDepthUnset);
+  BB *entry = func.GetCommonEntryBB();
+  inDepths[entry->GetBBId()] = 0;
+  std::list<BB*> workList = { entry };
+  while (!workList.empty()) {
+    BB *bb = workList.front();
+    workList.pop_front();
+    int32 depth = inDepths[bb->GetBBId()];
+    int32 handlerDepth = depth;
+    for (auto &stmt : bb->GetMeStmts()) {
+      depth = Step(stmt, depth);
+      handlerDepth = JoinDepth(handlerDepth, depth);
+    }
+    for (BB *succ : bb->GetSucc()) {
+      bool isHandlerEdge = bb->GetAttributes(kBBAttrIsTry) && succ->GetAttributes(kBBAttrIsCatch);
+      int32 newDepth = JoinDepth(inDepths[succ->GetBBId()], isHandlerEdge ? handlerDepth : depth);
+      if (newDepth != inDepths[succ->GetBBId()]) {
+        inDepths[succ->GetBBId()] = newDepth;
+        workList.push_back(succ);
+      }
+    }
+  }
+}
+
+void LockElision::RemoveNested() {
+  std::vector<std::pair<BB*, MeStmt*>> syncs;
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    for (auto &stmt : (*bIt)->GetMeStmts()) {
+      if (!IsSync(stmt)) {
+        continue;
+      }
+      MeExpr *stmtMonitor = GetMonitor(stmt);
+      if (monitor != nullptr && stmtMonitor != monitor) {
+        return;
+      }
+      monitor = stmtMonitor;
+      syncs.push_back(std::make_pair(*bIt, &stmt));
+    }
+  }
+  if (syncs.empty()) {
+    return;
+  }
+  std::vector<int32> inDepths;
+  ComputeDepths(inDepths);
+  std::vector<std::pair<BB*, MeStmt*>> nestedSyncs;
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    int32 depth = inDepths[(*bIt)->GetBBId()];
+    for (auto &stmt : (*bIt)->GetMeStmts()) {
+      if (IsSync(stmt)) {
+        if (depth < 0) {
+          return;
+        }
+        if (depth >= (stmt.GetOp() == OP_syncenter ? 1 : 2)) {
+          nestedSyncs.push_back(std::make_pair(*bIt, &stmt));
+        }
+      }
+      depth = Step(stmt, depth);
+    }
+  }
+  for (auto &syncPair : nestedSyncs) {
+    RemoveSync(*syncPair.first, *syncPair.second, "nested");
+  }
+}
+
+// the syncenter of the same monitor reached from exit through statements that cannot throw, nullptr if none
+MeStmt *LockElision::FindAdjacentEnter(MeStmt &exit) const {
+  MeExpr *exitMonitor = GetMonitor(exit);
+  BB *bb = exit.GetBB();
+  MeStmt *stmt = exit.GetNext();
+  for (uint32 numBBs = 0; numBBs < kMaxMergeBBs;) {
+    for (; stmt != nullptr; stmt = stmt->GetNext()) {
+      if (stmt->GetOp() == OP_syncenter && GetMonitor(*stmt) == exitMonitor) {
+        return stmt;
+      }
+      if (!IsSafeStmt(*stmt)) {
+        return nullptr;
+      }
+    }
+    // continue into the only normal successor if it has no other predecessor
+    BB *next = nullptr;
+    for (BB *succ : bb->GetSucc()) {
+      if (succ->GetAttributes(kBBAttrIsCatch)) {
+        continue;
+      }
+      if (next != nullptr) {
+        return nullptr;
+      }
+      next = succ;
+    }
+    if (next == nullptr || next == bb || next->GetPred().size() != 1) {
+      return nullptr;
+    }
+    bb = next;
+    stmt = to_ptr(bb->GetMeStmts().begin());
+    ++numBBs;
+  }
+  return nullptr;
+}
+
+void LockElision::MergeAdjacent() {
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB &bb = **bIt;
+    MeStmt *nextStmt = nullptr;
+    for (MeStmt *stmt = to_ptr(bb.GetMeStmts().begin()); stmt != nullptr; stmt = nextStmt) {
+      nextStmt = stmt->GetNext();
+      if (stmt->GetOp() != OP_syncexit) {
+        continue;
+      }
+      MeStmt *enter = FindAdjacentEnter(*stmt);
+      if (enter == nullptr) {
+        continue;
+      }
+      if (nextStmt == enter) {
+        nextStmt = enter->GetNext();
+      }
+      RemoveSync(bb, *stmt, "merged with the next region");
+      RemoveSync(*enter->GetBB(), *enter, "merged with the previous region");
+    }
+  }
+}
+
+void LockElision::Run() {
+  RemoveNonEscaping();
+  RemoveNested();
+  MergeAdjacent();
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "lockelision: " << func.GetName() << ": " << numRemovedSyncs
+                           << " monitor operations removed\n";
+  }
+}
+
+AnalysisResult *MeDoLockElision::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr*) {
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  auto *escapeAnalysis = static_cast<EscapeAnalysis*>(funcResMgr->GetAnalysisResult(MeFuncPhase_ESCAPEANALYSIS, func));
+  CHECK_FATAL(escapeAnalysis != nullptr, "escapeanalysis has problem");
+  LockElision lockElision(*func, *escapeAnalysis, DEBUGFUNC(func));
+  lockElision.Run();
+  return nullptr;
+}
+}  // namespace maple
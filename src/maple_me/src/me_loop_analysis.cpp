@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_loop_analysis.h"
+#include "me_option.h"
+
+namespace maple {
+void IdentifyLoops::CollectLoopBBs(LoopDesc &loop, BB &latch) {
+  std::vector<BB*> workList;
+  if (loop.loopBBs.insert(latch.GetBBId()).second) {
+    workList.push_back(&latch);
+  }
+  while (!workList.empty()) {
+    BB *bb = workList.back();
+    workList.pop_back();
+    for (BB *pred : bb->GetPred()) {
+      // unreachable predecessors are no part of the loop
+      if (!dom.Dominate(*loop.head, *pred)) {
+        continue;
+      }
+      if (loop.loopBBs.insert(pred->GetBBId()).second) {
+        workList.push_back(pred);
+      }
+    }
+  }
+}
+
+// loops are created outer first, so the enclosing loop is the last one created before loop that contains its head
+void IdentifyLoops::SetParent(LoopDesc &loop) {
+  for (auto it = meLoops.rbegin(); it != meLoops.rend(); ++it) {
+    LoopDesc *outer = *it;
+    if (outer != &loop && outer->Has(*loop.head)) {
+      loop.parent = outer;
+      loop.nestDepth = outer->nestDepth + 1;
+      return;
+    }
+  }
+}
+
+void IdentifyLoops::SetPreheader(LoopDesc &loop) {
+  BB *outsidePred = nullptr;
+  for (BB *pred : loop.head->GetPred()) {
+    if (loop.Has(*pred)) {
+      continue;
+    }
+    if (outsidePred != nullptr) {
+      return;
+    }
+    outsidePred = pred;
+  }
+  if (outsidePred != nullptr && outsidePred != func.GetCommonEntryBB() && outsidePred->GetSucc().size() == 1) {
+    loop.preheader = outsidePred;
+  }
+}
+
+void IdentifyLoops::Run() {
+  // a head dominates the heads of the loops nested in it, so the dominator tree preorder creates outer loops first
+  for (BBId bbID : dom.GetDtPreOrder()) {
+    BB *head = func.GetBBFromID(bbID);
+    if (head == nullptr || head == func.GetCommonEntryBB() || head == func.GetCommonExitBB()) {
+      continue;
+    }
+    LoopDesc *loop = nullptr;
+    for (BB *pred : head->GetPred()) {
+      if (!dom.Dominate(*head, *pred)) {
+        continue;
+      }
+      if (loop == nullptr) {
+        loop = alloc.GetMemPool()->New<LoopDesc>(alloc, *head);
+        loop->loopBBs.insert(head->GetBBId());
+        meLoops.push_back(loop);
+      }
+      loop->latches.push_back(pred);
+      CollectLoopBBs(*loop, *pred);
+    }
+    if (loop == nullptr) {
+      continue;
+    }
+    SetParent(*loop);
+    SetPreheader(*loop);
+    // a BB of several loops is visited last by its innermost loop
+    for (BBId loopBBID : loop->loopBBs) {
+      bbLoops[loopBBID] = loop;
+    }
+  }
+}
+
+void IdentifyLoops::Dump() const {
+  for (LoopDesc *loop : meLoops) {
+    LogInfo::MapleLogger() << "loop head BB " << loop->head->GetBBId() << " depth " << loop->nestDepth;
+    if (loop->parent != nullptr) {
+      LogInfo::MapleLogger() << " in loop head BB " << loop->parent->head->GetBBId();
+    }
+    if (loop->preheader != nullptr) {
+      LogInfo::MapleLogger() << " preheader BB " << loop->preheader->GetBBId();
+    }
+    LogInfo::MapleLogger() << "\n  latches:";
+    for (BB *latch : loop->latches) {
+      LogInfo::MapleLogger() << " " << latch->GetBBId();
+    }
+    LogInfo::MapleLogger() << "\n  body:";
+    for (BBId bbID : loop->loopBBs) {
+      LogInfo::MapleLogger() << " " << bbID;
+    }
+    LogInfo::MapleLogger() << '\n';
+  }
+}
+
+AnalysisResult *MeDoMeLoop::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr*) {
+  auto *dom = static_cast<Dominance*>(funcResMgr->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_FATAL(dom != nullptr, "dominance phase has problem");
+  MemPool *meLoopMp = NewMemPool();
+  IdentifyLoops *identLoops = meLoopMp->New<IdentifyLoops>(*meLoopMp, *func, *dom);
+  identLoops->Run();
+  if (DEBUGFUNC(func)) {
+    identLoops->Dump();
+  }
+  return identLoops;
+}
+}  // namespace maple
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_loop_canon.h"
+#include "me_option.h"
+#include "mir_builder.h"
+
+// A preheader normally goes right before the head: the BB falling into the head now falls into the preheader, and
+// the branches from outside the loop are retargeted to it. When the BB falling into the head is in the loop, the
+// preheader goes last and ends with a goto to the head, so that back edge stays off the preheader.
+namespace maple {
+bool LoopCanon::IsBranchTo(const StmtNode &stmt, LabelIdx labelIdx) const {
+  switch (stmt.GetOpCode()) {
+    case OP_goto:
+      return static_cast<const GotoNode&>(stmt).GetOffset() == labelIdx;
+    case OP_brtrue:
+    case OP_brfalse:
+      return static_cast<const CondGotoNode&>(stmt).GetOffset() == labelIdx;
+    case OP_switch: {
+      auto &switchNode = static_cast<const SwitchNode&>(stmt);
+      if (switchNode.GetDefaultLabel() == labelIdx) {
+        return true;
+      }
+      for (const CasePair &casePair : switchNode.GetSwitchTable()) {
+        if (casePair.second == labelIdx) {
+          return true;
+        }
+      }
+      return false;
+    }
+    default:
+      return false;
+  }
+}
+
+void LoopCanon::Retarget(StmtNode &stmt, LabelIdx from, LabelIdx to) const {
+  switch (stmt.GetOpCode()) {
+    case OP_goto:
+      static_cast<GotoNode&>(stmt).SetOffset(to);
+      break;
+    case OP_brtrue:
+    case OP_brfalse:
+      static_cast<CondGotoNode&>(stmt).SetOffset(to);
+      break;
+    case OP_switch: {
+      auto &switchNode = static_cast<SwitchNode&>(stmt);
+      if (switchNode.GetDefaultLabel() == from) {
+        switchNode.SetDefaultLabel(to);
+      }
+      for (uint32 i = 0; i < switchNode.GetSwitchTable().size(); ++i) {
+        if (switchNode.GetCasePair(i).second == from) {
+          switchNode.UpdateCaseLabelAt(i, to);
+        }
+      }
+      break;
+    }
+    default:
+      CHECK_FATAL(false, "not a branch");
+  }
+}
+
+bool LoopCanon::FallsThruTo(const BB &bb, const BB &succ) const {
+  if (&bb == func.GetCommonEntryBB() || &bb == func.GetCommonExitBB()) {
+    return false;
+  }
+  return (bb.GetKind() == kBBFallthru || bb.GetKind() == kBBCondGoto) && bb.IsPredBB(succ);
+}
+
+bool LoopCanon::PlanPreheader(const LoopDesc &loop, PreheaderPlan &plan) {
+  BB &head = *loop.head;
+  if (loop.preheader != nullptr || head.GetAttributes(kBBAttrIsCatch) || head.GetAttributes(kBBAttrIsTry)) {
+    return false;
+  }
+  LabelIdx headLabel = head.GetBBLabel();
+  BB *prevBB = func.PrevBB(&head);
+  bool prevFallsThru = prevBB != nullptr && FallsThruTo(*prevBB, head);
+  plan.head = &head;
+  plan.outsidePreds.clear();
+  plan.jumpsToHead = prevFallsThru && loop.Has(*prevBB);
+  for (BB *pred : head.GetPred()) {
+    if (loop.Has(*pred)) {
+      continue;
+    }
+    bool jumps = headLabel != 0 && !pred->IsEmpty() && IsBranchTo(*pred->GetLast(), headLabel);
+    bool fallsThru = pred == prevBB && prevFallsThru;
+    // an edge can only be moved when it is exactly one of a branch or a fall through
+    if (jumps == fallsThru ||
+        std::find(plan.outsidePreds.begin(), plan.outsidePreds.end(), pred) != plan.outsidePreds.end()) {
+      return false;
+    }
+    plan.outsidePreds.push_back(pred);
+  }
+  return !plan.outsidePreds.empty() || head.GetAttributes(kBBAttrIsEntry);
+}
+
+void LoopCanon::InsertPreheader(const PreheaderPlan &plan) {
+  BB &head = *plan.head;
+  BB *preheader = plan.jumpsToHead ? func.NewBasicBlock() : func.InsertNewBasicBlock(head);
+  // the preheader runs at most as often as the head, whose count it takes when a profile is already in
+  preheader->SetFrequency(head.GetFrequency());
+  MIRBuilder *mirBuilder = func.GetMIRModule().GetMIRBuilder();
+  if (plan.jumpsToHead) {
+    preheader->AddStmtNode(mirBuilder->CreateStmtGoto(OP_goto, head.GetBBLabel()));
+    preheader->SetKind(kBBGoto);
+  } else {
+    preheader->SetKind(kBBFallthru);
+  }
+  LabelIdx headLabel = head.GetBBLabel();
+  LabelIdx preheaderLabel = 0;
+  for (BB *pred : plan.outsidePreds) {
+    if (headLabel != 0 && !pred->IsEmpty() && IsBranchTo(*pred->GetLast(), headLabel)) {
+      if (preheaderLabel == 0) {
+        preheaderLabel = mirBuilder->CreateLabIdx(*func.GetMirFunc());
+        preheader->SetBBLabel(preheaderLabel);
+        func.SetLabelBBAt(preheaderLabel, preheader);
+      }
+      Retarget(*pred->GetLast(), headLabel, preheaderLabel);
+    }
+    pred->ReplaceSucc(&head, preheader);
+    head.RemoveBBFromPred(pred);
+  }
+  if (head.GetAttributes(kBBAttrIsEntry)) {
+    func.GetCommonEntryBB()->ReplaceSuccOfCommonEntryBB(&head, preheader);
+    head.ClearAttributes(kBBAttrIsEntry);
+    preheader->SetAttributes(kBBAttrIsEntry);
+  }
+  preheader->AddSuccBB(&head);
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "loopcanon: preheader BB " << preheader->GetBBId() << " for loop head BB "
+                           << head.GetBBId() << '\n';
+  }
+}
+
+bool LoopCanon::Run() {
+  std::vector<PreheaderPlan> plans;
+  for (LoopDesc *loop : identLoops.GetMeLoops()) {
+    PreheaderPlan plan;
+    if (PlanPreheader(*loop, plan)) {
+      plans.push_back(plan);
+    }
+  }
+  for (const PreheaderPlan &plan : plans) {
+    InsertPreheader(plan);
+  }
+  return !plans.empty();
+}
+
+AnalysisResult *MeDoLoopCanon::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr*) {
+  auto *identLoops = static_cast<IdentifyLoops*>(funcResMgr->GetAnalysisResult(MeFuncPhase_MELOOP, func));
+  CHECK_FATAL(identLoops != nullptr, "meloop phase has problem");
+  LoopCanon loopCanon(*func, *identLoops, DEBUGFUNC(func));
+  if (loopCanon.Run()) {
+    funcResMgr->InvalidAnalysisResult(MeFuncPhase_DOMINANCE, func);
+    funcResMgr->InvalidAnalysisResult(MeFuncPhase_MELOOP, func);
+  }
+  return nullptr;
+}
+}  // namespace maple
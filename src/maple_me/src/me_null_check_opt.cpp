@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_null_check_opt.h"
+
+// Null checks come from the array accesses expanded by MIRLower::ExpandArrayMrt and from the frontend:
+//     assertnonnull v
+// A field access through a null reference traps and throws like a failed check, so once a statement reading or
+// writing a field of v completes, v is non-null. This only holds for fields inside the guard page at address 0, and
+// only for accesses no later phase or the code generator drops: a load assigned to a variable may be removed with
+// the variable once it is dead, so only loads feeding other statements and stores count. Element accesses compute
+// an address from an index and may not trap, they are covered by their own expanded check. As in castopt, facts
+// are kept along dominator tree paths and shared by values connected by plain copies; a handler is entered with no
+// fact, it may run before any of them held.
+namespace maple {
+// accesses below this offset from a null base fault
+static constexpr size_t kGuardPageSize = 4096;
+// the object header and the field padding are laid out by the code generator, these bound them
+static constexpr size_t kMaxObjectHeaderSize = 16;
+static constexpr size_t kMaxFieldAlign = 8;
+
+// adds an upper bound of the size of an object of type to size, false if it is not known; incomplete types may
+// lack fields
+static bool AddMaxObjectSize(const MIRType &type, size_t &size) {
+  MIRTypeKind kind = type.GetKind();
+  if (kind != kTypeStruct && kind != kTypeClass) {
+    return false;
+  }
+  if (kind == kTypeClass) {
+    TyIdx parentTyIdx = static_cast<const MIRClassType&>(type).GetParentTyIdx();
+    if (parentTyIdx != 0 && !AddMaxObjectSize(*GlobalTables::GetTypeTable().GetTypeFromTyIdx(parentTyIdx), size)) {
+      return false;
+    }
+  }
+  auto &structType = static_cast<const MIRStructType&>(type);
+  for (size_t i = 0; i < structType.GetFieldsSize(); ++i) {
+    size_t fieldSize = structType.GetElemType(static_cast<uint32>(i))->GetSize();
+    if (fieldSize == 0) {
+      return false;
+    }
+    size += (fieldSize + kMaxFieldAlign - 1) / kMaxFieldAlign * kMaxFieldAlign;
+  }
+  return true;
+}
+
+// true if the access traps when its base is null
+bool NullCheckOpt::IsGuardedAccess(const IvarMeExpr &ivar) const {
+  MIRType *ptrType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(ivar.GetTyIdx());
+  if (ptrType == nullptr || ptrType->GetKind() != kTypePointer) {
+    return false;
+  }
+  MIRType *pointedType = static_cast<MIRPtrType*>(ptrType)->GetPointedType();
+  size_t objectSize = kMaxObjectHeaderSize;
+  return pointedType != nullptr && AddMaxObjectSize(*pointedType, objectSize) && objectSize <= kGuardPageSize;
+}
+
+bool NullCheckOpt::IsTrackedValue(const MeExpr &expr) const {
+  if (expr.GetMeOp() == kMeOpReg) {
+    return true;
+  }
+  if (expr.GetMeOp() != kMeOpVar) {
+    return false;
+  }
+  const OriginalSt *ost = ssaTab.GetOriginalStFromID(static_cast<const VarMeExpr&>(expr).GetOStIdx());
+  return ost != nullptr && ost->IsLocal();
+}
+
+MeExpr *NullCheckOpt::GetDefRHS(MeExpr &expr) const {
+  MeStmt *defStmt = nullptr;
+  if (expr.GetMeOp() == kMeOpVar) {
+    auto &var = static_cast<VarMeExpr&>(expr);
+    defStmt = var.GetDefBy() == kDefByStmt ? var.GetDefStmt() : nullptr;
+  } else if (expr.GetMeOp() == kMeOpReg) {
+    auto &reg = static_cast<RegMeExpr&>(expr);
+    defStmt = reg.GetDefBy() == kDefByStmt ? reg.GetDefStmt() : nullptr;
+  }
+  if (defStmt == nullptr || (defStmt->GetOp() != OP_dassign && defStmt->GetOp() != OP_regassign)) {
+    return nullptr;
+  }
+  return defStmt->GetRHS();
+}
+
+MeExpr *NullCheckOpt::GetCopyRoot(MeExpr &expr) const {
+  MeExpr *root = &expr;
+  MeExpr *rhs = GetDefRHS(*root);
+  while (rhs != nullptr && IsTrackedValue(*rhs)) {
+    root = rhs;
+    rhs = GetDefRHS(*root);
+  }
+  return root;
+}
+
+bool NullCheckOpt::IsThis(const MeExpr &expr) const {
+  if (expr.GetMeOp() != kMeOpVar) {
+    return false;
+  }
+  auto &var = static_cast<const VarMeExpr&>(expr);
+  MIRFunction *mirFunc = func.GetMirFunc();
+  return var.GetDefBy() == kDefByNo && !mirFunc->IsStatic() && mirFunc->GetFormalCount() > 0 &&
+         ssaTab.GetMIRSymbolFromID(var.GetOStIdx()) == mirFunc->GetFormal(0);
+}
+
+// non-null wherever the value is used; optimistic on cycles, which all go through a phi
+bool NullCheckOpt::IsNonNullValue(MeExpr &expr, std::set<const MeExpr*> &visited) const {
+  if (expr.GetMeOp() == kMeOpGcmalloc || expr.GetMeOp() == kMeOpAddrof || expr.GetOp() == OP_gcmallocjarray ||
+      expr.GetOp() == OP_gcpermallocjarray) {
+    return true;
+  }
+  if (!IsTrackedValue(expr)) {
+    return false;
+  }
+  if (IsThis(expr)) {
+    return true;
+  }
+  if (!visited.insert(&expr).second) {
+    return true;
+  }
+  if (expr.GetMeOp() == kMeOpVar && static_cast<VarMeExpr&>(expr).GetDefBy() == kDefByPhi) {
+    for (VarMeExpr *opnd : static_cast<VarMeExpr&>(expr).GetDefPhi().GetOpnds()) {
+      if (!IsNonNullValue(*opnd, visited)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (expr.GetMeOp() == kMeOpReg && static_cast<RegMeExpr&>(expr).GetDefBy() == kDefByPhi) {
+    for (RegMeExpr *opnd : static_cast<RegMeExpr&>(expr).GetDefPhi().GetOpnds()) {
+      if (!IsNonNullValue(*opnd, visited)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  MeExpr *rhs = GetDefRHS(expr);
+  return rhs != nullptr && IsNonNullValue(*rhs, visited);
+}
+
+bool NullCheckOpt::IsNonNull(MeExpr &value) const {
+  std::set<const MeExpr*> visited;
+  if (!IsTrackedValue(value)) {
+    return IsNonNullValue(value, visited);
+  }
+  MeExpr *root = GetCopyRoot(value);
+  auto it = nonNullFacts.find(root);
+  return (it != nonNullFacts.end() && it->second != 0) || IsNonNullValue(*root, visited);
+}
+
+void NullCheckOpt::AddFact(MeExpr &value) {
+  ++nonNullFacts[&value];
+  factStack.push_back(&value);
+}
+
+// brtrue (ne v, 0) and the like
+void NullCheckOpt::AddBranchFact(BB &bb) {
+  if (bb.GetPred().size() != 1) {
+    return;
+  }
+  BB *pred = bb.GetPred(0);
+  if (pred->GetKind() != kBBCondGoto || pred->GetMeStmts().empty() || pred->GetSucc().size() != 2 ||
+      pred->GetSucc(0) == pred->GetSucc(1)) {
+    return;
+  }
+  MeStmt *lastStmt = to_ptr(pred->GetMeStmts().rbegin());
+  if (!lastStmt->IsCondBr()) {
+    return;
+  }
+  MeExpr *cond = lastStmt->GetOpnd(0);
+  if (cond->GetOp() != OP_ne && cond->GetOp() != OP_eq) {
+    return;
+  }
+  MeExpr *value = nullptr;
+  if (cond->GetOpnd(1)->GetMeOp() == kMeOpConst && cond->GetOpnd(1)->IsZero()) {
+    value = cond->GetOpnd(0);
+  } else if (cond->GetOpnd(0)->GetMeOp() == kMeOpConst && cond->GetOpnd(0)->IsZero()) {
+    value = cond->GetOpnd(1);
+  }
+  if (value == nullptr || value->GetPrimType() != PTY_ref || !IsTrackedValue(*value)) {
+    return;
+  }
+  bool isTaken = (&bb == func.GetLabelBBAt(static_cast<CondGotoMeStmt*>(lastStmt)->GetOffset()));
+  bool holds = (isTaken == (lastStmt->GetOp() == OP_brtrue));
+  if (holds == (cond->GetOp() == OP_ne)) {
+    AddFact(*GetCopyRoot(*value));
+  }
+}
+
+// values dereferenced whenever expr is evaluated
+void NullCheckOpt::CollectDerefs(MeExpr &expr, std::vector<MeExpr*> &bases) const {
+  Opcode op = expr.GetOp();
+  if (op == OP_select || op == OP_cand || op == OP_cior) {
+    return;
+  }
+  if (expr.GetMeOp() == kMeOpIvar) {
+    auto &ivar = static_cast<IvarMeExpr&>(expr);
+    if (IsTrackedValue(*ivar.GetBase()) && IsGuardedAccess(ivar)) {
+      bases.push_back(ivar.GetBase());
+    }
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    MeExpr *opnd = expr.GetOpnd(i);
+    if (opnd != nullptr) {
+      CollectDerefs(*opnd, bases);
+    }
+  }
+}
+
+void NullCheckOpt::OptimizeStmts(BB &bb) {
+  MeStmt *nextStmt = nullptr;
+  for (MeStmt *stmt = to_ptr(bb.GetMeStmts().begin()); stmt != nullptr; stmt = nextStmt) {
+    nextStmt = stmt->GetNext();
+    if (stmt->GetOp() == OP_assertnonnull) {
+      ++numChecks;
+      MeExpr *value = stmt->GetOpnd(0);
+      if (IsNonNull(*value)) {
+        if (enabledDebug) {
+          LogInfo::MapleLogger() << "nullcheckopt: remove null check in BB " << bb.GetBBId() << '\n';
+        }
+        bb.RemoveMeStmt(stmt);
+        ++numRemovedChecks;
+      } else if (IsTrackedValue(*value)) {
+        AddFact(*GetCopyRoot(*value));
+      }
+      continue;
+    }
+    // the loaded value may be dead, the load then goes away with the assignment
+    if (stmt->GetOp() == OP_dassign || stmt->GetOp() == OP_regassign) {
+      continue;
+    }
+    std::vector<MeExpr*> bases;
+    // the field written by iassign
+    if (stmt->GetOp() == OP_iassign) {
+      IvarMeExpr *lhs = static_cast<IassignMeStmt*>(stmt)->GetLHSVal();
+      if (lhs != nullptr && IsTrackedValue(*lhs->GetBase()) && IsGuardedAccess(*lhs)) {
+        bases.push_back(lhs->GetBase());
+      }
+    }
+    for (size_t i = 0; i < stmt->NumMeStmtOpnds(); ++i) {
+      MeExpr *opnd = stmt->GetOpnd(i);
+      if (opnd != nullptr) {
+        CollectDerefs(*opnd, bases);
+      }
+    }
+    for (MeExpr *base : bases) {
+      AddFact(*GetCopyRoot(*base));
+    }
+  }
+}
+
+void NullCheckOpt::TraverseBB(BB &bb) {
+  std::unordered_map<const MeExpr*, uint32> outerFacts;
+  std::vector<MeExpr*> outerFactStack;
+  bool isCatch = bb.GetAttributes(kBBAttrIsCatch);
+  if (isCatch) {
+    outerFacts.swap(nonNullFacts);
+    outerFactStack.swap(factStack);
+  }
+  size_t factMark = factStack.size();
+  AddBranchFact(bb);
+  OptimizeStmts(bb);
+  const MapleSet<BBId> &domChildren = dom.GetDomChildren(bb.GetBBId());
+  for (const BBId &childID : domChildren) {
+    BB *child = func.GetBBFromID(childID);
+    if (child != nullptr) {
+      TraverseBB(*child);
+    }
+  }
+  while (factStack.size() > factMark) {
+    --nonNullFacts[factStack.back()];
+    factStack.pop_back();
+  }
+  if (isCatch) {
+    outerFacts.swap(nonNullFacts);
+    outerFactStack.swap(factStack);
+  }
+}
+
+void NullCheckOpt::Finish() const {
+  if (enabledDebug && numChecks != 0) {
+    LogInfo::MapleLogger() << "nullcheckopt: " << func.GetName() << ": " << numRemovedChecks << " of " << numChecks
+                           << " null checks removed\n";
+  }
+}
+
+AnalysisResult *MeDoNullCheckOpt::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr*) {
+  auto *dom = static_cast<Dominance*>(funcResMgr->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_FATAL(dom != nullptr, "dominance phase has problem");
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  NullCheckOpt nullCheckOpt(*func, *dom, DEBUGFUNC(func));
+  nullCheckOpt.TraverseBB(*func->GetCommonEntryBB());
+  nullCheckOpt.Finish();
+  return nullptr;
+}
+}  // namespace maple
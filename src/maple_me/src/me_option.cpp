@@ -39,6 +39,10 @@ bool MeOption::ignoreIPA = true;
 bool MeOption::lessThrowAlias = true;
 bool MeOption::finalFieldAlias = false;
 bool MeOption::regreadAtReturn = true;
+bool MeOption::coldBBLayout = false;
+std::string MeOption::edgeProfileGen;
+std::string MeOption::edgeProfileUse;
+std::string MeOption::edgeProfileMap;
 
 void MeOption::SplitPhases(const std::string &str, std::unordered_set<std::string> &set) const {
   std::string s{str};
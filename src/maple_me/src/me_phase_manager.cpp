@@ -25,6 +25,24 @@
 #include "me_bb_layout.h"
 #include "me_emit.h"
 #include "me_rc_lowering.h"
+#include "me_rc_opt.h"
+#include "me_cast_opt.h"
+#include "me_clinit_opt.h"
+#include "me_escape_analysis.h"
+#include "me_edge_profile.h"
+#include "me_loop_analysis.h"
+#include "me_loop_canon.h"
+#include "me_licm.h"
+#include "me_bce.h"
+#include "me_null_check_opt.h"
+#include "me_ssa_pre.h"
+#include "me_sccp.h"
+#include "me_dce.h"
+#include "me_dse.h"
+#include "me_copy_prop.h"
+#include "me_coalesce.h"
+#include "me_lock_elision.h"
+#include "me_iv_opt.h"
 #include "gen_check_cast.h"
 #include "me_ssa_tab.h"
 #include "mpl_timer.h"
@@ -88,10 +106,37 @@ void MeFuncPhaseManager::AddPhases(const std::unordered_set<std::string> &skipPh
   };
   if (mePhaseType == kMePhaseMainopt) {
     /* default phase sequence */
+    bool optimize = MeOption::optLevel >= MeOption::kLevelTwo;
+    if (optimize) {
+      addPhase("loopcanon");
+    }
+    if (!MeOption::edgeProfileGen.empty() || !MeOption::edgeProfileUse.empty()) {
+      addPhase("edgeprofile");
+    }
+    if (optimize) {
+      addPhase("clinitopt");
+    }
     addPhase("ssaTab");
     addPhase("aliasclass");
     addPhase("ssa");
+    if (optimize) {
+      addPhase("sccp");
+      addPhase("castopt");
+      addPhase("bce");
+      addPhase("nullcheckopt");
+      addPhase("licm");
+      addPhase("ivopt");
+      addPhase("ssapre");
+      addPhase("copyprop");
+      addPhase("dse");
+      addPhase("dce");
+      addPhase("lockelision");
+    }
     addPhase("rclowering");
+    if (optimize) {
+      addPhase("rcopt");
+      addPhase("coalesce");
+    }
     addPhase("emit");
   }
 }
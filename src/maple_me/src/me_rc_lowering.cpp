@@ -303,7 +303,6 @@ void RCLowering::PreprocessAssignMeStmt(MeStmt &stmt) {
   if (rhs->GetMeOp() != kMeOpGcmalloc) {
     return;
   }
-  gcMallocObjects.insert(lhs);
   if (lsym->GetAttr(ATTR_rcunowned)) {
     /*
      * if new obj is assigned to unowned refvar, we need a localrefvar
@@ -387,16 +386,13 @@ void RCLowering::HandleAssignToLocalVar(MeStmt &stmt, MeExpr *pendingDec) {
 }
 
 bool RCLowering::IsInitialized(IvarMeExpr &ivar) {
-  MeExpr *base = ivar.GetBase();
-  if (base->GetMeOp() != kMeOpVar) {
-    return true;
-  }
-  if (gcMallocObjects.find(base) == gcMallocObjects.end()) {
+  auto it = freshObjects.find(ivar.GetBase());
+  if (it == freshObjects.end()) {
     return true;
   }
   FieldID fieldID = ivar.GetFieldID();
-  MapleSet<FieldID> *fieldSet = initializedFields[base];
-  if (fieldSet != nullptr && (fieldSet->count(fieldID) > 0 || fieldSet->count(0) > 0)) {
+  const std::set<FieldID> &fieldSet = it->second.initializedFields;
+  if (fieldSet.count(fieldID) > 0 || fieldSet.count(0) > 0) {
     return true;
   }
   MIRType *baseType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(ivar.GetTyIdx());
@@ -420,12 +416,6 @@ void RCLowering::HandleAssignMeStmtIvarLHS(MeStmt &stmt) {
   }
   if (!IsInitialized(*lhsInner)) {
     stmt.DisableNeedDecref();
-    MapleSet<FieldID> *fieldSet = initializedFields[lhsInner->GetBase()];
-    if (fieldSet == nullptr) {
-      fieldSet =
-          mirModule.GetMemPool()->New<MapleSet<FieldID>>(std::less<FieldID>(), mirModule.GetMPAllocator().Adapter());
-    }
-    fieldSet->insert(fieldID);
   }
   MeExpr *rhsInner = stmt.GetRHS();
   MIRIntrinsicID intrinsicID = SelectWriteBarrier(stmt);
@@ -489,6 +479,7 @@ MIRIntrinsicID RCLowering::SelectWriteBarrier(const MeStmt &stmt) {
 }
 
 void RCLowering::RCLower() {
+  ComputeFreshObjects();
   auto eIt = func.valid_end();
   for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
     if (bIt == func.common_entry() || bIt == func.common_exit()) {
@@ -498,38 +489,181 @@ void RCLowering::RCLower() {
   }
 }
 
+// A fresh object used anywhere but as a dereferenced base or a compared value may get another reference,
+// which could then write its fields behind our back.
+void RCLowering::RemovePublishedObjects(MeExpr &expr, bool isSafeUse, FreshObjects &objects) const {
+  if (expr.GetMeOp() == kMeOpVar || expr.GetMeOp() == kMeOpReg) {
+    if (!isSafeUse) {
+      objects.erase(&expr);
+    }
+    return;
+  }
+  if (expr.GetMeOp() == kMeOpIvar) {
+    RemovePublishedObjects(*static_cast<IvarMeExpr&>(expr).GetBase(), true, objects);
+    return;
+  }
+  bool isCompare = kOpcodeInfo.IsCompare(expr.GetOp());
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    RemovePublishedObjects(*expr.GetOpnd(i), isCompare, objects);
+  }
+}
+
 /*
- * if a var me expr is initialized by constructor, record it's initialized map
+ * if a fresh object is initialized by constructor, record it's initialized map
  * if a field id is not in initialized map, means the field has not been assigned a value
  * dec ref is not necessary in it's first assignment.
  */
-void RCLowering::InitializedObjectFields(MeStmt &stmt) {
-  if (stmt.GetOp() != OP_callassigned) {
-    return;
-  }
-  auto &call = static_cast<CallMeStmt&>(stmt);
+void RCLowering::UpdateFreshObjectsAtCall(CallMeStmt &call, FreshObjects &objects) {
   MIRFunction *callee = GlobalTables::GetFunctionTable().GetFunctionFromPuidx(call.GetPUIdx());
-  if (call.NumMeStmtOpnds() == 0 || call.GetOpnd(0)->GetMeOp() != kMeOpVar) {
-    return;
+  size_t firstOpnd = 0;
+  if (call.GetOp() == OP_callassigned && callee->IsConstructor() && call.NumMeStmtOpnds() > 0) {
+    auto it = objects.find(call.GetOpnd(0));
+    const auto &initializedMap = mirModule.GetPuIdxFieldInitializedMap();
+    auto mapIt = initializedMap.find(call.GetPUIdx());
+    if (it != objects.end() && !it->second.constructed && mapIt != initializedMap.end()) {
+      it->second.constructed = true;
+      if (mapIt->second != nullptr) {
+        it->second.initializedFields.insert(mapIt->second->begin(), mapIt->second->end());
+      }
+      firstOpnd = 1;
+    }
   }
-  MeExpr *firstOpnd = call.GetOpnd(0);
-  bool isNew = gcMallocObjects.find(firstOpnd) != gcMallocObjects.end();
-  bool hasNotInitialized = initializedFields.find(firstOpnd) == initializedFields.end();
-  bool inInitializedMap =
-      mirModule.GetPuIdxFieldInitializedMap().find(call.GetPUIdx()) != mirModule.GetPuIdxFieldInitializedMap().end();
-  if (callee->IsConstructor() && isNew && hasNotInitialized && inInitializedMap) {
-    initializedFields[firstOpnd] = mirModule.GetPUIdxFieldInitializedMapItem(call.GetPUIdx());
-  } else {
-    for (auto iter : call.GetOpnds()) {
-      gcMallocObjects.erase(iter);
+  // a callee that never writes to a fresh object keeps its fields uninitialized
+  for (size_t i = firstOpnd; i < call.NumMeStmtOpnds(); ++i) {
+    RemovePublishedObjects(*call.GetOpnd(i), escapeAnalysis.IsReadOnlyCallArg(call, i), objects);
+  }
+}
+
+void RCLowering::UpdateFreshObjects(MeStmt &stmt, FreshObjects &objects) {
+  switch (stmt.GetOp()) {
+    case OP_dassign:
+      RemovePublishedObjects(*stmt.GetRHS(), false, objects);
+      if (stmt.GetRHS()->GetMeOp() == kMeOpGcmalloc) {
+        objects[stmt.GetLHS()] = FreshObjectInfo();
+      }
+      return;
+    case OP_iassign: {
+      IvarMeExpr *lhsInner = static_cast<IassignMeStmt&>(stmt).GetLHSVal();
+      RemovePublishedObjects(*lhsInner->GetBase(), true, objects);
+      RemovePublishedObjects(*stmt.GetRHS(), false, objects);
+      auto it = objects.find(lhsInner->GetBase());
+      if (it != objects.end()) {
+        it->second.initializedFields.insert(lhsInner->GetFieldID());
+      }
+      return;
+    }
+    case OP_brtrue:
+    case OP_brfalse:
+    case OP_syncenter:
+    case OP_syncexit:
+    case OP_assertnonnull:
+      for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+        RemovePublishedObjects(*stmt.GetOpnd(i), true, objects);
+      }
+      return;
+    case OP_call:
+    case OP_callassigned:
+      UpdateFreshObjectsAtCall(static_cast<CallMeStmt&>(stmt), objects);
+      return;
+    case OP_intrinsiccall: {
+      // the RC updates inserted by this phase touch no field
+      MIRIntrinsicID intrinsic = static_cast<IntrinsiccallMeStmt&>(stmt).GetIntrinsic();
+      if (intrinsic == INTRN_MCCIncRef || intrinsic == INTRN_MCCDecRef) {
+        return;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+    RemovePublishedObjects(*stmt.GetOpnd(i), false, objects);
+  }
+}
+
+// an object stays fresh only if it is fresh on every path, its fields are initialized if they are on any path
+void RCLowering::MeetFreshObjects(FreshObjects &objects, const FreshObjects &predObjects) const {
+  for (auto it = objects.begin(); it != objects.end();) {
+    auto predIt = predObjects.find(it->first);
+    if (predIt == predObjects.end()) {
+      it = objects.erase(it);
+      continue;
+    }
+    it->second.constructed = it->second.constructed || predIt->second.constructed;
+    it->second.initializedFields.insert(predIt->second.initializedFields.begin(),
+                                        predIt->second.initializedFields.end());
+    ++it;
+  }
+}
+
+// return false if no predecessor of bb has been visited yet
+bool RCLowering::GetFreshObjectsAtEntry(BB &bb, const std::map<BBId, FreshObjects> &objectsAtExit,
+                                        FreshObjects &objects) const {
+  objects.clear();
+  // an exception may be thrown from the middle of a try block
+  if (bb.GetAttributes(kBBAttrIsCatch) || bb.GetPred().empty()) {
+    return true;
+  }
+  bool visited = false;
+  for (BB *pred : bb.GetPred()) {
+    auto predIt = objectsAtExit.find(pred->GetBBId());
+    if (predIt == objectsAtExit.end()) {
+      continue;
+    }
+    if (!visited) {
+      objects = predIt->second;
+      visited = true;
+    } else {
+      MeetFreshObjects(objects, predIt->second);
+    }
+  }
+  // a phi creates another reference to its operands
+  for (auto &phiPair : bb.GetMevarPhiList()) {
+    if (phiPair.second->GetIsLive()) {
+      for (VarMeExpr *opnd : phiPair.second->GetOpnds()) {
+        objects.erase(opnd);
+      }
+    }
+  }
+  for (auto &phiPair : bb.GetMeregphiList()) {
+    if (phiPair.second->GetIsLive()) {
+      for (RegMeExpr *opnd : phiPair.second->GetOpnds()) {
+        objects.erase(opnd);
+      }
+    }
+  }
+  return visited;
+}
+
+// forward dataflow over the CFG, the facts at each BB entry only shrink once the BB has been visited
+void RCLowering::ComputeFreshObjects() {
+  std::map<BBId, FreshObjects> objectsAtExit;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    auto eIt = func.valid_end();
+    for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+      BB *bb = *bIt;
+      FreshObjects objects;
+      if (!GetFreshObjectsAtEntry(*bb, objectsAtExit, objects)) {
+        continue;
+      }
+      freshObjectsAtEntry[bb->GetBBId()] = objects;
+      for (auto &stmt : bb->GetMeStmts()) {
+        UpdateFreshObjects(stmt, objects);
+      }
+      auto exitIt = objectsAtExit.find(bb->GetBBId());
+      if (exitIt == objectsAtExit.end() || !(exitIt->second == objects)) {
+        objectsAtExit[bb->GetBBId()] = std::move(objects);
+        changed = true;
+      }
     }
   }
 }
 
 void RCLowering::BBLower(BB &bb) {
   MeExpr *pendingDec = nullptr;
-  gcMallocObjects.clear();
-  initializedFields.clear();
+  freshObjects = freshObjectsAtEntry[bb.GetBBId()];
   needSpecialHandleException = bb.GetAttributes(kBBAttrIsCatch);
   for (auto &stmt : bb.GetMeStmts()) {
     pendingDec = stmt.GetLHSRef(ssaTab, false);
@@ -541,12 +675,12 @@ void RCLowering::BBLower(BB &bb) {
       if (retType != nullptr && retType->GetPrimType() == PTY_ref) {
         HandleCallAssignedMeStmt(stmt, pendingDec);
       }
-      InitializedObjectFields(stmt);
     } else if (stmt.IsAssign()) {
       HandleAssignMeStmt(stmt, pendingDec);
     } else {
       // handling is not necessary
     }
+    UpdateFreshObjects(stmt, freshObjects);
   }
   // there is no any statement exist whose opnd is the throw value, handle it
   if (needSpecialHandleException) {
@@ -836,7 +970,9 @@ AnalysisResult *MeDoRCLowering::Run(MeFunction *func, MeFuncResultMgr *funcResMg
     func->SetIRMap(hmap);
   }
   CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
-  RCLowering rcLowering(*func, *kh, DEBUGFUNC(func));
+  auto *escapeAnalysis = static_cast<EscapeAnalysis*>(funcResMgr->GetAnalysisResult(MeFuncPhase_ESCAPEANALYSIS, func));
+  CHECK_FATAL(escapeAnalysis != nullptr, "escapeanalysis has problem");
+  RCLowering rcLowering(*func, *kh, *escapeAnalysis, DEBUGFUNC(func));
 
   rcLowering.Prepare();
   rcLowering.PreRCLower();
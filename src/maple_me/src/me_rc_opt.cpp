@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_rc_opt.h"
+
+// An IncRef(v) followed by DecRef(v) leaves the count of v unchanged, but the pair can only be dropped if nothing in
+// between relies on the extra count: no call, write barrier or other DecRef that might release v, and no statement
+// that may throw, as unwinding would then see the local ref var cleanup without the IncRef. The DecRef block must also
+// run exactly once per IncRef block, which holds when the blocks between them form an acyclic region that control
+// can only leave through the DecRef block.
+namespace maple {
+// how many post dominators of the IncRef block are searched for the DecRef
+static constexpr uint32 kMaxPairingDistance = 4;
+
+bool RCOpt::IsRCIntrinsic(const MeStmt &stmt, MIRIntrinsicID intrnID) const {
+  return stmt.GetOp() == OP_intrinsiccall && stmt.NumMeStmtOpnds() == 1 &&
+         static_cast<const IntrinsiccallMeStmt&>(stmt).GetIntrinsic() == intrnID;
+}
+
+bool RCOpt::IsNonThrowingExpr(const MeExpr &expr) const {
+  switch (expr.GetMeOp()) {
+    case kMeOpVar:
+    case kMeOpReg:
+    case kMeOpConst:
+    case kMeOpConststr:
+    case kMeOpConststr16:
+    case kMeOpAddrof:
+    case kMeOpAddroffunc:
+    case kMeOpSizeoftype:
+      return true;
+    case kMeOpOp: {
+      if (expr.GetOp() == OP_div || expr.GetOp() == OP_rem) {
+        return false;
+      }
+      for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+        if (!IsNonThrowingExpr(*expr.GetOpnd(i))) {
+          return false;
+        }
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+// true if stmt can neither throw nor decrease the count of any object
+bool RCOpt::IsRCNeutral(const MeStmt &stmt) const {
+  switch (stmt.GetOp()) {
+    case OP_comment:
+    case OP_goto:
+    case OP_membaracquire:
+    case OP_membarrelease:
+    case OP_membarstoreload:
+    case OP_membarstorestore:
+      return true;
+    case OP_dassign:
+    case OP_regassign:
+    case OP_brtrue:
+    case OP_brfalse: {
+      for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+        if (!IsNonThrowingExpr(*stmt.GetOpnd(i))) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case OP_intrinsiccall:
+      return IsRCIntrinsic(stmt, INTRN_MCCIncRef);
+    default:
+      return false;
+  }
+}
+
+bool RCOpt::IsNeutralBB(const BB &bb) const {
+  for (auto &stmt : bb.GetMeStmts()) {
+    if (!IsRCNeutral(stmt)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RCOpt::IsPairingRegion(BB &incBB, BB &decBB) const {
+  if (!dom.Dominate(incBB, decBB)) {
+    return false;
+  }
+  std::set<BB*> region;
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB *bb = *bIt;
+    if (bb != &incBB && bb != &decBB && dom.Dominate(incBB, *bb) && dom.PostDominate(decBB, *bb)) {
+      region.insert(bb);
+    }
+  }
+  for (BB *pred : decBB.GetPred()) {
+    if (pred != &incBB && region.find(pred) == region.end()) {
+      return false;
+    }
+  }
+  std::vector<BB*> froms(region.begin(), region.end());
+  froms.push_back(&incBB);
+  for (BB *from : froms) {
+    for (BB *succ : from->GetSucc()) {
+      if (succ == &decBB) {
+        continue;
+      }
+      if (region.find(succ) == region.end() || dom.Dominate(*succ, *from)) {
+        return false;
+      }
+    }
+  }
+  for (BB *bb : region) {
+    if (!IsNeutralBB(*bb)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Scan from stmt to the end of its block. Return the DecRef of value if only neutral statements come before it.
+MeStmt *RCOpt::FindDecInBB(const MeStmt *stmt, const MeExpr &value, bool &reachedEnd) const {
+  reachedEnd = false;
+  for (; stmt != nullptr; stmt = stmt->GetNext()) {
+    if (IsRCIntrinsic(*stmt, INTRN_MCCDecRef) && stmt->GetOpnd(0) == &value) {
+      return const_cast<MeStmt*>(stmt);
+    }
+    if (!IsRCNeutral(*stmt)) {
+      return nullptr;
+    }
+  }
+  reachedEnd = true;
+  return nullptr;
+}
+
+MeStmt *RCOpt::FindMatchingDec(MeStmt &incStmt) const {
+  const MeExpr &value = *incStmt.GetOpnd(0);
+  bool reachedEnd = false;
+  MeStmt *decStmt = FindDecInBB(incStmt.GetNext(), value, reachedEnd);
+  BB *incBB = incStmt.GetBB();
+  BB *decBB = incBB;
+  for (uint32 distance = 0; decStmt == nullptr && reachedEnd && distance < kMaxPairingDistance; ++distance) {
+    decBB = dom.GetPdom(decBB->GetBBId());
+    if (decBB == nullptr || decBB == func.GetCommonExitBB() || decBB->GetMeStmts().empty() ||
+        !IsPairingRegion(*incBB, *decBB)) {
+      return nullptr;
+    }
+    decStmt = FindDecInBB(to_ptr(decBB->GetMeStmts().begin()), value, reachedEnd);
+  }
+  return decStmt;
+}
+
+void RCOpt::RemoveRCStmt(MeStmt &stmt) {
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "rcopt: remove in BB " << stmt.GetBB()->GetBBId() << ": ";
+    stmt.Dump(func.GetIRMap());
+  }
+  stmt.GetBB()->RemoveMeStmt(&stmt);
+}
+
+void RCOpt::RemoveNullRCOps() {
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    MeStmt *nextStmt = nullptr;
+    for (MeStmt *stmt = to_ptr((*bIt)->GetMeStmts().begin()); stmt != nullptr; stmt = nextStmt) {
+      nextStmt = stmt->GetNext();
+      if ((IsRCIntrinsic(*stmt, INTRN_MCCIncRef) || IsRCIntrinsic(*stmt, INTRN_MCCDecRef)) &&
+          stmt->GetOpnd(0)->GetMeOp() == kMeOpConst && stmt->GetOpnd(0)->IsZero()) {
+        RemoveRCStmt(*stmt);
+        ++numNullRCOps;
+      }
+    }
+  }
+}
+
+void RCOpt::PairIncDec() {
+  std::vector<MeStmt*> incStmts;
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    for (auto &stmt : (*bIt)->GetMeStmts()) {
+      if (IsRCIntrinsic(stmt, INTRN_MCCIncRef)) {
+        incStmts.push_back(&stmt);
+      }
+    }
+  }
+  for (MeStmt *incStmt : incStmts) {
+    MeStmt *decStmt = FindMatchingDec(*incStmt);
+    if (decStmt == nullptr) {
+      continue;
+    }
+    RemoveRCStmt(*incStmt);
+    RemoveRCStmt(*decStmt);
+    numPairedOps += 2;
+  }
+}
+
+void RCOpt::Finish() const {
+  uint32 numRemoved = numNullRCOps + numPairedOps;
+  if ((MeOption::quiet && !enabledDebug) || numRemoved == 0) {
+    return;
+  }
+  LogInfo::MapleLogger() << "rcopt: " << func.GetName() << ": " << numRemoved << " RC intrinsics removed, "
+                         << numNullRCOps << " on null, " << numPairedOps << " in inc/dec pairs\n";
+}
+
+AnalysisResult *MeDoRCOpt::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr *moduleResMgr) {
+  auto *dom = static_cast<Dominance*>(funcResMgr->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_FATAL(dom != nullptr, "dominance phase has problem");
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  RCOpt rcOpt(*func, *dom, DEBUGFUNC(func));
+  rcOpt.RemoveNullRCOps();
+  rcOpt.PairIncDec();
+  rcOpt.Finish();
+  return nullptr;
+}
+}  // namespace maple
@@ -0,0 +1,601 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_sccp.h"
+#include "me_cfg.h"
+
+// The lattice of an SSA value only goes down (top, then one constant, then bottom), so each value is lowered at most
+// twice and each edge becomes executable once: the propagation is linear in the size of the SSA graph.
+// A phi meets the operands of its executable incoming edges only, which is what lets constants survive a join with
+// the result of a branch that is never taken. Conditional branches in try blocks have exception edges as well, they
+// are never decided so that handlers stay reachable.
+//
+// The CFG is updated in place: a decided branch becomes a goto or a fallthru, the phis of the untaken successor lose
+// the operand of the removed edge, and the blocks no longer reachable are deleted with their statements.
+// SetChangeCFG is not used, as the phase manager would rebuild the function from its MIR body and drop the SSA
+// level rewrites done here; the dominance and loop analyses are invalidated instead.
+namespace maple {
+static int64 ZeroExtend(int64 value, uint32 bitSize) {
+  if (bitSize == 0 || bitSize >= 64) {
+    return value;
+  }
+  return static_cast<int64>(static_cast<uint64>(value) & ((1ULL << bitSize) - 1));
+}
+
+static int64 SignExtend(int64 value, uint32 bitSize) {
+  if (bitSize == 0 || bitSize >= 64) {
+    return value;
+  }
+  uint64 bits = static_cast<uint64>(ZeroExtend(value, bitSize));
+  if ((bits & (1ULL << (bitSize - 1))) != 0) {
+    bits |= ~((1ULL << bitSize) - 1);
+  }
+  return static_cast<int64>(bits);
+}
+
+// value as read back from a location of primType
+static int64 Truncate(int64 value, PrimType primType) {
+  uint32 bitSize = GetPrimTypeBitSize(primType);
+  return IsSignedInteger(primType) ? SignExtend(value, bitSize) : ZeroExtend(value, bitSize);
+}
+
+static bool IsComparison(Opcode op) {
+  return op == OP_eq || op == OP_ne || op == OP_lt || op == OP_le || op == OP_gt || op == OP_ge || op == OP_cmp;
+}
+
+bool SCCP::IsTrackedValue(MeExpr &expr) const {
+  MeExprOp meOp = expr.GetMeOp();
+  if ((meOp != kMeOpVar && meOp != kMeOpReg) || !IsPrimitivePureScalar(expr.GetPrimType()) ||
+      expr.IsVolatile(ssaTab)) {
+    return false;
+  }
+  if (meOp == kMeOpReg) {
+    return true;
+  }
+  // a store to a narrower variable or to a field truncates the value
+  const OriginalSt *ost = ssaTab.GetOriginalStFromID(static_cast<VarMeExpr&>(expr).GetOStIdx());
+  if (ost->GetFieldID() != 0) {
+    return false;
+  }
+  MIRType *type = GlobalTables::GetTypeTable().GetTypeFromTyIdx(ost->GetTyIdx());
+  return GetPrimTypeSize(type->GetPrimType()) == GetPrimTypeSize(expr.GetPrimType());
+}
+
+SCCP::LatticeValue SCCP::GetValue(const MeExpr &expr) const {
+  auto it = values.find(&expr);
+  if (it != values.end()) {
+    return it->second;
+  }
+  // parameters and the initial versions of variables
+  MeDefBy defBy = (expr.GetMeOp() == kMeOpVar) ? static_cast<const VarMeExpr&>(expr).GetDefBy()
+                                                : static_cast<const RegMeExpr&>(expr).GetDefBy();
+  return LatticeValue{(defBy == kDefByNo) ? kLatticeBottom : kLatticeTop, 0};
+}
+
+SCCP::LatticeValue SCCP::Meet(LatticeValue value0, LatticeValue value1) {
+  if (value0.kind == kLatticeTop) {
+    return value1;
+  }
+  if (value1.kind == kLatticeTop) {
+    return value0;
+  }
+  if (value0.kind == kLatticeConst && value1.kind == kLatticeConst && value0.value == value1.value) {
+    return value0;
+  }
+  return LatticeValue{kLatticeBottom, 0};
+}
+
+void SCCP::LowerValue(const MeExpr &value, LatticeValue newValue) {
+  LatticeValue oldValue = GetValue(value);
+  LatticeValue lowered = Meet(oldValue, newValue);
+  // two different constants meet to bottom, so an unchanged kind is an unchanged value
+  if (lowered.kind == oldValue.kind) {
+    return;
+  }
+  values[&value] = lowered;
+  auto stmtIt = stmtUses.find(&value);
+  if (stmtIt != stmtUses.end()) {
+    stmtWorkList.insert(stmtWorkList.end(), stmtIt->second.begin(), stmtIt->second.end());
+  }
+  auto phiIt = phiUses.find(&value);
+  if (phiIt != phiUses.end()) {
+    phiWorkList.insert(phiWorkList.end(), phiIt->second.begin(), phiIt->second.end());
+  }
+}
+
+bool SCCP::FoldUnary(Opcode op, PrimType primType, const OpMeExpr &expr, int64 opnd, int64 &result) const {
+  switch (op) {
+    case OP_neg:
+      result = static_cast<int64>(0ULL - static_cast<uint64>(opnd));
+      break;
+    case OP_bnot:
+      result = ~opnd;
+      break;
+    case OP_lnot:
+      result = (opnd == 0) ? 1 : 0;
+      break;
+    case OP_abs:
+      result = (opnd < 0) ? static_cast<int64>(0ULL - static_cast<uint64>(opnd)) : opnd;
+      break;
+    case OP_sext:
+      result = SignExtend(opnd, expr.GetBitsSize());
+      break;
+    case OP_zext:
+      result = ZeroExtend(opnd, expr.GetBitsSize());
+      break;
+    case OP_cvt:
+      if (!IsPrimitivePureScalar(expr.GetOpndType())) {
+        return false;
+      }
+      result = Truncate(opnd, expr.GetOpndType());
+      break;
+    default:
+      return false;
+  }
+  result = Truncate(result, primType);
+  return true;
+}
+
+bool SCCP::FoldBinary(Opcode op, PrimType primType, PrimType opndType, int64 opnd0, int64 opnd1,
+                      int64 &result) const {
+  if (IsComparison(op)) {
+    if (!IsPrimitivePureScalar(opndType)) {
+      return false;
+    }
+    int64 value0 = Truncate(opnd0, opndType);
+    int64 value1 = Truncate(opnd1, opndType);
+    bool isLess = IsUnsignedInteger(opndType) ? static_cast<uint64>(value0) < static_cast<uint64>(value1)
+                                              : value0 < value1;
+    bool isEqual = (value0 == value1);
+    switch (op) {
+      case OP_eq:
+        result = isEqual ? 1 : 0;
+        break;
+      case OP_ne:
+        result = isEqual ? 0 : 1;
+        break;
+      case OP_lt:
+        result = isLess ? 1 : 0;
+        break;
+      case OP_le:
+        result = (isLess || isEqual) ? 1 : 0;
+        break;
+      case OP_gt:
+        result = (isLess || isEqual) ? 0 : 1;
+        break;
+      case OP_ge:
+        result = isLess ? 0 : 1;
+        break;
+      default:
+        result = isEqual ? 0 : (isLess ? -1 : 1);
+        break;
+    }
+    result = Truncate(result, primType);
+    return true;
+  }
+  uint32 bitSize = GetPrimTypeBitSize(primType);
+  bool isUnsigned = IsUnsignedInteger(primType);
+  uint64 uValue0 = static_cast<uint64>(isUnsigned ? ZeroExtend(opnd0, bitSize) : opnd0);
+  uint64 uValue1 = static_cast<uint64>(isUnsigned ? ZeroExtend(opnd1, bitSize) : opnd1);
+  // shift counts are taken modulo the width, as java does
+  uint32 shift = static_cast<uint32>(uValue1 & (bitSize - 1));
+  switch (op) {
+    case OP_add:
+      result = static_cast<int64>(uValue0 + uValue1);
+      break;
+    case OP_sub:
+      result = static_cast<int64>(uValue0 - uValue1);
+      break;
+    case OP_mul:
+      result = static_cast<int64>(uValue0 * uValue1);
+      break;
+    case OP_div:
+    case OP_rem:
+      if (uValue1 == 0) {
+        return false;  // throws at run time
+      }
+      if (isUnsigned) {
+        result = static_cast<int64>((op == OP_div) ? uValue0 / uValue1 : uValue0 % uValue1);
+      } else if (opnd1 == -1) {
+        // avoids the overflow of the minimum value divided by -1
+        result = (op == OP_div) ? static_cast<int64>(0ULL - uValue0) : 0;
+      } else {
+        result = (op == OP_div) ? opnd0 / opnd1 : opnd0 % opnd1;
+      }
+      break;
+    case OP_band:
+      result = static_cast<int64>(uValue0 & uValue1);
+      break;
+    case OP_bior:
+      result = static_cast<int64>(uValue0 | uValue1);
+      break;
+    case OP_bxor:
+      result = static_cast<int64>(uValue0 ^ uValue1);
+      break;
+    case OP_shl:
+      result = static_cast<int64>(uValue0 << shift);
+      break;
+    case OP_lshr:
+      result = static_cast<int64>(static_cast<uint64>(ZeroExtend(opnd0, bitSize)) >> shift);
+      break;
+    case OP_ashr:
+      result = SignExtend(opnd0, bitSize) >> shift;
+      break;
+    case OP_max:
+      result = (isUnsigned ? uValue0 > uValue1 : opnd0 > opnd1) ? opnd0 : opnd1;
+      break;
+    case OP_min:
+      result = (isUnsigned ? uValue0 < uValue1 : opnd0 < opnd1) ? opnd0 : opnd1;
+      break;
+    default:
+      return false;
+  }
+  result = Truncate(result, primType);
+  return true;
+}
+
+SCCP::LatticeValue SCCP::Evaluate(MeExpr &expr) const {
+  static const LatticeValue kBottom = { kLatticeBottom, 0 };
+  PrimType primType = expr.GetPrimType();
+  switch (expr.GetMeOp()) {
+    case kMeOpConst: {
+      MIRConst *constVal = static_cast<ConstMeExpr&>(expr).GetConstVal();
+      if (constVal->GetKind() != kConstInt || !IsPrimitivePureScalar(primType)) {
+        return kBottom;
+      }
+      return LatticeValue{kLatticeConst, Truncate(static_cast<MIRIntConst*>(constVal)->GetValue(), primType)};
+    }
+    case kMeOpVar:
+    case kMeOpReg:
+      return IsTrackedValue(expr) ? GetValue(expr) : kBottom;
+    case kMeOpOp:
+      break;
+    default:
+      return kBottom;
+  }
+  if (!IsPrimitivePureScalar(primType)) {
+    return kBottom;
+  }
+  auto &opExpr = static_cast<OpMeExpr&>(expr);
+  Opcode op = expr.GetOp();
+  if (op == OP_select) {
+    LatticeValue cond = Evaluate(*expr.GetOpnd(0));
+    if (cond.kind != kLatticeConst) {
+      return cond;
+    }
+    return Evaluate(*expr.GetOpnd((cond.value != 0) ? 1 : 2));
+  }
+  size_t numOpnds = expr.GetNumOpnds();
+  if (numOpnds == 0 || numOpnds > kOperandNumBinary) {
+    return kBottom;
+  }
+  LatticeValue opnds[kOperandNumBinary];
+  bool hasTop = false;
+  for (size_t i = 0; i < numOpnds; ++i) {
+    opnds[i] = Evaluate(*expr.GetOpnd(i));
+    if (opnds[i].kind == kLatticeBottom) {
+      return kBottom;
+    }
+    hasTop = hasTop || opnds[i].kind == kLatticeTop;
+  }
+  if (hasTop) {
+    return LatticeValue{kLatticeTop, 0};
+  }
+  int64 result = 0;
+  bool folded = (numOpnds == 1) ? FoldUnary(op, primType, opExpr, opnds[0].value, result)
+                                : FoldBinary(op, primType, opExpr.GetOpndType(), opnds[0].value, opnds[1].value,
+                                             result);
+  return folded ? LatticeValue{kLatticeConst, result} : kBottom;
+}
+
+template <typename PhiNode>
+void SCCP::VisitPhi(BB &bb, PhiNode &phi) {
+  MeExpr *lhs = phi.GetLHS();
+  if (!IsTrackedValue(*lhs)) {
+    return;
+  }
+  LatticeValue result = { kLatticeTop, 0 };
+  for (size_t i = 0; i < phi.GetOpnds().size() && result.kind != kLatticeBottom; ++i) {
+    if (edgeExecutable.find(std::make_pair(bb.GetPred(i)->GetBBId(), bb.GetBBId())) != edgeExecutable.end()) {
+      result = Meet(result, Evaluate(*phi.GetOpnd(i)));
+    }
+  }
+  LowerValue(*lhs, result);
+}
+
+void SCCP::VisitPhis(BB &bb) {
+  for (auto &phiPair : bb.GetMevarPhiList()) {
+    VisitPhi(bb, *phiPair.second);
+  }
+  for (auto &phiPair : bb.GetMeregphiList()) {
+    VisitPhi(bb, *phiPair.second);
+  }
+}
+
+void SCCP::VisitStmt(MeStmt &stmt) {
+  static const LatticeValue kBottom = { kLatticeBottom, 0 };
+  MeExpr *lhs = stmt.GetLHS();
+  if (lhs != nullptr && IsTrackedValue(*lhs)) {
+    if (stmt.GetOp() == OP_dassign || stmt.GetOp() == OP_regassign) {
+      LatticeValue value = Evaluate(*stmt.GetRHS());
+      if (value.kind == kLatticeConst) {
+        value.value = Truncate(value.value, lhs->GetPrimType());
+      }
+      LowerValue(*lhs, value);
+    } else {
+      LowerValue(*lhs, kBottom);
+    }
+  }
+  // may-defs and call results
+  MapleMap<OStIdx, ChiMeNode*> *chiList = stmt.GetChiList();
+  if (chiList != nullptr) {
+    for (auto &chiPair : *chiList) {
+      VarMeExpr *chiLHS = chiPair.second->GetLHS();
+      if (IsTrackedValue(*chiLHS)) {
+        LowerValue(*chiLHS, kBottom);
+      }
+    }
+  }
+  MapleVector<MustDefMeNode> *mustDefList = stmt.GetMustDefList();
+  if (mustDefList != nullptr) {
+    for (auto &mustDef : *mustDefList) {
+      MeExpr *mustDefLHS = mustDef.GetLHS();
+      if (IsTrackedValue(*mustDefLHS)) {
+        LowerValue(*mustDefLHS, kBottom);
+      }
+    }
+  }
+}
+
+// the successors of a conditional branch whose condition is a known constant
+bool SCCP::GetDecidedSucc(BB &bb, BB *&takenSucc, BB *&untakenSucc) {
+  if (bb.GetKind() != kBBCondGoto || bb.GetMeStmts().empty() || bb.GetSucc().size() != kCondGotoSuccNum) {
+    return false;
+  }
+  MeStmt *lastStmt = to_ptr(bb.GetMeStmts().rbegin());
+  if (!lastStmt->IsCondBr()) {
+    return false;
+  }
+  LatticeValue cond = Evaluate(*lastStmt->GetOpnd(0));
+  if (cond.kind != kLatticeConst) {
+    return false;
+  }
+  BB *targetBB = func.GetLabelBBAt(static_cast<CondGotoMeStmt*>(lastStmt)->GetOffset());
+  BB *fallthruBB = (bb.GetSucc(0) == targetBB) ? bb.GetSucc(1) : bb.GetSucc(0);
+  if (fallthruBB == targetBB) {
+    return false;
+  }
+  bool isTaken = ((cond.value != 0) == (lastStmt->GetOp() == OP_brtrue));
+  takenSucc = isTaken ? targetBB : fallthruBB;
+  untakenSucc = isTaken ? fallthruBB : targetBB;
+  return true;
+}
+
+// a branch whose condition is still top is treated as not decided; it does not happen in strict SSA, where the
+// definitions of the condition dominate the branch and are visited first
+void SCCP::VisitBranch(BB &bb) {
+  BB *takenSucc = nullptr;
+  BB *untakenSucc = nullptr;
+  bool isDecided = GetDecidedSucc(bb, takenSucc, untakenSucc);
+  for (BB *succ : bb.GetSucc()) {
+    if (!isDecided || succ != untakenSucc) {
+      edgeWorkList.push_back(std::make_pair(&bb, succ));
+    }
+  }
+}
+
+void SCCP::MarkEdge(BB &pred, BB &succ) {
+  if (!edgeExecutable.insert(std::make_pair(pred.GetBBId(), succ.GetBBId())).second) {
+    return;
+  }
+  VisitPhis(succ);
+  if (bbExecutable[succ.GetBBId()]) {
+    return;
+  }
+  bbExecutable[succ.GetBBId()] = true;
+  for (auto &stmt : succ.GetMeStmts()) {
+    VisitStmt(stmt);
+  }
+  VisitBranch(succ);
+}
+
+void SCCP::CollectUses(MeExpr &expr, MeStmt &stmt) {
+  if (expr.GetMeOp() == kMeOpVar || expr.GetMeOp() == kMeOpReg) {
+    stmtUses[&expr].push_back(&stmt);
+    return;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    MeExpr *opnd = expr.GetOpnd(i);
+    if (opnd != nullptr) {
+      CollectUses(*opnd, stmt);
+    }
+  }
+}
+
+void SCCP::BuildUses() {
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB *bb = *bIt;
+    for (auto &phiPair : bb->GetMevarPhiList()) {
+      for (VarMeExpr *opnd : phiPair.second->GetOpnds()) {
+        phiUses[opnd].push_back(bb);
+      }
+    }
+    for (auto &phiPair : bb->GetMeregphiList()) {
+      for (RegMeExpr *opnd : phiPair.second->GetOpnds()) {
+        phiUses[opnd].push_back(bb);
+      }
+    }
+    for (auto &stmt : bb->GetMeStmts()) {
+      for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+        MeExpr *opnd = stmt.GetOpnd(i);
+        if (opnd != nullptr) {
+          CollectUses(*opnd, stmt);
+        }
+      }
+    }
+  }
+}
+
+void SCCP::Propagate() {
+  bbExecutable.assign(func.GetAllBBs().size(), false);
+  BB *entryBB = func.GetCommonEntryBB();
+  bbExecutable[entryBB->GetBBId()] = true;
+  VisitBranch(*entryBB);
+  while (!edgeWorkList.empty() || !stmtWorkList.empty() || !phiWorkList.empty()) {
+    if (!edgeWorkList.empty()) {
+      std::pair<BB*, BB*> edge = edgeWorkList.back();
+      edgeWorkList.pop_back();
+      MarkEdge(*edge.first, *edge.second);
+    } else if (!stmtWorkList.empty()) {
+      MeStmt *stmt = stmtWorkList.back();
+      stmtWorkList.pop_back();
+      BB *bb = stmt->GetBB();
+      if (!bbExecutable[bb->GetBBId()]) {
+        continue;
+      }
+      if (stmt->IsCondBr()) {
+        VisitBranch(*bb);
+      } else {
+        VisitStmt(*stmt);
+      }
+    } else {
+      BB *bb = phiWorkList.back();
+      phiWorkList.pop_back();
+      if (bbExecutable[bb->GetBBId()]) {
+        VisitPhis(*bb);
+      }
+    }
+  }
+}
+
+// replaces the largest constant subexpressions of expr in stmt
+void SCCP::FoldOpnd(MeStmt &stmt, MeExpr &expr) {
+  MeExprOp meOp = expr.GetMeOp();
+  if (meOp == kMeOpConst) {
+    return;
+  }
+  if (meOp == kMeOpVar || meOp == kMeOpReg || meOp == kMeOpOp) {
+    LatticeValue value = Evaluate(expr);
+    if (value.kind == kLatticeConst) {
+      MeExpr *constExpr = irMap.CreateIntConstMeExpr(value.value, expr.GetPrimType());
+      if (irMap.ReplaceMeExprStmt(stmt, expr, *constExpr)) {
+        ++numFoldedExprs;
+      }
+      return;
+    }
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    MeExpr *opnd = expr.GetOpnd(i);
+    if (opnd != nullptr) {
+      FoldOpnd(stmt, *opnd);
+    }
+  }
+}
+
+void SCCP::ReplaceConstants() {
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB *bb = *bIt;
+    if (!bbExecutable[bb->GetBBId()]) {
+      continue;
+    }
+    for (auto &stmt : bb->GetMeStmts()) {
+      for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+        MeExpr *opnd = stmt.GetOpnd(i);
+        if (opnd != nullptr) {
+          FoldOpnd(stmt, *opnd);
+        }
+      }
+    }
+  }
+}
+
+void SCCP::PruneBranches() {
+  std::vector<BB*> condGotoBBs;
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB *bb = *bIt;
+    if (bbExecutable[bb->GetBBId()]) {
+      if (bb->GetKind() == kBBCondGoto) {
+        condGotoBBs.push_back(bb);
+      }
+    } else {
+      // deleted as unreachable below
+      numRemovedStmts += static_cast<uint32>(std::distance(bb->GetMeStmts().begin(), bb->GetMeStmts().end()));
+    }
+  }
+  for (BB *bb : condGotoBBs) {
+    BB *takenSucc = nullptr;
+    BB *untakenSucc = nullptr;
+    if (!GetDecidedSucc(*bb, takenSucc, untakenSucc)) {
+      continue;
+    }
+    auto *condGoto = static_cast<CondGotoMeStmt*>(to_ptr(bb->GetMeStmts().rbegin()));
+    if (takenSucc == func.GetLabelBBAt(condGoto->GetOffset())) {
+      GotoNode stmt(OP_goto);
+      GotoMeStmt *newGoto = irMap.New<GotoMeStmt>(&stmt);
+      newGoto->SetOffset(condGoto->GetOffset());
+      bb->InsertMeStmtBefore(condGoto, newGoto);
+      bb->SetKind(kBBGoto);
+    } else {
+      bb->SetKind(kBBFallthru);
+    }
+    bb->RemoveMeStmt(condGoto);
+    ++numRemovedStmts;
+    if (enabledDebug) {
+      LogInfo::MapleLogger() << "sccp: BB " << bb->GetBBId() << " never branches to BB " << untakenSucc->GetBBId()
+                             << '\n';
+    }
+    bb->RemoveSucc(untakenSucc);
+    if (untakenSucc->GetPred().size() == 1) {
+      func.GetTheCfg()->ConvertPhis2IdentityAssigns(*untakenSucc);
+    }
+    ++numPrunedEdges;
+  }
+  if (numPrunedEdges != 0) {
+    func.GetTheCfg()->UnreachCodeAnalysis(true);
+    // a loop whose exit was never taken no longer reaches the exit
+    func.GetTheCfg()->WontExitAnalysis();
+  }
+}
+
+void SCCP::Run() {
+  BuildUses();
+  Propagate();
+  ReplaceConstants();
+  PruneBranches();
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "sccp: " << func.GetName() << ": " << numFoldedExprs << " expressions folded, "
+                           << numPrunedEdges << " branch edges pruned, " << numRemovedStmts
+                           << " statements removed\n";
+  }
+}
+
+AnalysisResult *MeDoSCCP::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr*) {
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  SCCP sccp(*func, *func->GetIRMap(), DEBUGFUNC(func));
+  sccp.Run();
+  if (sccp.IsCFGChanged()) {
+    funcResMgr->InvalidAnalysisResult(MeFuncPhase_DOMINANCE, func);
+    funcResMgr->InvalidAnalysisResult(MeFuncPhase_MELOOP, func);
+  }
+  return nullptr;
+}
+}  // namespace maple
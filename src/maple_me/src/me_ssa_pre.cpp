@@ -0,0 +1,464 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_ssa_pre.h"
+
+// Each round runs in three steps:
+// 1. join candidates: the first occurrence of each expression in a join block whose predecessors all have it as
+//    only successor, with its operands translated through the phis of the block for every incoming edge;
+// 2. a dominator tree walk finds the occurrences whose value is available from a dominating occurrence (leader),
+//    and which translated expressions are available at the end of each predecessor of a join;
+// 3. code motion: a used leader saves its value to a new register right before its statement, the redundant
+//    occurrences read the register, and a join whose expression is available from at least one predecessor gets
+//    the expression computed on the other edges and a register phi replacing its occurrence.
+// An inserted computation is always followed by the occurrence in the join block, so no path computes more than
+// before. Only expressions that cannot throw are inserted; field loads qualify when their base is known non-null.
+// A handler is entered with nothing available, as the try block may throw before any leader computed its value.
+// Store sinking is not done: moving an iassign would require rebuilding the chi lists of the memory SSA.
+namespace maple {
+// later rounds handle the parents of the expressions replaced by earlier ones
+static constexpr uint32 kMaxPreRounds = 3;
+
+static bool IsPreOp(Opcode op) {
+  switch (op) {
+    case OP_add:
+    case OP_sub:
+    case OP_mul:
+    case OP_div:
+    case OP_rem:
+    case OP_band:
+    case OP_bior:
+    case OP_bxor:
+    case OP_shl:
+    case OP_lshr:
+    case OP_ashr:
+    case OP_neg:
+    case OP_bnot:
+    case OP_abs:
+    case OP_max:
+    case OP_min:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static bool IsArrayLength(const MeExpr &expr) {
+  return expr.GetOp() == OP_intrinsicop &&
+         static_cast<const NaryMeExpr&>(expr).GetIntrinsic() == INTRN_JAVA_ARRAY_LENGTH;
+}
+
+bool SSAPre::IsLeafOpnd(const MeExpr &expr) const {
+  MeExprOp meOp = expr.GetMeOp();
+  return meOp == kMeOpVar || meOp == kMeOpReg || meOp == kMeOpConst;
+}
+
+// first-order expressions only: every operand is a leaf
+bool SSAPre::IsCandidate(MeExpr &expr) const {
+  PrimType primType = expr.GetPrimType();
+  if ((!IsPrimitivePureScalar(primType) && !IsPrimitiveFloat(primType)) || GetPrimTypeSize(primType) < 4) {
+    return false;
+  }
+  switch (expr.GetMeOp()) {
+    case kMeOpOp: {
+      if (!IsPreOp(expr.GetOp())) {
+        return false;
+      }
+      bool allConst = true;
+      for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+        MeExpr *opnd = expr.GetOpnd(i);
+        if (!IsLeafOpnd(*opnd) || opnd->IsVolatile(ssaTab)) {
+          return false;
+        }
+        allConst = allConst && opnd->GetMeOp() == kMeOpConst;
+      }
+      return !allConst;
+    }
+    case kMeOpIvar: {
+      auto &ivar = static_cast<IvarMeExpr&>(expr);
+      MeExpr *base = ivar.GetBase();
+      return !ivar.IsVolatile() && ivar.GetMu() != nullptr &&
+             (base->GetMeOp() == kMeOpVar || base->GetMeOp() == kMeOpReg) && !base->IsVolatile(ssaTab);
+    }
+    case kMeOpNary: {
+      MeExpr *array = IsArrayLength(expr) ? expr.GetOpnd(0) : nullptr;
+      return array != nullptr && (array->GetMeOp() == kMeOpVar || array->GetMeOp() == kMeOpReg) &&
+             !array->IsVolatile(ssaTab);
+    }
+    default:
+      return false;
+  }
+}
+
+void SSAPre::CollectCandidates(MeExpr &expr, std::vector<MeExpr*> &exprs) const {
+  // operands that may not be evaluated
+  Opcode op = expr.GetOp();
+  if (op == OP_select || op == OP_cand || op == OP_cior) {
+    return;
+  }
+  if (IsCandidate(expr)) {
+    if (std::find(exprs.begin(), exprs.end(), &expr) == exprs.end()) {
+      exprs.push_back(&expr);
+    }
+    return;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    MeExpr *opnd = expr.GetOpnd(i);
+    if (opnd != nullptr) {
+      CollectCandidates(*opnd, exprs);
+    }
+  }
+}
+
+void SSAPre::CollectCandidates(MeStmt &stmt, std::vector<MeExpr*> &exprs) const {
+  for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+    MeExpr *opnd = stmt.GetOpnd(i);
+    if (opnd != nullptr) {
+      CollectCandidates(*opnd, exprs);
+    }
+  }
+}
+
+// this of an instance method, or a newly allocated object
+bool SSAPre::IsNonNull(MeExpr &expr) const {
+  MeStmt *defStmt = nullptr;
+  if (expr.GetMeOp() == kMeOpVar) {
+    auto &var = static_cast<VarMeExpr&>(expr);
+    MIRFunction *mirFunc = func.GetMirFunc();
+    if (var.GetDefBy() == kDefByNo && !mirFunc->IsStatic() && mirFunc->GetFormalCount() > 0 &&
+        ssaTab.GetMIRSymbolFromID(var.GetOStIdx()) == mirFunc->GetFormal(0)) {
+      return true;
+    }
+    defStmt = var.GetDefBy() == kDefByStmt ? var.GetDefStmt() : nullptr;
+  } else if (expr.GetMeOp() == kMeOpReg) {
+    auto &reg = static_cast<RegMeExpr&>(expr);
+    defStmt = reg.GetDefBy() == kDefByStmt ? reg.GetDefStmt() : nullptr;
+  }
+  if (defStmt == nullptr || defStmt->GetRHS() == nullptr) {
+    return false;
+  }
+  MeExpr *rhs = defStmt->GetRHS();
+  return rhs->GetMeOp() == kMeOpGcmalloc || rhs->GetOp() == OP_gcmallocjarray || rhs->GetOp() == OP_gcpermallocjarray;
+}
+
+bool SSAPre::MayThrow(MeExpr &expr) const {
+  if (expr.GetMeOp() == kMeOpIvar) {
+    return !IsNonNull(*static_cast<IvarMeExpr&>(expr).GetBase());
+  }
+  if (IsArrayLength(expr)) {
+    return !IsNonNull(*expr.GetOpnd(0));
+  }
+  return kOpcodeInfo.MayThrowException(expr.GetOp());
+}
+
+// the value opnd has on the edge from the predIdx-th predecessor of joinBB
+MeExpr *SSAPre::TranslateOpnd(MeExpr &opnd, const BB &joinBB, size_t predIdx) const {
+  if (opnd.GetMeOp() == kMeOpVar && static_cast<VarMeExpr&>(opnd).GetDefBy() == kDefByPhi) {
+    MeVarPhiNode &phi = static_cast<VarMeExpr&>(opnd).GetDefPhi();
+    return phi.GetDefBB() == &joinBB ? phi.GetOpnds().at(predIdx) : &opnd;
+  }
+  if (opnd.GetMeOp() == kMeOpReg && static_cast<RegMeExpr&>(opnd).GetDefBy() == kDefByPhi) {
+    MeRegPhiNode &phi = static_cast<RegMeExpr&>(opnd).GetDefPhi();
+    return phi.GetDefBB() == &joinBB ? phi.GetOpnds().at(predIdx) : &opnd;
+  }
+  return &opnd;
+}
+
+MeExpr *SSAPre::Translate(MeExpr &expr, const BB &joinBB, size_t predIdx) {
+  bool changed = false;
+  switch (expr.GetMeOp()) {
+    case kMeOpOp: {
+      OpMeExpr opMeExpr(static_cast<OpMeExpr&>(expr), kInvalidExprID);
+      for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+        MeExpr *opnd = TranslateOpnd(*expr.GetOpnd(i), joinBB, predIdx);
+        changed = changed || opnd != expr.GetOpnd(i);
+        opMeExpr.SetOpnd(i, opnd);
+      }
+      return changed ? irMap.HashMeExpr(opMeExpr) : &expr;
+    }
+    case kMeOpIvar: {
+      auto &ivar = static_cast<IvarMeExpr&>(expr);
+      IvarMeExpr ivarMeExpr(kInvalidExprID, ivar);
+      MeExpr *base = TranslateOpnd(*ivar.GetBase(), joinBB, predIdx);
+      MeExpr *mu = TranslateOpnd(*ivar.GetMu(), joinBB, predIdx);
+      ivarMeExpr.SetBase(base);
+      ivarMeExpr.SetMuVal(static_cast<VarMeExpr*>(mu));
+      changed = base != ivar.GetBase() || mu != ivar.GetMu();
+      return changed ? irMap.HashMeExpr(ivarMeExpr) : &expr;
+    }
+    case kMeOpNary: {
+      NaryMeExpr naryMeExpr(&irMap.GetIRMapAlloc(), kInvalidExprID, static_cast<NaryMeExpr&>(expr));
+      MeExpr *array = TranslateOpnd(*expr.GetOpnd(0), joinBB, predIdx);
+      naryMeExpr.SetOpnd(0, array);
+      return array != expr.GetOpnd(0) ? irMap.HashMeExpr(naryMeExpr) : &expr;
+    }
+    default:
+      CHECK_FATAL(false, "not a pre candidate");
+      return nullptr;
+  }
+}
+
+// no operand is redefined in bb before the occurrence, only by the phis of bb
+bool SSAPre::IsUpwardExposed(MeExpr &expr, const BB &bb) const {
+  std::vector<MeExpr*> opnds;
+  if (expr.GetMeOp() == kMeOpIvar) {
+    opnds.push_back(static_cast<IvarMeExpr&>(expr).GetBase());
+    opnds.push_back(static_cast<IvarMeExpr&>(expr).GetMu());
+  } else {
+    for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+      opnds.push_back(expr.GetOpnd(i));
+    }
+  }
+  for (MeExpr *opnd : opnds) {
+    if (opnd->GetMeOp() == kMeOpVar) {
+      auto *var = static_cast<VarMeExpr*>(opnd);
+      if (var->DefByBB() == &bb && var->GetDefBy() != kDefByPhi) {
+        return false;
+      }
+    } else if (opnd->GetMeOp() == kMeOpReg) {
+      auto *reg = static_cast<RegMeExpr*>(opnd);
+      if (reg->DefByBB() == &bb && reg->GetDefBy() != kDefByPhi) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void SSAPre::CollectJoinCandidates() {
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    BB *bb = *bIt;
+    if (bb == func.GetCommonExitBB() || bb->GetPred().size() < 2 || bb->GetAttributes(kBBAttrIsCatch)) {
+      continue;
+    }
+    // computations are inserted at the end of the predecessors
+    bool canInsert = true;
+    for (BB *pred : bb->GetPred()) {
+      canInsert = canInsert && pred->GetSucc().size() == 1;
+    }
+    if (!canInsert) {
+      continue;
+    }
+    std::set<MeExpr*> seen;
+    for (auto &stmt : bb->GetMeStmts()) {
+      std::vector<MeExpr*> exprs;
+      CollectCandidates(stmt, exprs);
+      for (MeExpr *expr : exprs) {
+        if (!seen.insert(expr).second || !IsUpwardExposed(*expr, *bb)) {
+          continue;
+        }
+        JoinCandidate join = {bb, &stmt, expr, -1, {}, {}};
+        for (size_t i = 0; i < bb->GetPred().size(); ++i) {
+          join.predExprs.push_back(Translate(*expr, *bb, i));
+          join.predLeaders.push_back(-1);
+          predEnds[bb->GetPred(i)->GetBBId()].push_back(std::make_pair(joins.size(), i));
+        }
+        joinOfOcc[std::make_pair(&stmt, expr)] = joins.size();
+        joins.push_back(join);
+      }
+    }
+  }
+}
+
+void SSAPre::FindRedundancies(BB &bb) {
+  std::unordered_map<MeExpr*, int32> outerLeaders;
+  std::vector<MeExpr*> outerStack;
+  bool isCatch = bb.GetAttributes(kBBAttrIsCatch);
+  if (isCatch) {
+    outerLeaders.swap(availLeaders);
+    outerStack.swap(availStack);
+  }
+  size_t availMark = availStack.size();
+  for (auto &stmt : bb.GetMeStmts()) {
+    std::vector<MeExpr*> exprs;
+    CollectCandidates(stmt, exprs);
+    for (MeExpr *expr : exprs) {
+      auto occIdx = static_cast<int32>(occurrences.size());
+      auto availIt = availLeaders.find(expr);
+      int32 leader = availIt == availLeaders.end() ? -1 : availIt->second;
+      occurrences.push_back(Occurrence{&stmt, expr, leader});
+      leaderUsed.push_back(false);
+      if (leader >= 0) {
+        leaderUsed[leader] = true;
+        continue;
+      }
+      availLeaders[expr] = occIdx;
+      availStack.push_back(expr);
+      auto joinIt = joinOfOcc.find(std::make_pair(&stmt, expr));
+      if (joinIt != joinOfOcc.end()) {
+        joins[joinIt->second].occIdx = occIdx;
+      }
+    }
+  }
+  auto predEndIt = predEnds.find(bb.GetBBId());
+  if (predEndIt != predEnds.end()) {
+    for (auto &operand : predEndIt->second) {
+      JoinCandidate &join = joins[operand.first];
+      auto availIt = availLeaders.find(join.predExprs[operand.second]);
+      if (availIt != availLeaders.end()) {
+        join.predLeaders[operand.second] = availIt->second;
+      }
+    }
+  }
+  const MapleSet<BBId> &domChildren = dom.GetDomChildren(bb.GetBBId());
+  for (const BBId &childID : domChildren) {
+    BB *child = func.GetBBFromID(childID);
+    if (child != nullptr) {
+      FindRedundancies(*child);
+    }
+  }
+  while (availStack.size() > availMark) {
+    (void)availLeaders.erase(availStack.back());
+    availStack.pop_back();
+  }
+  if (isCatch) {
+    outerLeaders.swap(availLeaders);
+    outerStack.swap(availStack);
+  }
+}
+
+void SSAPre::ResetRound() {
+  occurrences.clear();
+  joins.clear();
+  joinOfOcc.clear();
+  predEnds.clear();
+  availLeaders.clear();
+  availStack.clear();
+  leaderUsed.clear();
+  leaderRegs.clear();
+}
+
+// worth doing when the value comes from a predecessor already, and safe when the other edges cannot throw
+bool SSAPre::PerformJoin(JoinCandidate &join) {
+  if (join.occIdx < 0) {
+    return false;
+  }
+  bool anyAvail = false;
+  for (size_t i = 0; i < join.predExprs.size(); ++i) {
+    if (join.predLeaders[i] >= 0) {
+      anyAvail = true;
+    } else if (MayThrow(*join.predExprs[i])) {
+      return false;
+    }
+  }
+  if (!anyAvail) {
+    return false;
+  }
+  leaderUsed[join.occIdx] = true;
+  for (int32 predLeader : join.predLeaders) {
+    if (predLeader >= 0) {
+      leaderUsed[predLeader] = true;
+    }
+  }
+  leaderRegs[join.occIdx] = irMap.CreateRegMeExpr(join.expr->GetPrimType());
+  return true;
+}
+
+bool SSAPre::RunRound() {
+  ResetRound();
+  CollectJoinCandidates();
+  FindRedundancies(*func.GetCommonEntryBB());
+  leaderRegs.resize(occurrences.size(), nullptr);
+  std::vector<JoinCandidate*> performedJoins;
+  for (JoinCandidate &join : joins) {
+    if (PerformJoin(join)) {
+      performedJoins.push_back(&join);
+    }
+  }
+  bool changed = false;
+  // leaders save their value right before their statement
+  for (size_t i = 0; i < occurrences.size(); ++i) {
+    Occurrence &occ = occurrences[i];
+    if (occ.leader >= 0 || !leaderUsed[i] || leaderRegs[i] != nullptr) {
+      continue;
+    }
+    RegMeExpr *reg = irMap.CreateRegMeExpr(occ.expr->GetPrimType());
+    BB *bb = occ.stmt->GetBB();
+    RegassignMeStmt *regAssign = irMap.CreateRegassignMeStmt(*reg, *occ.expr, *bb);
+    bb->InsertMeStmtBefore(occ.stmt, regAssign);
+    (void)irMap.ReplaceMeExprStmt(*occ.stmt, *occ.expr, *reg);
+    leaderRegs[i] = reg;
+    changed = true;
+  }
+  // the joins merge the values of their incoming edges
+  for (JoinCandidate *join : performedJoins) {
+    RegMeExpr *phiReg = leaderRegs[join->occIdx];
+    MeRegPhiNode *phi = irMap.CreateMeRegPhi(*phiReg);
+    phi->SetDefBB(join->bb);
+    for (size_t i = 0; i < join->predExprs.size(); ++i) {
+      BB *pred = join->bb->GetPred(i);
+      RegMeExpr *predReg = irMap.CreateRegMeExprVersion(*phiReg);
+      int32 predLeader = join->predLeaders[i];
+      MeExpr *rhs = predLeader >= 0 ? leaderRegs[predLeader] : join->predExprs[i];
+      pred->InsertMeStmtLastBr(irMap.CreateRegassignMeStmt(*predReg, *rhs, *pred));
+      phi->GetOpnds().push_back(predReg);
+      (void)predReg->GetPhiUseSet().insert(phi);
+      if (predLeader < 0) {
+        ++numInserted;
+      }
+    }
+    (void)join->bb->GetMeregphiList().insert(std::make_pair(phiReg->GetOstIdx(), phi));
+    (void)irMap.ReplaceMeExprStmt(*join->stmt, *join->expr, *phiReg);
+    ++numReused;
+    changed = true;
+    if (enabledDebug) {
+      LogInfo::MapleLogger() << "ssapre: merge at BB " << join->bb->GetBBId() << ": ";
+      join->expr->Dump(&irMap);
+      LogInfo::MapleLogger() << '\n';
+    }
+  }
+  // redundant occurrences read the value of their leader
+  for (Occurrence &occ : occurrences) {
+    if (occ.leader < 0) {
+      continue;
+    }
+    (void)irMap.ReplaceMeExprStmt(*occ.stmt, *occ.expr, *leaderRegs[occ.leader]);
+    ++numReused;
+    changed = true;
+    if (enabledDebug) {
+      LogInfo::MapleLogger() << "ssapre: reuse in BB " << occ.stmt->GetBB()->GetBBId() << ": ";
+      occ.expr->Dump(&irMap);
+      LogInfo::MapleLogger() << '\n';
+    }
+  }
+  return changed;
+}
+
+void SSAPre::Run() {
+  for (uint32 round = 0; round < kMaxPreRounds; ++round) {
+    if (!RunRound()) {
+      break;
+    }
+  }
+  if (enabledDebug && numReused != 0) {
+    LogInfo::MapleLogger() << "ssapre: " << func.GetName() << ": " << numReused << " occurrences reused, "
+                           << numInserted << " computations inserted\n";
+  }
+}
+
+AnalysisResult *MeDoSSAPre::Run(MeFunction *func, MeFuncResultMgr *funcResMgr, ModuleResultMgr*) {
+  auto *dom = static_cast<Dominance*>(funcResMgr->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_FATAL(dom != nullptr, "dominance phase has problem");
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(funcResMgr->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  SSAPre ssaPre(*func, *dom, DEBUGFUNC(func));
+  ssaPre.Run();
+  return nullptr;
+}
+}  // namespace maple
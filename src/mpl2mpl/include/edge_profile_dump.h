@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MPL2MPL_INCLUDE_EDGE_PROFILE_DUMP_H
+#define MPL2MPL_INCLUDE_EDGE_PROFILE_DUMP_H
+#include "module_phase.h"
+#include "mir_builder.h"
+
+namespace maple {
+// Writes out the edge counters added by the edgeprofile phase of me. A function is added to the module that appends
+// the counter table as "<index> <count>" lines to MeOption::edgeProfileGen plus ".counts", and each function entry
+// registers it with atexit the first time it runs. Runs after me, which walks the function list of the module.
+class EdgeProfileDump {
+ public:
+  EdgeProfileDump(MIRModule &mod, bool trace) : mirModule(mod), builder(mod.GetMIRBuilder()), trace(trace) {}
+
+  ~EdgeProfileDump() = default;
+
+  void Run();
+
+ private:
+  MIRFunction &CreateDumpFunction(const MIRSymbol &counterTable, uint32 numCounters);
+  void InsertRegistration(MIRFunction &func, const MIRSymbol &registered, const MIRFunction &dumpFunc,
+                          const MIRFunction &atexitFunc) const;
+  MIRModule &mirModule;
+  MIRBuilder *builder;
+  bool trace;
+};
+
+class DoEdgeProfileDump : public ModulePhase {
+ public:
+  explicit DoEdgeProfileDump(ModulePhaseID id) : ModulePhase(id) {}
+
+  ~DoEdgeProfileDump() = default;
+
+  std::string PhaseName() const override {
+    return "edgeprofiledump";
+  }
+
+  AnalysisResult *Run(MIRModule *mod, ModuleResultMgr *mrm) override;
+};
+}  // namespace maple
+#endif  // MPL2MPL_INCLUDE_EDGE_PROFILE_DUMP_H
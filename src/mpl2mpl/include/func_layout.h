@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MPL2MPL_INCLUDE_FUNC_LAYOUT_H
+#define MPL2MPL_INCLUDE_FUNC_LAYOUT_H
+#include "module_phase.h"
+#include "mir_function.h"
+
+namespace maple {
+// Reorders the functions of the module from the call traces in Options::funcLayoutProfile, one record per line:
+//     boot <function>                   <function> ran during startup
+//     run <function>                    <function> ran after startup
+//     edge <caller> <callee> <count>    <caller> called <callee> <count> times
+// Functions are grouped by LayoutType (boot hot, both hot, run hot, then unused), and the functions of each hot
+// group are clustered along their most frequent call edges (C3 ordering), so that hot code shares pages.
+class FuncLayout {
+ public:
+  FuncLayout(MIRModule &mod, bool trace) : mirModule(mod), trace(trace) {}
+
+  ~FuncLayout() = default;
+
+  void Run();
+
+ private:
+  struct FuncInfo {
+    bool bootRun = false;
+    bool runtimeRun = false;
+    uint64 callCount = 0;  // calls received, as recorded by the edges
+    uint32 size = 1;       // number of statements, stands for the code size
+    std::map<PUIdx, uint64> callers;  // keyed by PUIdx to keep the order deterministic
+  };
+
+  // a run of functions laid out together
+  struct Cluster {
+    std::vector<MIRFunction*> funcs;
+    uint64 callCount = 0;
+    uint32 size = 0;
+  };
+
+  bool ReadProfile();
+  void SetLayoutTypes();
+  uint32 CountStmts(const MIRFunction &func) const;
+  std::vector<MIRFunction*> OrderGroup(const std::vector<MIRFunction*> &group);
+  MIRModule &mirModule;
+  bool trace;
+  std::map<std::string, MIRFunction*> funcOfName;
+  std::map<MIRFunction*, FuncInfo> funcInfos;
+};
+
+class DoFuncLayout : public ModulePhase {
+ public:
+  explicit DoFuncLayout(ModulePhaseID id) : ModulePhase(id) {}
+
+  ~DoFuncLayout() = default;
+
+  std::string PhaseName() const override {
+    return "funclayout";
+  }
+
+  AnalysisResult *Run(MIRModule *mod, ModuleResultMgr *mrm) override;
+};
+}  // namespace maple
+#endif  // MPL2MPL_INCLUDE_FUNC_LAYOUT_H
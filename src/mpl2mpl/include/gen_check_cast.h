@@ -22,6 +22,7 @@ namespace maple {
 static constexpr char kMCCReflectThrowCastException[] = "MCC_Reflect_ThrowCastException";
 static constexpr char kMCCReflectCheckCastingNoArray[] = "MCC_Reflect_Check_Casting_NoArray";
 static constexpr char kMCCReflectCheckCastingArray[] = "MCC_Reflect_Check_Casting_Array";
+static constexpr char kCheckCastCachePrefix[] = "__checkcast_cache_";
 
 
 class CheckCastGenerator : public FuncOptimizeImpl {
@@ -34,6 +35,7 @@ class CheckCastGenerator : public FuncOptimizeImpl {
   }
 
   void ProcessFunc(MIRFunction *func) override;
+  void Finish() override;
 
  private:
   MIRType *pointerObjType = nullptr;
@@ -42,6 +44,9 @@ class CheckCastGenerator : public FuncOptimizeImpl {
   MIRFunction *throwCastException = nullptr;
   MIRFunction *checkCastingNoArray = nullptr;
   MIRFunction *checkCastingArray = nullptr;
+  uint32 numExactSites = 0;
+  uint32 numCachedSites = 0;
+  uint32 numRuntimeSites = 0;
 
   void InitTypes();
   void InitFuncs();
@@ -49,6 +54,8 @@ class CheckCastGenerator : public FuncOptimizeImpl {
   void GenCheckCast(BaseNode &stmt);
   BaseNode *GetObjectShadow(BaseNode *opnd);
   MIRSymbol *GetOrCreateClassInfoSymbol(const std::string &className);
+  bool IsExactCheckKlass(const Klass &klass) const;
+  MIRSymbol *CreateCheckCastCacheSymbol();
 };
 
 class DoCheckCastGeneration : public ModulePhase {
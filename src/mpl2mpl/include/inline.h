@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MPL2MPL_INCLUDE_INLINE_H
+#define MPL2MPL_INCLUDE_INLINE_H
+#include "module_phase.h"
+#include "mir_builder.h"
+#include "mir_function.h"
+
+namespace maple {
+// Inlines small direct callees (call, callassigned) into their callers before the ME optimizations run.
+// Functions are visited bottom-up over the call graph, so a callee has already absorbed its own small callees when
+// its size is measured; a call closing a cycle is never inlined. A call site is inlined when the callee has at most
+// Options::inlineLimit statements, the limit growing with the loop depth of the site as a static estimate of its
+// frequency, and as long as the caller stays within kMaxGrowthFactor times its original size.
+// Bodies of other modules are read from Options::inlineImport, a file another module wrote with
+// Options::inlineExport; they are only used for inlining and stay external functions of this module.
+class MInline {
+ public:
+  MInline(MIRModule &mod, bool trace) : mirModule(mod), builder(*mod.GetMIRBuilder()), trace(trace) {}
+
+  ~MInline() = default;
+
+  void Run();
+
+ private:
+  // the caller entities standing for the locals, pregs and labels of the callee at one inlined call site
+  struct CloneMaps {
+    std::map<uint32, StIdx> symbols;  // keyed by the callee local StIdx::Idx()
+    std::map<PregIdx, PregIdx> pregs;
+    std::map<LabelIdx, LabelIdx> labels;
+  };
+
+  void ImportCandidates();
+  void ExportCandidates();
+  void ReleaseImported();
+  uint32 CountStmts(const MIRFunction &func) const;
+  bool IsImported(const MIRFunction &func) const;
+  bool IsCallerSensitive(const MIRFunction &func) const;
+  bool IsInlinable(const MIRFunction &func) const;
+  bool HasTry(const MIRFunction &func) const;
+  MIRFunction *GetDirectCallee(const StmtNode &stmt) const;
+  std::vector<MIRFunction*> GetCallees(const MIRFunction &func) const;
+  void BuildBottomUpOrder();
+  std::map<const StmtNode*, uint32> ComputeLoopDepths(const MIRFunction &func) const;
+  StIdx MapSymbol(MIRFunction &callee, StIdx stIdx, CloneMaps &maps);
+  PregIdx MapPreg(MIRFunction &caller, MIRFunction &callee, PregIdx pregIdx, CloneMaps &maps) const;
+  LabelIdx MapLabel(MIRFunction &caller, LabelIdx labelIdx, CloneMaps &maps);
+  void RenameExpr(MIRFunction &caller, MIRFunction &callee, BaseNode &expr, CloneMaps &maps);
+  void RenameStmt(MIRFunction &caller, MIRFunction &callee, StmtNode &stmt, CloneMaps &maps);
+  StmtNode *CreateReturnAssign(MIRFunction &caller, CallNode &call, BaseNode &value);
+  void InlineCall(MIRFunction &caller, CallNode &call, MIRFunction &callee);
+  void InlineCalls(MIRFunction &caller);
+  MIRModule &mirModule;
+  MIRBuilder &builder;
+  bool trace;
+  std::vector<MIRFunction*> bottomUpOrder;
+  std::map<PUIdx, uint32> postOrderIndex;
+  // statement counts, kept up to date as callers grow
+  std::map<PUIdx, uint32> funcSizes;
+  // attributes of the functions declared before the import, the imported definitions override them
+  std::map<PUIdx, FuncAttrs> declaredAttrs;
+  uint32 numInlinedCalls = 0;
+  uint32 numImportedInlined = 0;
+  uint32 stmtsBefore = 0;
+  uint32 stmtsAfter = 0;
+};
+
+class DoInline : public ModulePhase {
+ public:
+  explicit DoInline(ModulePhaseID id) : ModulePhase(id) {}
+
+  ~DoInline() = default;
+
+  std::string PhaseName() const override {
+    return "inline";
+  }
+
+  AnalysisResult *Run(MIRModule *mod, ModuleResultMgr *mrm) override;
+};
+}  // namespace maple
+#endif  // MPL2MPL_INCLUDE_INLINE_H
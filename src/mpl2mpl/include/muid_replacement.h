@@ -93,11 +93,18 @@ class MUIDReplacement : public FuncOptimizeImpl {
   static MUID mplMuid;
   std::string mplMuidStr;
   using SymIdxPair = std::pair<MIRSymbol*, uint32>;
-  std::map<MUID, SymIdxPair> funcDefMap;
-  std::map<MUID, SymIdxPair> dataDefMap;
-  std::map<MUID, SymIdxPair> funcUndefMap;
-  std::map<MUID, SymIdxPair> dataUndefMap;
-  std::map<MUID, uint32> defMuidIdxMap;
+  using MUIDSymIdxPair = std::pair<MUID, SymIdxPair>;
+  // Flat tables sorted by an increasing order of MUID. They are emitted in this order,
+  // so both the compiler and the runtime linker can binary search them.
+  using MUIDSymIdxTable = std::vector<MUIDSymIdxPair>;
+  MUIDSymIdxTable funcDefTable;
+  MUIDSymIdxTable dataDefTable;
+  MUIDSymIdxTable funcUndefTable;
+  MUIDSymIdxTable dataUndefTable;
+  // Indexed by the muid-order index of funcDefTable, gives the index in address order
+  // kInvalidDefMuidIdx marks entries whose function has no body in this module
+  static constexpr uint32 kInvalidDefMuidIdx = 0xFFFFFFFF;
+  std::vector<uint32> defMuidIdxVec;
   enum LazyBindingOption : uint32 {
     kNoLazyBinding = 0,
     kConservativeLazyBinding = 1,
@@ -109,6 +116,9 @@ class MUIDReplacement : public FuncOptimizeImpl {
   void GenericDataDefTable();
   void GenericUnifiedUndefTable();
   void GenericRangeTable();
+  const MUID &GetSymbolMUID(const MIRSymbol &mirSymbol);
+  void BuildMUIDTable(const std::vector<MIRSymbol*> &symbols, MUIDSymIdxTable &table) const;
+  static const MUIDSymIdxPair *FindFromMUIDTable(const MUIDSymIdxTable &table, const MUID &muid);
   uint32 FindIndexFromDefTable(const MIRSymbol &mirSymbol, bool isFunc);
   uint32 FindIndexFromUndefTable(const MIRSymbol &mirSymbol, bool isFunc);
   void ReplaceAddroffuncConst(MIRConst *&entry, uint32 fieldID, bool isVtab);
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MPL2MPL_INCLUDE_SWITCH_LOWERING_H
+#define MPL2MPL_INCLUDE_SWITCH_LOWERING_H
+#include "phase_impl.h"
+#include "module_phase.h"
+
+namespace maple {
+// Lowers switch statements before code generation. The sorted cases are split into clusters: a run of at least
+// kMinJumpTableCases cases whose values fill at least Options::switchDensity percent of their range becomes a
+// rangegoto jump table, any other case is compared on its own. The clusters are searched with a balanced binary tree
+// of compares that ends in short linear sequences, so a dispatch costs a logarithmic number of branches.
+class SwitchLowerer : public FuncOptimizeImpl {
+ public:
+  SwitchLowerer(MIRModule *mod, KlassHierarchy *kh, bool trace);
+  ~SwitchLowerer() = default;
+
+  FuncOptimizeImpl *Clone() override {
+    return new SwitchLowerer(*this);
+  }
+
+  void ProcessFunc(MIRFunction *func) override;
+
+ private:
+  // the sorted cases [first, last], dispatched by a jump table or, for a single case, by a compare
+  struct Cluster {
+    size_t first;
+    size_t last;
+    bool isJumpTable;
+  };
+
+  void LowerBlock(BlockNode &block);
+  void ClusterCases();
+  bool IsDense(size_t first, size_t last) const;
+  BaseNode *ReadSelector();
+  void Insert(StmtNode &stmt);
+  void EmitCompare(Opcode op, int32 value, LabelIdx target);
+  void EmitJumpTable(const Cluster &cluster);
+  void EmitClusters(size_t first, size_t last);
+  void LowerSwitch(BlockNode &block, SwitchNode &switchNode);
+  // the switch being lowered
+  BlockNode *curBlock = nullptr;
+  SwitchNode *curSwitch = nullptr;
+  std::vector<CasePair> cases;
+  std::vector<Cluster> clusters;
+  PregIdx selector = 0;
+  PrimType selectorType = PTY_i32;
+  uint32 numSwitches = 0;
+  uint32 numJumpTables = 0;
+  uint32 numCompares = 0;
+};
+
+class DoSwitchLowering : public ModulePhase {
+ public:
+  explicit DoSwitchLowering(ModulePhaseID id) : ModulePhase(id) {}
+
+  ~DoSwitchLowering() = default;
+
+  std::string PhaseName() const override {
+    return "switchlowering";
+  }
+
+  AnalysisResult *Run(MIRModule *mod, ModuleResultMgr *mrm) override {
+    OPT_TEMPLATE(SwitchLowerer);
+    return nullptr;
+  }
+};
+}  // namespace maple
+#endif  // MPL2MPL_INCLUDE_SWITCH_LOWERING_H
@@ -34,18 +34,27 @@ class VtableAnalysis : public FuncOptimizeImpl {
   ~VtableAnalysis() = default;
   static std::string DecodeBaseNameWithType(const MIRFunction &func);
   void ProcessFunc(MIRFunction *func) override;
+  void Finish() override;
   FuncOptimizeImpl *Clone() override {
     return new VtableAnalysis(*this);
   }
 
  private:
+  // Vtable slots of a class indexed by GetBaseFuncNameWithTypeStrIdx(), in increasing order.
+  // One name may own several slots when a package-private method is not overridden across packages.
+  using VtableIndexMap = std::unordered_map<GStrIdx, std::vector<uint32>, GStrIdxHash>;
   std::unordered_map<PUIdx, int> puidxToVtabIndex;
+  std::unordered_map<const MIRStructType*, VtableIndexMap> vtableIndexMaps;
   MIRType *voidPtrType;
   MIRIntConst *zeroConst;
   MIRIntConst *oneConst;
+  uint32 numDynamicCalls = 0;
+  uint32 numDevirtualizedCalls = 0;
+  uint32 numGuardedCalls = 0;
   bool IsVtableCandidate(const MIRFunction &func) const;
   bool CheckOverrideForCrossPackage(const MIRFunction &baseMethod, const MIRFunction &currMethod) const;
-  void AddMethodToTable(MethodPtrVector &methodTable, MethodPair &methodpair);
+  void AddMethodToTable(MethodPtrVector &methodTable, VtableIndexMap &indexMap, MethodPair &methodpair);
+  int FindVtableSlot(const MIRStructType &structType, GStrIdx strIdx) const;
   void GenVtableList(const Klass &klass);
   void DumpVtableList(const Klass *klass) const;
   void GenTableSymbol(const std::string &prefix, const std::string klassName, MIRAggConst &newconst);
@@ -53,6 +62,11 @@ class VtableAnalysis : public FuncOptimizeImpl {
   void GenItableDefinition(const Klass &klass);
 
   BaseNode *GenVtabItabBaseAddr(BaseNode *obj, bool isVirtual);
+  MIRFunction *GetProvenTarget(const Klass &klass, GStrIdx strIdx) const;
+  MIRFunction *GetGuardTarget(const Klass &klass, GStrIdx strIdx, const Klass *&guardKlass) const;
+  MIRSymbol *GetOrCreateClassInfoSymbol(const Klass &klass);
+  void GenGuardedCall(CallNode &stmt, const Klass &guardKlass, const MIRFunction &target);
+  bool Devirtualize(CallNode &stmt);
   void ReplaceVirtualInvoke(CallNode &stmt);
   void ReplaceInterfaceInvoke(CallNode &stmt);
   void ReplaceSuperclassInvoke(CallNode &stmt);
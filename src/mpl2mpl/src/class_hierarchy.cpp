@@ -415,17 +415,42 @@ bool KlassHierarchy::UpdateFieldID(TyIdx baseTypeIdx, TyIdx targetTypeIdx, Field
   return false;
 }
 
+// A <clinit> that only returns has nothing to run, so its class can start out initialized.
+// A <clinit> without a body in this module is assumed to do real work.
+static bool HasNonTrivialClinit(const Klass &klass) {
+  const MIRFunction *clinit = klass.GetClinit();
+  if (clinit == nullptr) {
+    return false;
+  }
+  if (clinit->GetBody() == nullptr) {
+    return true;
+  }
+  for (auto &stmt : clinit->GetBody()->GetStmtNodes()) {
+    Opcode op = stmt.GetOpCode();
+    if (op == OP_comment || op == OP_label || (op == OP_return && stmt.NumOpnds() == 0)) {
+      continue;
+    }
+    // Inserted before each return by rclowering, with no operands it releases nothing.
+    if (op == OP_intrinsiccall && stmt.NumOpnds() == 0 &&
+        static_cast<const IntrinsiccallNode&>(stmt).GetIntrinsic() == INTRN_MPL_CLEANUP_LOCALREFVARS) {
+      continue;
+    }
+    return true;
+  }
+  return false;
+}
+
 bool KlassHierarchy::NeedClinitCheckRecursively(Klass &kl) {
   Klass *klass = &kl;
   if (klass->IsClass()) {
     while (klass != nullptr) {
-      if (klass->GetClinit()) {
+      if (HasNonTrivialClinit(*klass)) {
         return true;
       }
       klass = klass->GetSuperKlass();
     }
     for (Klass *implInterface : kl.GetImplInterfaces()) {
-      if (implInterface->GetClinit()) {
+      if (HasNonTrivialClinit(*implInterface)) {
         for (auto &func : implInterface->GetMethods()) {
           if (!func->GetAttr(FUNCATTR_abstract) && !func->GetAttr(FUNCATTR_static)) {
             return true;
@@ -435,7 +460,7 @@ bool KlassHierarchy::NeedClinitCheckRecursively(Klass &kl) {
     }
     return false;
   } else if (klass->IsInterface()) {
-    return klass->GetClinit();
+    return HasNonTrivialClinit(*klass);
   } else {
     return true;
   }
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "edge_profile_dump.h"
+#include "me_edge_profile.h"
+#include "me_option.h"
+
+namespace maple {
+static constexpr char kEdgeDumpFuncPrefixStr[] = "__edgeprof_dump";
+static constexpr char kEdgeRegisteredPrefixStr[] = "__edgeprof_registered";
+static constexpr char kEdgeCountsSuffixStr[] = ".counts";
+
+static ConststrNode *CreateStrNode(MIRFunction &func, const std::string &str) {
+  UStrIdx strIdx = GlobalTables::GetUStrTable().GetOrCreateStrIdxFromName(str);
+  ConststrNode *strNode = func.GetCodeMempool()->New<ConststrNode>(strIdx);
+  strNode->SetPrimType(PTY_ptr);
+  return strNode;
+}
+
+//   callassigned &fopen (conststr ptr "<map>.counts", conststr ptr "a") { dassign %file 0 }
+//   brtrue @done (eq u1 ptr (dread ptr %file, constval ptr 0))
+//   dassign %index 0 (constval u32 0)
+// @loop
+//   brfalse @close (lt u1 u32 (dread u32 %index, constval u32 <numCounters>))
+//   call &fprintf (dread ptr %file, conststr ptr "%u %llu\n", dread u32 %index, iread u64 <* u64> 0 (array ...))
+//   dassign %index 0 (add u32 (dread u32 %index, constval u32 1))
+//   goto @loop
+// @close
+//   call &fclose (dread ptr %file)
+// @done
+//   return ()
+MIRFunction &EdgeProfileDump::CreateDumpFunction(const MIRSymbol &counterTable, uint32 numCounters) {
+  MIRType *u1Type = GlobalTables::GetTypeTable().GetUInt1();
+  MIRType *u32Type = GlobalTables::GetTypeTable().GetUInt32();
+  MIRType *u64Type = GlobalTables::GetTypeTable().GetUInt64();
+  MIRType *ptrType = GlobalTables::GetTypeTable().GetPtr();
+  MIRType *counterPtrType = GlobalTables::GetTypeTable().GetOrCreatePointerType(*u64Type);
+  MIRFunction *fopenFunc = builder->GetOrCreateFunction("fopen", ptrType->GetTypeIndex());
+  MIRFunction *fprintfFunc = builder->GetOrCreateFunction("fprintf", TyIdx(PTY_i32));
+  MIRFunction *fcloseFunc = builder->GetOrCreateFunction("fclose", TyIdx(PTY_i32));
+  ArgVector formals(mirModule.GetMPAllocator().Adapter());
+  MIRFunction *dumpFunc = builder->CreateFunction(kEdgeDumpFuncPrefixStr + mirModule.GetFileNameAsPostfix(),
+                                                  *GlobalTables::GetTypeTable().GetVoid(), formals);
+  CHECK_FATAL(dumpFunc != nullptr, "edgeprofiledump: the dump function is already defined");
+  builder->SetCurrentFunction(*dumpFunc);
+  BlockNode *body = dumpFunc->GetBody();
+  MIRSymbol *file = builder->GetOrCreateLocalDecl("file", *ptrType);
+  MIRSymbol *index = builder->GetOrCreateLocalDecl("index", *u32Type);
+  LabelIdx loopLabel = builder->CreateLabIdx(*dumpFunc);
+  LabelIdx closeLabel = builder->CreateLabIdx(*dumpFunc);
+  LabelIdx doneLabel = builder->CreateLabIdx(*dumpFunc);
+
+  MapleVector<BaseNode*> openArgs(builder->GetCurrentFuncCodeMpAllocator()->Adapter());
+  openArgs.push_back(CreateStrNode(*dumpFunc, MeOption::edgeProfileGen + kEdgeCountsSuffixStr));
+  openArgs.push_back(CreateStrNode(*dumpFunc, "a"));
+  body->AddStatement(builder->CreateStmtCallAssigned(fopenFunc->GetPuidx(), openArgs, file));
+  BaseNode *noFile = builder->CreateExprCompare(OP_eq, *u1Type, *ptrType, builder->CreateExprDread(*file),
+                                                builder->CreateIntConst(0, PTY_ptr));
+  body->AddStatement(builder->CreateStmtCondGoto(noFile, OP_brtrue, doneLabel));
+  body->AddStatement(builder->CreateStmtDassign(*index, 0, builder->CreateIntConst(0, PTY_u32)));
+
+  body->AddStatement(builder->CreateStmtLabel(loopLabel));
+  BaseNode *inTable = builder->CreateExprCompare(OP_lt, *u1Type, *u32Type, builder->CreateExprDread(*index),
+                                                 builder->CreateIntConst(numCounters, PTY_u32));
+  body->AddStatement(builder->CreateStmtCondGoto(inTable, OP_brfalse, closeLabel));
+  ArrayNode *counterAddr = builder->CreateExprArray(*counterTable.GetType(), builder->CreateExprAddrof(0, counterTable),
+                                                    builder->CreateExprDread(*index));
+  counterAddr->SetBoundsCheck(false);
+  MapleVector<BaseNode*> printArgs(builder->GetCurrentFuncCodeMpAllocator()->Adapter());
+  printArgs.push_back(builder->CreateExprDread(*file));
+  printArgs.push_back(CreateStrNode(*dumpFunc, "%u %llu\n"));
+  printArgs.push_back(builder->CreateExprDread(*index));
+  printArgs.push_back(builder->CreateExprIread(*u64Type, *counterPtrType, 0, counterAddr));
+  body->AddStatement(builder->CreateStmtCall(fprintfFunc->GetPuidx(), printArgs));
+  BaseNode *nextIndex = builder->CreateExprBinary(OP_add, *u32Type, builder->CreateExprDread(*index),
+                                                  builder->CreateIntConst(1, PTY_u32));
+  body->AddStatement(builder->CreateStmtDassign(*index, 0, nextIndex));
+  body->AddStatement(builder->CreateStmtGoto(OP_goto, loopLabel));
+
+  body->AddStatement(builder->CreateStmtLabel(closeLabel));
+  MapleVector<BaseNode*> closeArgs(builder->GetCurrentFuncCodeMpAllocator()->Adapter());
+  closeArgs.push_back(builder->CreateExprDread(*file));
+  body->AddStatement(builder->CreateStmtCall(fcloseFunc->GetPuidx(), closeArgs));
+  body->AddStatement(builder->CreateStmtLabel(doneLabel));
+  body->AddStatement(builder->CreateStmtReturn(nullptr));
+  mirModule.AddFunction(dumpFunc);
+  return *dumpFunc;
+}
+
+// Put first in the body, the counters are only bumped after it:
+//   brtrue @registered (dread u32 $__edgeprof_registered<module>)
+//   dassign $__edgeprof_registered<module> 0 (constval u32 1)
+//   call &atexit (addroffunc ptr &__edgeprof_dump<module>)
+// @registered
+void EdgeProfileDump::InsertRegistration(MIRFunction &func, const MIRSymbol &registered, const MIRFunction &dumpFunc,
+                                         const MIRFunction &atexitFunc) const {
+  builder->SetCurrentFunction(func);
+  LabelIdx registeredLabel = builder->CreateLabIdx(func);
+  MapleVector<BaseNode*> atexitArgs(builder->GetCurrentFuncCodeMpAllocator()->Adapter());
+  atexitArgs.push_back(builder->CreateExprAddroffunc(dumpFunc.GetPuidx(), func.GetCodeMempool()));
+  BlockNode *body = func.GetBody();
+  body->InsertFirst(builder->CreateStmtLabel(registeredLabel));
+  body->InsertFirst(builder->CreateStmtCall(atexitFunc.GetPuidx(), atexitArgs));
+  body->InsertFirst(builder->CreateStmtDassign(registered, 0, builder->CreateIntConst(1, PTY_u32)));
+  BaseNode *isRegistered = builder->CreateExprDread(*GlobalTables::GetTypeTable().GetUInt32(), 0, registered);
+  body->InsertFirst(builder->CreateStmtCondGoto(isRegistered, OP_brtrue, registeredLabel));
+}
+
+void EdgeProfileDump::Run() {
+  MIRSymbol *counterTable = builder->GetGlobalDecl(kEdgeCounterTabPrefixStr + mirModule.GetFileNameAsPostfix());
+  if (counterTable == nullptr || counterTable->GetType()->GetKind() != kTypeArray) {
+    // no function of the module was instrumented
+    return;
+  }
+  uint32 numCounters = static_cast<MIRArrayType*>(counterTable->GetType())->GetSizeArrayItem(0);
+  // the functions of the module, before the dump function joins them
+  std::vector<MIRFunction*> funcs(mirModule.GetFunctionList().begin(), mirModule.GetFunctionList().end());
+  MIRFunction &dumpFunc = CreateDumpFunction(*counterTable, numCounters);
+  MIRSymbol *registered = builder->GetOrCreateGlobalDecl(kEdgeRegisteredPrefixStr + mirModule.GetFileNameAsPostfix(),
+                                                         *GlobalTables::GetTypeTable().GetUInt32());
+  MIRFunction *atexitFunc = builder->GetOrCreateFunction("atexit", TyIdx(PTY_i32));
+  uint32 numFuncs = 0;
+  for (MIRFunction *func : funcs) {
+    if (func->GetBody() == nullptr) {
+      continue;
+    }
+    InsertRegistration(*func, *registered, dumpFunc, *atexitFunc);
+    ++numFuncs;
+  }
+  if (trace) {
+    LogInfo::MapleLogger() << "edgeprofiledump: " << numCounters << " counters dumped to " << MeOption::edgeProfileGen
+                           << kEdgeCountsSuffixStr << ", registered from " << numFuncs << " functions\n";
+  }
+}
+
+AnalysisResult *DoEdgeProfileDump::Run(MIRModule *mod, ModuleResultMgr*) {
+  EdgeProfileDump edgeProfileDump(*mod, TRACE_PHASE);
+  edgeProfileDump.Run();
+  return nullptr;
+}
+}  // namespace maple
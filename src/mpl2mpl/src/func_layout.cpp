@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "func_layout.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "global_tables.h"
+#include "option.h"
+
+namespace maple {
+// clusters stop growing at about a 4KB page of code
+static constexpr uint32 kMaxClusterStmts = 1024;
+
+uint32 FuncLayout::CountStmts(const MIRFunction &func) const {
+  uint32 count = 0;
+  if (func.GetBody() != nullptr) {
+    for (const StmtNode *stmt = func.GetBody()->GetFirst(); stmt != nullptr; stmt = stmt->GetNext()) {
+      ++count;
+    }
+  }
+  return std::max(count, 1u);
+}
+
+bool FuncLayout::ReadProfile() {
+  std::ifstream file(Options::funcLayoutProfile);
+  if (!file.is_open()) {
+    WARN(kLncWarn, "cannot open function layout profile %s", Options::funcLayoutProfile.c_str());
+    return false;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream record(line);
+    std::string kind;
+    std::string name;
+    if (!(record >> kind) || kind.front() == '#' || !(record >> name)) {
+      continue;
+    }
+    // functions defined in other modules are laid out there
+    auto funcIt = funcOfName.find(name);
+    if (funcIt == funcOfName.end()) {
+      continue;
+    }
+    if (kind == "boot") {
+      funcInfos[funcIt->second].bootRun = true;
+    } else if (kind == "run") {
+      funcInfos[funcIt->second].runtimeRun = true;
+    } else if (kind == "edge") {
+      std::string calleeName;
+      uint64 count = 0;
+      if (!(record >> calleeName >> count)) {
+        continue;
+      }
+      auto calleeIt = funcOfName.find(calleeName);
+      if (calleeIt == funcOfName.end()) {
+        continue;
+      }
+      FuncInfo &calleeInfo = funcInfos[calleeIt->second];
+      calleeInfo.callCount += count;
+      calleeInfo.callers[funcIt->second->GetPuidx()] += count;
+    }
+  }
+  return true;
+}
+
+void FuncLayout::SetLayoutTypes() {
+  for (auto &infoPair : funcInfos) {
+    const FuncInfo &info = infoPair.second;
+    LayoutType type = kLayoutUnused;
+    if (info.bootRun && info.runtimeRun) {
+      type = kLayoutBothHot;
+    } else if (info.bootRun) {
+      type = kLayoutBootHot;
+    } else if (info.runtimeRun) {
+      type = kLayoutRunHot;
+    }
+    infoPair.first->SetLayoutType(type);
+  }
+}
+
+// C3 ordering: from the most called function down, append each function's cluster to the cluster of its most
+// frequent caller, then lay out the clusters by decreasing call density.
+std::vector<MIRFunction*> FuncLayout::OrderGroup(const std::vector<MIRFunction*> &group) {
+  std::vector<Cluster> clusters(group.size());
+  std::map<MIRFunction*, size_t> clusterOf;
+  for (size_t i = 0; i < group.size(); ++i) {
+    const FuncInfo &info = funcInfos[group[i]];
+    clusters[i].funcs.push_back(group[i]);
+    clusters[i].callCount = info.callCount;
+    clusters[i].size = info.size;
+    clusterOf[group[i]] = i;
+  }
+  std::vector<MIRFunction*> callees(group);
+  std::stable_sort(callees.begin(), callees.end(), [this](MIRFunction *left, MIRFunction *right) {
+    return funcInfos[left].callCount > funcInfos[right].callCount;
+  });
+  for (MIRFunction *callee : callees) {
+    MIRFunction *caller = nullptr;
+    uint64 maxCount = 0;
+    for (auto &callerPair : funcInfos[callee].callers) {
+      MIRFunction *func = GlobalTables::GetFunctionTable().GetFunctionFromPuidx(callerPair.first);
+      if (callerPair.second > maxCount && clusterOf.find(func) != clusterOf.end()) {
+        caller = func;
+        maxCount = callerPair.second;
+      }
+    }
+    if (caller == nullptr) {
+      continue;
+    }
+    Cluster &from = clusters[clusterOf[callee]];
+    Cluster &to = clusters[clusterOf[caller]];
+    if (&from == &to || from.size + to.size > kMaxClusterStmts) {
+      continue;
+    }
+    for (MIRFunction *func : from.funcs) {
+      to.funcs.push_back(func);
+      clusterOf[func] = clusterOf[caller];
+    }
+    to.callCount += from.callCount;
+    to.size += from.size;
+    from.funcs.clear();
+  }
+  std::vector<const Cluster*> order;
+  for (const Cluster &cluster : clusters) {
+    if (!cluster.funcs.empty()) {
+      order.push_back(&cluster);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [](const Cluster *left, const Cluster *right) {
+    return left->callCount * right->size > right->callCount * left->size;
+  });
+  std::vector<MIRFunction*> result;
+  for (const Cluster *cluster : order) {
+    result.insert(result.end(), cluster->funcs.begin(), cluster->funcs.end());
+  }
+  if (trace) {
+    LogInfo::MapleLogger() << "funclayout: " << group.size() << " functions in " << order.size() << " clusters\n";
+  }
+  return result;
+}
+
+void FuncLayout::Run() {
+  for (MIRFunction *func : mirModule.GetFunctionList()) {
+    funcOfName[func->GetName()] = func;
+    funcInfos[func].size = CountStmts(*func);
+  }
+  if (!ReadProfile()) {
+    return;
+  }
+  SetLayoutTypes();
+  std::vector<std::vector<MIRFunction*>> groups(kLayoutTypeCount);
+  for (MIRFunction *func : mirModule.GetFunctionList()) {
+    groups[func->GetLayoutType()].push_back(func);
+  }
+  std::vector<MIRFunction*> newOrder;
+  for (uint32 type = 0; type < kLayoutTypeCount; ++type) {
+    if (trace) {
+      LogInfo::MapleLogger() << "funclayout: layout type " << type << " has " << groups[type].size() << " functions\n";
+    }
+    // unused functions keep the order of the input
+    std::vector<MIRFunction*> ordered = (type == kLayoutUnused) ? groups[type] : OrderGroup(groups[type]);
+    newOrder.insert(newOrder.end(), ordered.begin(), ordered.end());
+  }
+  mirModule.GetFunctionList().assign(newOrder.begin(), newOrder.end());
+}
+
+AnalysisResult *DoFuncLayout::Run(MIRModule *mod, ModuleResultMgr*) {
+  FuncLayout funcLayout(*mod, TRACE_PHASE);
+  funcLayout.Run();
+  return nullptr;
+}
+}  // namespace maple
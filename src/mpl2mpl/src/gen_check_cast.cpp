@@ -134,8 +134,25 @@ void CheckCastGenerator::GenCheckCast(BaseNode &stmt) {
         MapleVector<BaseNode*> args(builder->GetCurrentFuncCodeMpAllocator()->Adapter());
         args.push_back(valueExpr);
         args.push_back(opnd);
-        StmtNode *dassignStmt = builder->CreateStmtCall(checkCastingNoArray->GetPuidx(), args);
-        innerIfStmt->GetThenPart()->AddStatement(dassignStmt);
+        if (IsExactCheckKlass(*checkKlass)) {
+          // No other class can pass the check, so a mismatch fails without asking the runtime.
+          args.push_back(builder->CreateIntConst(0, PTY_ptr));
+          StmtNode *throwStmt = builder->CreateStmtCall(throwCastException->GetPuidx(), args);
+          innerIfStmt->GetThenPart()->AddStatement(throwStmt);
+          ++numExactSites;
+        } else {
+          // Remember the last class that passed the runtime check at this site, and skip the call for it.
+          MIRSymbol *cacheSt = CreateCheckCastCacheSymbol();
+          BaseNode *cacheCond = builder->CreateExprCompare(
+              OP_ne, *GlobalTables::GetTypeTable().GetUInt1(), *GlobalTables::GetTypeTable().GetPtr(),
+              builder->CreateExprDread(*GlobalTables::GetTypeTable().GetPtr(), 0, *cacheSt), GetObjectShadow(opnd));
+          auto *cacheIfStmt = static_cast<IfStmtNode*>(builder->CreateStmtIf(cacheCond));
+          StmtNode *dassignStmt = builder->CreateStmtCall(checkCastingNoArray->GetPuidx(), args);
+          cacheIfStmt->GetThenPart()->AddStatement(dassignStmt);
+          cacheIfStmt->GetThenPart()->AddStatement(builder->CreateStmtDassign(*cacheSt, 0, GetObjectShadow(opnd)));
+          innerIfStmt->GetThenPart()->AddStatement(cacheIfStmt);
+          ++numCachedSites;
+        }
         ifStmt->GetThenPart()->AddStatement(innerIfStmt);
         currFunc->GetBody()->InsertBefore(static_cast<StmtNode*>(&stmt), ifStmt);
       }
@@ -177,6 +194,7 @@ void CheckCastGenerator::GenCheckCast(BaseNode &stmt) {
         opnds.push_back(builder->CreateIntConst(dim, PTY_ptr));
         opnds.push_back(signatureNode);
         StmtNode *dassignStmt = builder->CreateStmtCall(checkCastingArray->GetPuidx(), opnds);
+        ++numRuntimeSites;
         currFunc->GetBody()->InsertBefore(static_cast<StmtNode*>(&stmt), dassignStmt);
       } else {
         MIRTypeKind kd = pointedType->GetKind();
@@ -250,6 +268,38 @@ void CheckCastGenerator::GenCheckCast(BaseNode &stmt) {
   currFunc->GetBody()->ReplaceStmt1WithStmt2(static_cast<StmtNode*>(&stmt), assignReturnTypeNode);
 }
 
+// The object's classinfo must equal the target exactly if the target is a class that cannot be subclassed.
+bool CheckCastGenerator::IsExactCheckKlass(const Klass &klass) const {
+  if (!klass.IsClass() || klass.GetMIRStructType()->IsIncomplete() || klass.HasSubKlass()) {
+    return false;
+  }
+  return klass.GetMIRClassType()->IsFinal() || klass.IsPrivateInnerAndNoSubClass();
+}
+
+// A file-static slot per cast site. It only ever holds a classinfo that already passed the runtime check for this
+// site's target, so a stale or racy value costs at most one extra runtime call.
+MIRSymbol *CheckCastGenerator::CreateCheckCastCacheSymbol() {
+  std::string cacheName = kCheckCastCachePrefix + std::to_string(currFunc->GetPuidx()) + "_" +
+                          std::to_string(numCachedSites);
+  MIRSymbol *cacheSt = builder->CreateGlobalDecl(cacheName.c_str(), *GlobalTables::GetTypeTable().GetPtr(),
+                                                 kScFstatic);
+  cacheSt->SetKonst(GetMIRModule().GetMemPool()->New<MIRIntConst>(0, *GlobalTables::GetTypeTable().GetPtr()));
+  return cacheSt;
+}
+
+void CheckCastGenerator::Finish() {
+  if (Options::quiet) {
+    return;
+  }
+  uint32 numSites = numExactSites + numCachedSites + numRuntimeSites;
+  if (numSites == 0) {
+    return;
+  }
+  LogInfo::MapleLogger() << "gencheckcast: " << GetMIRModule().GetFileName() << ": " << numSites
+                         << " checkcast sites, " << numExactSites << " exact inline, " << numCachedSites
+                         << " inline with site cache, " << numRuntimeSites << " runtime only\n";
+}
+
 void CheckCastGenerator::GenAllCheckCast() {
   auto &stmtNodes = currFunc->GetBody()->GetStmtNodes();
   for (auto &stmt : stmtNodes) {
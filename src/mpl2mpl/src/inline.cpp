@@ -0,0 +1,552 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "inline.h"
+#include <algorithm>
+#include <fstream>
+#include "global_tables.h"
+#include "mir_parser.h"
+#include "option.h"
+
+namespace maple {
+// a caller may grow up to this many times its size before inlining
+static constexpr uint32 kMaxGrowthFactor = 4;
+// call sites deeper in loops than this do not raise the size limit further
+static constexpr uint32 kMaxLoopDepthBonus = 2;
+// methods with this annotation look up the class of their immediate caller, inlining them would change it
+static const std::string kCallerSensitiveAnno = "Lsun_2Freflect_2FCallerSensitive_3B";
+
+static bool HasLabelAddress(const BaseNode &node) {
+  if (node.GetOpCode() == OP_addroflabel) {
+    return true;
+  }
+  for (size_t i = 0; i < node.NumOpnds(); ++i) {
+    if (HasLabelAddress(*node.Opnd(i))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+uint32 MInline::CountStmts(const MIRFunction &func) const {
+  uint32 count = 0;
+  for (const StmtNode *stmt = func.GetBody()->GetFirst(); stmt != nullptr; stmt = stmt->GetNext()) {
+    ++count;
+  }
+  return count;
+}
+
+bool MInline::IsImported(const MIRFunction &func) const {
+  return func.GetAttr(FUNCATTR_optimized);
+}
+
+bool MInline::IsCallerSensitive(const MIRFunction &func) const {
+  MIRType *classType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(func.GetClassTyIdx());
+  if (classType == nullptr || (!classType->IsMIRClassType() && !classType->IsMIRInterfaceType())) {
+    return false;
+  }
+  for (const MIRPragma *prag : static_cast<MIRStructType*>(classType)->GetPragmaVec()) {
+    if (prag->GetKind() != kPragmaFunc || prag->GetStrIdx() != func.GetNameStrIdx()) {
+      continue;
+    }
+    MIRType *annoType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(prag->GetTyIdx());
+    if (annoType == nullptr) {
+      continue;
+    }
+    if (GlobalTables::GetStrTable().GetStringFromStrIdx(annoType->GetNameStrIdx()) == kCallerSensitiveAnno) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// the body must be a flat statement list the renaming below fully covers
+bool MInline::IsInlinable(const MIRFunction &func) const {
+  if (func.GetBody() == nullptr || func.IsVarargs() || func.IsNative() || func.IsAbstract() ||
+      func.GetAttr(FUNCATTR_synchronized) || IsCallerSensitive(func)) {
+    return false;
+  }
+  for (const StmtNode *stmt = func.GetBody()->GetFirst(); stmt != nullptr; stmt = stmt->GetNext()) {
+    switch (stmt->GetOpCode()) {
+      case OP_block:
+      case OP_if:
+      case OP_while:
+      case OP_dowhile:
+      case OP_doloop:
+      case OP_foreachelem:
+      case OP_multiway:
+      case OP_gosub:
+      case OP_retsub:
+      case OP_jstry:
+      case OP_jscatch:
+      case OP_finally:
+      case OP_cleanuptry:
+      case OP_assertge:
+      case OP_assertlt:
+        return false;
+      default:
+        break;
+    }
+    if (HasLabelAddress(*stmt)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MInline::HasTry(const MIRFunction &func) const {
+  for (const StmtNode *stmt = func.GetBody()->GetFirst(); stmt != nullptr; stmt = stmt->GetNext()) {
+    if (stmt->GetOpCode() == OP_try) {
+      return true;
+    }
+  }
+  return false;
+}
+
+MIRFunction *MInline::GetDirectCallee(const StmtNode &stmt) const {
+  if (stmt.GetOpCode() != OP_call && stmt.GetOpCode() != OP_callassigned) {
+    return nullptr;
+  }
+  return GlobalTables::GetFunctionTable().GetFunctionFromPuidx(static_cast<const CallNode&>(stmt).GetPUIdx());
+}
+
+std::vector<MIRFunction*> MInline::GetCallees(const MIRFunction &func) const {
+  std::vector<MIRFunction*> callees;
+  for (const StmtNode *stmt = func.GetBody()->GetFirst(); stmt != nullptr; stmt = stmt->GetNext()) {
+    MIRFunction *callee = GetDirectCallee(*stmt);
+    if (callee != nullptr && callee->GetBody() != nullptr) {
+      callees.push_back(callee);
+    }
+  }
+  return callees;
+}
+
+void MInline::ImportCandidates() {
+  // parsing a definition overrides the attributes of an existing declaration
+  for (MIRFunction *func : GlobalTables::GetFunctionTable().GetFuncTable()) {
+    if (func != nullptr) {
+      declaredAttrs[func->GetPuidx()] = func->GetFuncAttrs();
+    }
+  }
+  std::ifstream file(Options::inlineImport);
+  if (!file.is_open()) {
+    LogInfo::MapleLogger() << "warning: cannot open inline candidates " << Options::inlineImport << '\n';
+    return;
+  }
+  // functions read from the file are marked FUNCATTR_optimized by the parser
+  MIRParser parser(mirModule);
+  if (!parser.ParseMIR(file)) {
+    LogInfo::MapleLogger() << "warning: cannot read inline candidates " << Options::inlineImport << ": "
+                           << parser.GetError() << '\n';
+  }
+}
+
+// Writes the functions small enough to be inlined at some call site, in their form before the ME optimizations.
+void MInline::ExportCandidates() {
+  uint32 maxSize = Options::inlineLimit * (1 + kMaxLoopDepthBonus);
+  std::vector<MIRFunction*> candidates;
+  for (MIRFunction *func : mirModule.GetFunctionList()) {
+    if (func->GetBody() != nullptr && !IsImported(*func) && funcSizes[func->GetPuidx()] <= maxSize &&
+        IsInlinable(*func)) {
+      mirModule.AddOptFuncs(func);
+      candidates.push_back(func);
+    }
+  }
+  // the dump drops the location info, which this module still emits
+  std::vector<bool> withLocInfo;
+  for (MIRFunction *func : candidates) {
+    withLocInfo.push_back(func->WithLocInfo());
+  }
+  mirModule.DumpInlineCandidateToFile(Options::inlineExport);
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    candidates[i]->SetWithLocInfo(withLocInfo[i]);
+  }
+  if (trace) {
+    LogInfo::MapleLogger() << "inline: " << candidates.size() << " candidates exported to " << Options::inlineExport
+                           << '\n';
+  }
+}
+
+// Imported bodies are not compiled here, their functions are external again.
+void MInline::ReleaseImported() {
+  std::vector<MIRFunction*> imported;
+  for (MIRFunction *func : mirModule.GetFunctionList()) {
+    if (IsImported(*func)) {
+      imported.push_back(func);
+    }
+  }
+  if (imported.empty()) {
+    return;
+  }
+  auto isImported = [this](const MIRFunction *func) { return IsImported(*func); };
+  MapleVector<MIRFunction*> &funcList = mirModule.GetFunctionList();
+  funcList.erase(std::remove_if(funcList.begin(), funcList.end(), isImported), funcList.end());
+  MapleVector<MIRFunction*> &compilationList = mirModule.GetCompilationList();
+  compilationList.erase(std::remove_if(compilationList.begin(), compilationList.end(), isImported),
+                        compilationList.end());
+  for (MIRFunction *func : imported) {
+    func->SetBody(nullptr);
+    auto attrIt = declaredAttrs.find(func->GetPuidx());
+    if (attrIt != declaredAttrs.end()) {
+      func->SetFuncAttrs(attrIt->second);
+    }
+  }
+}
+
+// Post-orders the functions with a body along the direct call edges, iteratively as call chains can be long.
+void MInline::BuildBottomUpOrder() {
+  std::set<PUIdx> visited;
+  for (MIRFunction *root : mirModule.GetFunctionList()) {
+    if (root->GetBody() == nullptr || !visited.insert(root->GetPuidx()).second) {
+      continue;
+    }
+    // each frame holds a function and its callees not visited yet
+    std::vector<std::pair<MIRFunction*, std::vector<MIRFunction*>>> stack;
+    stack.emplace_back(root, GetCallees(*root));
+    while (!stack.empty()) {
+      std::vector<MIRFunction*> &callees = stack.back().second;
+      if (!callees.empty()) {
+        MIRFunction *callee = callees.back();
+        callees.pop_back();
+        if (visited.insert(callee->GetPuidx()).second) {
+          stack.emplace_back(callee, GetCallees(*callee));
+        }
+        continue;
+      }
+      MIRFunction *func = stack.back().first;
+      postOrderIndex[func->GetPuidx()] = bottomUpOrder.size();
+      bottomUpOrder.push_back(func);
+      stack.pop_back();
+    }
+  }
+}
+
+// Loop depth of each statement, from the backward branches of the flat body: a statement lies in the loop of every
+// branch that jumps back over it.
+std::map<const StmtNode*, uint32> MInline::ComputeLoopDepths(const MIRFunction &func) const {
+  std::vector<const StmtNode*> stmts;
+  std::map<LabelIdx, size_t> labelPos;
+  for (const StmtNode *stmt = func.GetBody()->GetFirst(); stmt != nullptr; stmt = stmt->GetNext()) {
+    if (stmt->GetOpCode() == OP_label) {
+      labelPos[static_cast<const LabelNode*>(stmt)->GetLabelIdx()] = stmts.size();
+    }
+    stmts.push_back(stmt);
+  }
+  std::vector<int32> delta(stmts.size() + 1, 0);
+  for (size_t i = 0; i < stmts.size(); ++i) {
+    LabelIdx target = 0;
+    Opcode op = stmts[i]->GetOpCode();
+    if (op == OP_goto) {
+      target = static_cast<const GotoNode*>(stmts[i])->GetOffset();
+    } else if (op == OP_brtrue || op == OP_brfalse) {
+      target = static_cast<const CondGotoNode*>(stmts[i])->GetOffset();
+    } else {
+      continue;
+    }
+    auto posIt = labelPos.find(target);
+    if (posIt != labelPos.end() && posIt->second <= i) {
+      ++delta[posIt->second];
+      --delta[i + 1];
+    }
+  }
+  std::map<const StmtNode*, uint32> depths;
+  int32 depth = 0;
+  for (size_t i = 0; i < stmts.size(); ++i) {
+    depth += delta[i];
+    depths[stmts[i]] = static_cast<uint32>(depth);
+  }
+  return depths;
+}
+
+StIdx MInline::MapSymbol(MIRFunction &callee, StIdx stIdx, CloneMaps &maps) {
+  if (!stIdx.Islocal()) {
+    return stIdx;
+  }
+  auto symIt = maps.symbols.find(stIdx.Idx());
+  if (symIt != maps.symbols.end()) {
+    return symIt->second;
+  }
+  MIRSymbol *sym = callee.GetSymTab()->GetSymbolFromStIdx(stIdx.Idx());
+  CHECK_FATAL(sym != nullptr, "null ptr check");
+  std::string name = sym->GetName() + "_inl" + std::to_string(numInlinedCalls);
+  MIRSymbol *newSym = builder.CreateLocalDecl(name, *sym->GetType());
+  newSym->SetAttrs(sym->GetAttrs());
+  newSym->SetIsTmp(sym->GetIsTmp());
+  maps.symbols[stIdx.Idx()] = newSym->GetStIdx();
+  return newSym->GetStIdx();
+}
+
+PregIdx MInline::MapPreg(MIRFunction &caller, MIRFunction &callee, PregIdx pregIdx, CloneMaps &maps) const {
+  // special registers such as %%thrownval are the same in every function
+  if (pregIdx <= 0) {
+    return pregIdx;
+  }
+  auto pregIt = maps.pregs.find(pregIdx);
+  if (pregIt != maps.pregs.end()) {
+    return pregIt->second;
+  }
+  PregIdx newIdx = caller.GetPregTab()->CreateRefPreg(*callee.GetPregTab()->PregFromPregIdx(pregIdx));
+  maps.pregs[pregIdx] = newIdx;
+  return newIdx;
+}
+
+LabelIdx MInline::MapLabel(MIRFunction &caller, LabelIdx labelIdx, CloneMaps &maps) {
+  if (labelIdx == 0) {
+    return labelIdx;
+  }
+  auto labelIt = maps.labels.find(labelIdx);
+  if (labelIt != maps.labels.end()) {
+    return labelIt->second;
+  }
+  LabelIdx newIdx = builder.CreateLabIdx(caller);
+  maps.labels[labelIdx] = newIdx;
+  return newIdx;
+}
+
+void MInline::RenameExpr(MIRFunction &caller, MIRFunction &callee, BaseNode &expr, CloneMaps &maps) {
+  switch (expr.GetOpCode()) {
+    case OP_dread:
+    case OP_addrof: {
+      auto &addrof = static_cast<AddrofNode&>(expr);
+      addrof.SetStIdx(MapSymbol(callee, addrof.GetStIdx(), maps));
+      break;
+    }
+    case OP_regread: {
+      auto &regread = static_cast<RegreadNode&>(expr);
+      regread.SetRegIdx(MapPreg(caller, callee, regread.GetRegIdx(), maps));
+      break;
+    }
+    default:
+      break;
+  }
+  for (size_t i = 0; i < expr.NumOpnds(); ++i) {
+    RenameExpr(caller, callee, *expr.Opnd(i), maps);
+  }
+}
+
+void MInline::RenameStmt(MIRFunction &caller, MIRFunction &callee, StmtNode &stmt, CloneMaps &maps) {
+  switch (stmt.GetOpCode()) {
+    case OP_dassign: {
+      auto &dassign = static_cast<DassignNode&>(stmt);
+      dassign.SetStIdx(MapSymbol(callee, dassign.GetStIdx(), maps));
+      break;
+    }
+    case OP_regassign: {
+      auto &regassign = static_cast<RegassignNode&>(stmt);
+      regassign.SetRegIdx(MapPreg(caller, callee, regassign.GetRegIdx(), maps));
+      break;
+    }
+    case OP_goto: {
+      auto &gotoNode = static_cast<GotoNode&>(stmt);
+      gotoNode.SetOffset(MapLabel(caller, gotoNode.GetOffset(), maps));
+      break;
+    }
+    case OP_brtrue:
+    case OP_brfalse: {
+      auto &condGoto = static_cast<CondGotoNode&>(stmt);
+      condGoto.SetOffset(MapLabel(caller, condGoto.GetOffset(), maps));
+      break;
+    }
+    case OP_label: {
+      auto &label = static_cast<LabelNode&>(stmt);
+      label.SetLabelIdx(MapLabel(caller, label.GetLabelIdx(), maps));
+      break;
+    }
+    case OP_switch: {
+      auto &switchNode = static_cast<SwitchNode&>(stmt);
+      switchNode.SetDefaultLabel(MapLabel(caller, switchNode.GetDefaultLabel(), maps));
+      for (uint32 i = 0; i < switchNode.GetSwitchTable().size(); ++i) {
+        switchNode.UpdateCaseLabelAt(i, MapLabel(caller, switchNode.GetCasePair(i).second, maps));
+      }
+      break;
+    }
+    case OP_rangegoto: {
+      auto &rangeGoto = static_cast<RangeGotoNode&>(stmt);
+      SmallCaseVector table = rangeGoto.GetRangeGotoTable();
+      for (SmallCasePair &casePair : table) {
+        casePair.second = static_cast<uint16>(MapLabel(caller, casePair.second, maps));
+      }
+      rangeGoto.SetRangeGotoTable(table);
+      break;
+    }
+    case OP_try: {
+      auto &tryNode = static_cast<TryNode&>(stmt);
+      for (size_t i = 0; i < tryNode.GetOffsetsCount(); ++i) {
+        tryNode.SetOffset(MapLabel(caller, tryNode.GetOffset(i), maps), i);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  CallReturnVector *returnValues = stmt.GetCallReturnVector();
+  if (returnValues != nullptr) {
+    for (CallReturnPair &ret : *returnValues) {
+      if (ret.second.IsReg()) {
+        ret.second.SetPregIdx(static_cast<PregIdx16>(MapPreg(caller, callee, ret.second.GetPregIdx(), maps)));
+      } else {
+        ret.first = MapSymbol(callee, ret.first, maps);
+      }
+    }
+  }
+  for (size_t i = 0; i < stmt.NumOpnds(); ++i) {
+    RenameExpr(caller, callee, *stmt.Opnd(i), maps);
+  }
+}
+
+// Assigns a returned value to the result of the call, or only evaluates it for its exceptions when unused.
+StmtNode *MInline::CreateReturnAssign(MIRFunction &caller, CallNode &call, BaseNode &value) {
+  if (call.GetReturnVec().empty()) {
+    return builder.CreateStmtUnary(OP_eval, &value);
+  }
+  CallReturnPair &ret = call.GetReturnVec()[0];
+  if (ret.second.IsReg()) {
+    PregIdx pregIdx = ret.second.GetPregIdx();
+    return builder.CreateStmtRegassign(caller.GetPregTab()->PregFromPregIdx(pregIdx)->GetPrimType(), pregIdx, &value);
+  }
+  return builder.CreateStmtDassign(ret.first, ret.second.GetFieldID(), &value);
+}
+
+// Replaces call by a renamed copy of the callee body: the arguments are assigned to copies of the formals, and each
+// return assigns the result of the call and jumps past the copy. Try regions of the callee are copied as they are,
+// InlineCalls keeps them out of the try regions of the caller.
+void MInline::InlineCall(MIRFunction &caller, CallNode &call, MIRFunction &callee) {
+  CloneMaps maps;
+  BlockNode &body = *caller.GetBody();
+  MapleAllocator &allocator = caller.GetCodeMemPoolAllocator();
+  auto insert = [&body, &call](StmtNode *newStmt) {
+    newStmt->SetSrcPos(call.GetSrcPos());
+    body.InsertBefore(&call, newStmt);
+  };
+  BaseNode *receiver = nullptr;
+  for (size_t i = 0; i < callee.GetFormalCount(); ++i) {
+    MIRSymbol *formal = callee.GetFormal(i);
+    if (formal->IsPreg()) {
+      PregIdx calleeIdx = callee.GetPregTab()->GetPregIdxFromPregno(formal->GetPreg()->GetPregNo());
+      PregIdx pregIdx = MapPreg(caller, callee, calleeIdx, maps);
+      PrimType primType = formal->GetPreg()->GetPrimType();
+      insert(builder.CreateStmtRegassign(primType, pregIdx, call.Opnd(i)));
+      receiver = (i == 0) ? builder.CreateExprRegread(primType, pregIdx) : receiver;
+    } else {
+      StIdx stIdx = MapSymbol(callee, formal->GetStIdx(), maps);
+      insert(builder.CreateStmtDassign(stIdx, 0, call.Opnd(i)));
+      receiver = (i == 0) ? builder.CreateExprDread(*caller.GetSymTab()->GetSymbolFromStIdx(stIdx.Idx())) : receiver;
+    }
+  }
+  // a call through a null receiver throws before the callee runs, whether or not the body dereferences it
+  if (mirModule.IsJavaModule() && !callee.IsStatic() && receiver != nullptr) {
+    insert(builder.CreateStmtUnary(OP_assertnonnull, receiver));
+  }
+  LabelIdx endLabel = 0;
+  for (StmtNode *stmt = callee.GetBody()->GetFirst(); stmt != nullptr; stmt = stmt->GetNext()) {
+    if (stmt->GetOpCode() != OP_return) {
+      StmtNode *newStmt = stmt->CloneTree(allocator);
+      RenameStmt(caller, callee, *newStmt, maps);
+      insert(newStmt);
+      continue;
+    }
+    if (stmt->NumOpnds() != 0) {
+      BaseNode *value = stmt->Opnd(0)->CloneTree(allocator);
+      RenameExpr(caller, callee, *value, maps);
+      insert(CreateReturnAssign(caller, call, *value));
+    }
+    if (stmt->GetNext() != nullptr) {
+      endLabel = (endLabel == 0) ? builder.CreateLabIdx(caller) : endLabel;
+      insert(builder.CreateStmtGoto(OP_goto, endLabel));
+    }
+  }
+  if (endLabel != 0) {
+    insert(builder.CreateStmtLabel(endLabel));
+  }
+  body.RemoveStmt(&call);
+}
+
+void MInline::InlineCalls(MIRFunction &caller) {
+  builder.SetCurrentFunction(caller);
+  uint32 &callerSize = funcSizes[caller.GetPuidx()];
+  uint32 maxCallerSize = callerSize * kMaxGrowthFactor + Options::inlineLimit;
+  uint32 callerIndex = postOrderIndex[caller.GetPuidx()];
+  std::map<const StmtNode*, uint32> loopDepths = ComputeLoopDepths(caller);
+  bool inTry = false;
+  StmtNode *next = nullptr;
+  // inlined statements are inserted before the call and never revisited
+  for (StmtNode *stmt = caller.GetBody()->GetFirst(); stmt != nullptr; stmt = next) {
+    next = stmt->GetNext();
+    if (stmt->GetOpCode() == OP_try || stmt->GetOpCode() == OP_endtry) {
+      inTry = (stmt->GetOpCode() == OP_try);
+      continue;
+    }
+    MIRFunction *callee = GetDirectCallee(*stmt);
+    if (callee == nullptr || callee->GetBody() == nullptr) {
+      continue;
+    }
+    // a callee visited after its caller calls back into it
+    auto indexIt = postOrderIndex.find(callee->GetPuidx());
+    if (indexIt == postOrderIndex.end() || indexIt->second >= callerIndex) {
+      continue;
+    }
+    uint32 calleeSize = funcSizes[callee->GetPuidx()];
+    uint32 loopDepth = std::min(loopDepths[stmt], kMaxLoopDepthBonus);
+    if (calleeSize > Options::inlineLimit * (1 + loopDepth) || callerSize + calleeSize > maxCallerSize) {
+      continue;
+    }
+    auto &call = static_cast<CallNode&>(*stmt);
+    // try regions do not nest, a callee with its own handlers stays a call inside the try regions of the caller
+    if (call.NumOpnds() != callee->GetFormalCount() || call.GetReturnVec().size() > 1 || !IsInlinable(*callee) ||
+        (inTry && HasTry(*callee))) {
+      continue;
+    }
+    if (trace) {
+      LogInfo::MapleLogger() << "inline: " << callee->GetName() << " (" << calleeSize << " stmts, loop depth "
+                             << loopDepths[stmt] << ") into " << caller.GetName() << '\n';
+    }
+    InlineCall(caller, call, *callee);
+    ++numInlinedCalls;
+    numImportedInlined += IsImported(*callee) ? 1 : 0;
+    callerSize = CountStmts(caller);
+  }
+}
+
+void MInline::Run() {
+  if (!Options::inlineImport.empty()) {
+    ImportCandidates();
+  }
+  BuildBottomUpOrder();
+  for (MIRFunction *func : bottomUpOrder) {
+    uint32 size = CountStmts(*func);
+    funcSizes[func->GetPuidx()] = size;
+    stmtsBefore += IsImported(*func) ? 0 : size;
+  }
+  for (MIRFunction *func : bottomUpOrder) {
+    if (!IsImported(*func)) {
+      InlineCalls(*func);
+      stmtsAfter += funcSizes[func->GetPuidx()];
+    }
+  }
+  if (!Options::inlineExport.empty()) {
+    ExportCandidates();
+  }
+  ReleaseImported();
+  if (trace) {
+    LogInfo::MapleLogger() << "inline: " << numInlinedCalls << " call sites inlined (" << numImportedInlined
+                           << " from other modules), statements " << stmtsBefore << " -> " << stmtsAfter << '\n';
+  }
+}
+
+AnalysisResult *DoInline::Run(MIRModule *mod, ModuleResultMgr*) {
+  MInline inliner(*mod, TRACE_PHASE);
+  inliner.Run();
+  return nullptr;
+}
+}  // namespace maple
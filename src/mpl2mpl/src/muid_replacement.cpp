@@ -14,6 +14,7 @@
  */
 #include "muid_replacement.h"
 #include <fstream>
+#include <algorithm>
 #include "vtable_analysis.h"
 #include "reflection_analysis.h"
 
@@ -30,12 +31,7 @@ namespace maple {
 MUID MUIDReplacement::mplMuid;
 
 MUIDReplacement::MUIDReplacement(MIRModule *mod, KlassHierarchy *kh, bool dump)
-    : FuncOptimizeImpl(mod, kh, dump),
-      funcDefMap(std::less<MUID>()),
-      dataDefMap(std::less<MUID>()),
-      funcUndefMap(std::less<MUID>()),
-      dataUndefMap(std::less<MUID>()),
-      defMuidIdxMap(std::less<MUID>()) {
+    : FuncOptimizeImpl(mod, kh, dump) {
   isLibcore = (GetSymbolFromName(NameMangler::GetInternalNameLiteral(NameMangler::kJavaLangObjectStr)) != nullptr);
   GenericTables();
 }
@@ -45,6 +41,46 @@ MIRSymbol *MUIDReplacement::GetSymbolFromName(const std::string &name) {
   return GlobalTables::GetGsymTable().GetSymbolFromStrIdx(gStrIdx);
 }
 
+const MUID &MUIDReplacement::GetSymbolMUID(const MIRSymbol &mirSymbol) {
+  return GlobalTables::GetMUIDTable().GetOrCreateMUID(mirSymbol.GetNameStrIdx());
+}
+
+// Hash all the symbols in one batch, then sort the table by MUID and fill in
+// the index of each entry in muid order.
+void MUIDReplacement::BuildMUIDTable(const std::vector<MIRSymbol*> &symbols, MUIDSymIdxTable &table) const {
+  std::vector<GStrIdx> strIdxVec;
+  strIdxVec.reserve(symbols.size());
+  for (MIRSymbol *mirSymbol : symbols) {
+    strIdxVec.push_back(mirSymbol->GetNameStrIdx());
+  }
+  std::vector<MUID> muids;
+  GlobalTables::GetMUIDTable().GetOrCreateMUIDs(strIdxVec, muids);
+  table.clear();
+  table.reserve(symbols.size());
+  for (size_t i = 0; i < symbols.size(); ++i) {
+    table.push_back(MUIDSymIdxPair(muids[i], SymIdxPair(symbols[i], 0)));
+  }
+  std::sort(table.begin(), table.end(), [](const MUIDSymIdxPair &a, const MUIDSymIdxPair &b) {
+    return a.first < b.first;
+  });
+  for (uint32 idx = 0; idx < table.size(); ++idx) {
+    CHECK_FATAL(idx == 0 || table[idx - 1].first != table[idx].first,
+                "MUID has been used before, possible collision");
+    table[idx].second.second = idx;
+  }
+}
+
+const MUIDReplacement::MUIDSymIdxPair *MUIDReplacement::FindFromMUIDTable(const MUIDSymIdxTable &table,
+                                                                           const MUID &muid) {
+  auto it = std::lower_bound(table.begin(), table.end(), muid, [](const MUIDSymIdxPair &entry, const MUID &key) {
+    return entry.first < key;
+  });
+  if (it == table.end() || it->first != muid) {
+    return nullptr;
+  }
+  return &(*it);
+}
+
 void MUIDReplacement::DumpMUIDFile(bool isFunc) {
   std::ofstream outFile;
   const std::string &mplName = GetMIRModule().GetFileName();
@@ -69,14 +105,14 @@ void MUIDReplacement::DumpMUIDFile(bool isFunc) {
     outName = mplName;
   }
   if (isFunc) {
-    for (auto const &keyVal : funcDefMap) {
+    for (auto const &keyVal : funcDefTable) {
       outFile << outName << " ";
       MIRSymbol *mirFunc = keyVal.second.first;
       outFile << mirFunc->GetName() << " ";
       outFile << keyVal.first.ToStr() << "\n";
     }
   } else {
-    for (auto const &keyVal : dataDefMap) {
+    for (auto const &keyVal : dataDefTable) {
       outFile << outName << " ";
       MIRSymbol *mirSymbol = keyVal.second.first;
       outFile << mirSymbol->GetName() << " ";
@@ -246,21 +282,20 @@ void MUIDReplacement::CollectImplicitUndefClassInfo(StmtNode &stmt) {
 
 
 void MUIDReplacement::GenericFuncDefTable() {
-  // Use funcDefMap to make sure funcDefTab is sorted by an increasing order of MUID
+  // Sort funcDefTable to make sure funcDefTab is sorted by an increasing order of MUID
+  std::vector<MIRSymbol*> funcSymbols;
+  funcSymbols.reserve(funcDefSet.size());
   for (MIRFunction *mirFunc : funcDefSet) {
-    MUID muid = GetMUID(mirFunc->GetName());
-    CHECK_FATAL(funcDefMap.find(muid) == funcDefMap.end(), "MUID has been used before, possible collision");
-    // Use 0 as the index for now. It will be back-filled once we have the whole map.
-    funcDefMap[muid] = SymIdxPair(mirFunc->GetFuncSymbol(), 0);
+    funcSymbols.push_back(mirFunc->GetFuncSymbol());
   }
+  BuildMUIDTable(funcSymbols, funcDefTable);
+  defMuidIdxVec.assign(funcDefTable.size(), kInvalidDefMuidIdx);
   uint32 idx = 0;
-  size_t arraySize = funcDefMap.size();
+  size_t arraySize = funcDefTable.size();
   MIRArrayType &muidIdxArrayType =
       *GlobalTables::GetTypeTable().GetOrCreateArrayType(*GlobalTables::GetTypeTable().GetUInt32(), arraySize);
   MIRAggConst *muidIdxTabConst = GetMIRModule().GetMemPool()->New<MIRAggConst>(GetMIRModule(), muidIdxArrayType);
-  for (auto &keyVal : funcDefMap) {
-    // Fill in the real index
-    keyVal.second.second = idx++;
+  for (auto &keyVal : funcDefTable) {
     // Use the muid index for now. It will be back-filled once we have the whole vector.
     MIRIntConst *indexConst =
       GetMIRModule().GetMemPool()->New<MIRIntConst>(keyVal.second.second, *GlobalTables::GetTypeTable().GetUInt32());
@@ -301,9 +336,12 @@ void MUIDReplacement::GenericFuncDefTable() {
   idx = 0;
   for (MIRFunction *mirFunc : GetMIRModule().GetFunctionList()) {
     ASSERT(mirFunc != nullptr, "null ptr check!");
-    MUID muid = GetMUID(mirFunc->GetName());
-    MapleMap<MUID, SymIdxPair>::iterator iter = funcDefMap.find(muid);
-    if (mirFunc->GetBody() == nullptr || iter == funcDefMap.end()) {
+    if (mirFunc->GetBody() == nullptr) {
+      continue;
+    }
+    const MUID &muid = GetSymbolMUID(*mirFunc->GetFuncSymbol());
+    const MUIDSymIdxPair *iter = FindFromMUIDTable(funcDefTable, muid);
+    if (iter == nullptr) {
       continue;
     }
     funcDefArray.push_back(std::make_pair(mirFunc->GetFuncSymbol(), muid));
@@ -323,10 +361,10 @@ void MUIDReplacement::GenericFuncDefTable() {
       muidIdxTabConst->SetConstVecItem(idx, *tempConst);
     }
         // Store the real idx of funcdefTab, for ReplaceAddroffuncConst->FindIndexFromDefTable
-    defMuidIdxMap[muid] = idx;
+    defMuidIdxVec[muidIdx] = idx;
     idx++;
     if (trace) {
-      LogInfo::MapleLogger() << "funcDefMap, MUID: " << muid.ToStr()
+      LogInfo::MapleLogger() << "funcDefTable, MUID: " << muid.ToStr()
                              << ", Function Name: " << iter->second.first->GetName()
                              << ", Offset in addr order: " << (idx - 1)
                              << ", Offset in muid order: " << iter->second.second << "\n";
@@ -387,18 +425,8 @@ void MUIDReplacement::GenericFuncDefTable() {
 }
 
 void MUIDReplacement::GenericDataDefTable() {
-  // Use dataDefMap to make sure dataDefTab is sorted by an increasing order of MUID
-  for (MIRSymbol *mirSymbol : dataDefSet) {
-    MUID muid = GetMUID(mirSymbol->GetName());
-    CHECK_FATAL(dataDefMap.find(muid) == dataDefMap.end(), "MUID has been used before, possible collision");
-    // Use 0 as the index for now. It will be back-filled once we have the whole map.
-    dataDefMap[muid] = SymIdxPair(mirSymbol, 0);
-  }
-  uint32 idx = 0;
-  for (auto &keyVal : dataDefMap) {
-    // Fill in the real index
-    keyVal.second.second = idx++;
-  }
+  // Sort dataDefTable to make sure dataDefTab is sorted by an increasing order of MUID
+  BuildMUIDTable(std::vector<MIRSymbol*>(dataDefSet.begin(), dataDefSet.end()), dataDefTable);
   FieldVector parentFields;
   FieldVector fields;
   GlobalTables::GetTypeTable().PushIntoFieldVector(fields, "dataUnifiedAddr",
@@ -416,12 +444,12 @@ void MUIDReplacement::GenericDataDefTable() {
   auto *dataDefMuidTabEntryType =
       static_cast<MIRStructType*>(GlobalTables::GetTypeTable().GetOrCreateStructType(
           std::string("MUIDDataDefMuidTabEntry"), muidFields, parentFields, GetMIRModule()));
-  size_t arraySize = dataDefMap.size();
+  size_t arraySize = dataDefTable.size();
   MIRArrayType &arrayType = *GlobalTables::GetTypeTable().GetOrCreateArrayType(*dataDefTabEntryType, arraySize);
   MIRAggConst *dataDefTabConst = GetMIRModule().GetMemPool()->New<MIRAggConst>(GetMIRModule(), arrayType);
   MIRArrayType &muidArrayType = *GlobalTables::GetTypeTable().GetOrCreateArrayType(*dataDefMuidTabEntryType, arraySize);
   MIRAggConst *dataDefMuidTabConst = GetMIRModule().GetMemPool()->New<MIRAggConst>(GetMIRModule(), muidArrayType);
-  for (auto keyVal : dataDefMap) {
+  for (auto &keyVal : dataDefTable) {
     MIRSymbol *mirSymbol = keyVal.second.first;
     MIRAggConst *entryConst = GetMIRModule().GetMemPool()->New<MIRAggConst>(GetMIRModule(), *dataDefTabEntryType);
     uint32 fieldID = 1;
@@ -437,7 +465,7 @@ void MUIDReplacement::GenericDataDefTable() {
     dataDefMuidTabConst->PushBack(muidEntryConst);
     mplMuidStr += muid.ToStr();
     if (trace) {
-      LogInfo::MapleLogger() << "dataDefMap, MUID: " << muid.ToStr() << ", Variable Name: " << mirSymbol->GetName()
+      LogInfo::MapleLogger() << "dataDefTable, MUID: " << muid.ToStr() << ", Variable Name: " << mirSymbol->GetName()
                              << ", Offset: " << keyVal.second.second << "\n";
     }
   }
@@ -459,27 +487,13 @@ void MUIDReplacement::GenericDataDefTable() {
 }
 
 void MUIDReplacement::GenericUnifiedUndefTable() {
+  std::vector<MIRSymbol*> funcSymbols;
+  funcSymbols.reserve(funcUndefSet.size());
   for (MIRFunction *mirFunc : funcUndefSet) {
-    MUID muid = GetMUID(mirFunc->GetName());
-    CHECK_FATAL(funcUndefMap.find(muid) == funcUndefMap.end(), "MUID has been used before, possible collision");
-    // Use 0 as the index for now. It will be back-filled once we have the whole map.
-    funcUndefMap[muid] = SymIdxPair(mirFunc->GetFuncSymbol(), 0);
-  }
-  for (MIRSymbol *mirSymbol : dataUndefSet) {
-    MUID muid = GetMUID(mirSymbol->GetName());
-    CHECK_FATAL(dataUndefMap.find(muid) == dataUndefMap.end(), "MUID has been used before, possible collision");
-    // Use 0 as the index for now. It will be back-filled once we have the whole map.
-    dataUndefMap[muid] = SymIdxPair(mirSymbol, 0);
-  }
-  // Fill in the real index.
-  uint32 idx = 0;
-  for (auto &keyVal : funcUndefMap) {
-    keyVal.second.second = idx++;
-  }
-  idx = 0;
-  for (auto &keyVal : dataUndefMap) {
-    keyVal.second.second = idx++;
+    funcSymbols.push_back(mirFunc->GetFuncSymbol());
   }
+  BuildMUIDTable(funcSymbols, funcUndefTable);
+  BuildMUIDTable(std::vector<MIRSymbol*>(dataUndefSet.begin(), dataUndefSet.end()), dataUndefTable);
   FieldVector parentFields;
   FieldVector fields;
   GlobalTables::GetTypeTable().PushIntoFieldVector(fields, "globalAddress",
@@ -498,18 +512,18 @@ void MUIDReplacement::GenericUnifiedUndefTable() {
   auto *unifiedUndefMuidTabEntryType =
       static_cast<MIRStructType*>(GlobalTables::GetTypeTable().GetOrCreateStructType(
           "MUIDUnifiedUndefMuidTabEntry", muidFields, parentFields, GetMIRModule()));
-  size_t arraySize = funcUndefMap.size();
+  size_t arraySize = funcUndefTable.size();
   MIRArrayType &funcArrayType = *GlobalTables::GetTypeTable().GetOrCreateArrayType(*unifiedUndefTabEntryType,
                                                                                    arraySize);
   MIRAggConst *funcUndefTabConst = GetMIRModule().GetMemPool()->New<MIRAggConst>(GetMIRModule(), funcArrayType);
   MIRArrayType &funcMuidArrayType =
       *GlobalTables::GetTypeTable().GetOrCreateArrayType(*unifiedUndefMuidTabEntryType, arraySize);
   MIRAggConst *funcUndefMuidTabConst = GetMIRModule().GetMemPool()->New<MIRAggConst>(GetMIRModule(), funcMuidArrayType);
-  for (auto keyVal : funcUndefMap) {
+  for (auto &keyVal : funcUndefTable) {
     MUID muid = keyVal.first;
     mplMuidStr += muid.ToStr();
     if (trace) {
-      LogInfo::MapleLogger() << "funcUndefMap, MUID: " << muid.ToStr()
+      LogInfo::MapleLogger() << "funcUndefTable, MUID: " << muid.ToStr()
                              << ", Function Name: " << keyVal.second.first->GetName()
                              << ", Offset: " << keyVal.second.second << "\n";
     }
@@ -539,14 +553,14 @@ void MUIDReplacement::GenericUnifiedUndefTable() {
     funcUndefMuidTabSym->SetStorageClass(kScFstatic);
   }
   // Continue to generate dataUndefTab
-  arraySize = dataUndefMap.size();
+  arraySize = dataUndefTable.size();
   MIRArrayType &dataArrayType = *GlobalTables::GetTypeTable().GetOrCreateArrayType(*unifiedUndefTabEntryType,
                                                                                    arraySize);
   MIRAggConst *dataUndefTabConst = GetMIRModule().GetMemPool()->New<MIRAggConst>(GetMIRModule(), dataArrayType);
   MIRArrayType &dataMuidArrayType =
       *GlobalTables::GetTypeTable().GetOrCreateArrayType(*unifiedUndefMuidTabEntryType, arraySize);
   MIRAggConst *dataUndefMuidTabConst = GetMIRModule().GetMemPool()->New<MIRAggConst>(GetMIRModule(), dataMuidArrayType);
-  for (auto keyVal : dataUndefMap) {
+  for (auto &keyVal : dataUndefTable) {
     MIRAggConst *entryConst = GetMIRModule().GetMemPool()->New<MIRAggConst>(GetMIRModule(), *unifiedUndefTabEntryType);
     uint32 fieldID = 1;
     MIRSymbol *mirSymbol = keyVal.second.first;
@@ -562,7 +576,7 @@ void MUIDReplacement::GenericUnifiedUndefTable() {
     dataUndefMuidTabConst->PushBack(muidEntryConst);
     mplMuidStr += muid.ToStr();
     if (trace) {
-      LogInfo::MapleLogger() << "dataUndefMap, MUID: " << muid.ToStr() << ", Variable Name: " << mirSymbol->GetName()
+      LogInfo::MapleLogger() << "dataUndefTable, MUID: " << muid.ToStr() << ", Variable Name: " << mirSymbol->GetName()
                              << ", Offset: " << keyVal.second.second << "\n";
     }
   }
@@ -658,29 +672,28 @@ void MUIDReplacement::GenericRangeTable() {
 }
 
 uint32 MUIDReplacement::FindIndexFromDefTable(const MIRSymbol &mirSymbol, bool isFunc) {
-  MUID muid = GetMUID(mirSymbol.GetName());
+  const MUID &muid = GetSymbolMUID(mirSymbol);
   if (isFunc) {
-    CHECK_FATAL(defMuidIdxMap.find(muid) != defMuidIdxMap.end(), "Local function %s not found in funcDefMap",
-                mirSymbol.GetName().c_str());
-    return defMuidIdxMap[muid];
+    const MUIDSymIdxPair *entry = FindFromMUIDTable(funcDefTable, muid);
+    CHECK_FATAL(entry != nullptr && defMuidIdxVec[entry->second.second] != kInvalidDefMuidIdx,
+                "Local function %s not found in funcDefTable", mirSymbol.GetName().c_str());
+    return defMuidIdxVec[entry->second.second];
   } else {
-    CHECK_FATAL(dataDefMap.find(muid) != dataDefMap.end(), "Local variable %s not found in dataDefMap",
-                mirSymbol.GetName().c_str());
-    return dataDefMap[muid].second;
+    const MUIDSymIdxPair *entry = FindFromMUIDTable(dataDefTable, muid);
+    CHECK_FATAL(entry != nullptr, "Local variable %s not found in dataDefTable", mirSymbol.GetName().c_str());
+    return entry->second.second;
   }
 }
 
 uint32 MUIDReplacement::FindIndexFromUndefTable(const MIRSymbol &mirSymbol, bool isFunc) {
-  MUID muid = GetMUID(mirSymbol.GetName());
+  const MUID &muid = GetSymbolMUID(mirSymbol);
+  const MUIDSymIdxPair *entry = FindFromMUIDTable(isFunc ? funcUndefTable : dataUndefTable, muid);
   if (isFunc) {
-    CHECK_FATAL(funcUndefMap.find(muid) != funcUndefMap.end(), "Extern function %s not found in funcUndefMap",
-                mirSymbol.GetName().c_str());
-    return funcUndefMap[muid].second;
+    CHECK_FATAL(entry != nullptr, "Extern function %s not found in funcUndefTable", mirSymbol.GetName().c_str());
   } else {
-    CHECK_FATAL(dataUndefMap.find(muid) != dataUndefMap.end(), "Extern variable %s not found in dataUndefMap",
-                mirSymbol.GetName().c_str());
-    return dataUndefMap[muid].second;
+    CHECK_FATAL(entry != nullptr, "Extern variable %s not found in dataUndefTable", mirSymbol.GetName().c_str());
   }
+  return entry->second.second;
 }
 
 void MUIDReplacement::ClearVtabItab(const std::string &name) {
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) [2019] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "switch_lowering.h"
+#include <algorithm>
+#include "global_tables.h"
+#include "option.h"
+
+namespace maple {
+// fewer cases are cheaper to compare one by one
+static constexpr size_t kMinJumpTableCases = 4;
+// bounds the range of a jump table, whose tags are 16 bits in rangegoto
+static constexpr int64 kMaxJumpTableSize = 4096;
+// at most this many clusters are compared in sequence at a leaf of the search tree
+static constexpr size_t kMaxLinearClusters = 3;
+
+SwitchLowerer::SwitchLowerer(MIRModule *mod, KlassHierarchy *kh, bool trace) : FuncOptimizeImpl(mod, kh, trace) {}
+
+bool SwitchLowerer::IsDense(size_t first, size_t last) const {
+  uint64 numCases = last + 1 - first;
+  uint64 range = static_cast<uint64>(static_cast<int64>(cases[last].first) - cases[first].first + 1);
+  return numCases * 100 >= range * Options::switchDensity;
+}
+
+// Grows each cluster greedily to the farthest case that keeps it dense.
+void SwitchLowerer::ClusterCases() {
+  clusters.clear();
+  // rangegoto tables hold 16 bit labels
+  bool smallLabels = curSwitch->GetDefaultLabel() <= UINT16_MAX &&
+                     std::all_of(cases.begin(), cases.end(), [](const CasePair &casePair) {
+                       return casePair.second <= UINT16_MAX;
+                     });
+  size_t first = 0;
+  while (first < cases.size()) {
+    size_t last = first;
+    for (size_t i = first + kMinJumpTableCases - 1; smallLabels && i < cases.size(); ++i) {
+      if (static_cast<int64>(cases[i].first) - cases[first].first >= kMaxJumpTableSize) {
+        break;
+      }
+      if (IsDense(first, i)) {
+        last = i;
+      }
+    }
+    clusters.push_back(Cluster{ first, last, last != first });
+    first = last + 1;
+  }
+}
+
+BaseNode *SwitchLowerer::ReadSelector() {
+  return builder->CreateExprRegread(selectorType, selector);
+}
+
+void SwitchLowerer::Insert(StmtNode &stmt) {
+  stmt.SetSrcPos(curSwitch->GetSrcPos());
+  curBlock->InsertBefore(curSwitch, &stmt);
+}
+
+void SwitchLowerer::EmitCompare(Opcode op, int32 value, LabelIdx target) {
+  CompareNode *cond = builder->CreateExprCompare(op, *GlobalTables::GetTypeTable().GetUInt1(),
+                                                 *GlobalTables::GetTypeTable().GetPrimType(selectorType),
+                                                 ReadSelector(), builder->CreateIntConst(value, selectorType));
+  Insert(*builder->CreateStmtCondGoto(cond, OP_brtrue, target));
+  ++numCompares;
+}
+
+// Jumps through the table when the selector is in the range of the cluster, and falls through otherwise.
+void SwitchLowerer::EmitJumpTable(const Cluster &cluster) {
+  int32 low = cases[cluster.first].first;
+  int64 span = static_cast<int64>(cases[cluster.last].first) - low;
+  LabelIdx outOfRange = builder->CreateLabIdx(*currFunc);
+  // one unsigned compare checks both bounds, as selector - low wraps around below low
+  PrimType unsignedType = (selectorType == PTY_i32) ? PTY_u32 : PTY_u64;
+  BaseNode *offset = builder->CreateExprBinary(OP_sub, *GlobalTables::GetTypeTable().GetPrimType(selectorType),
+                                               ReadSelector(), builder->CreateIntConst(low, selectorType));
+  CompareNode *cond = builder->CreateExprCompare(OP_gt, *GlobalTables::GetTypeTable().GetUInt1(),
+                                                 *GlobalTables::GetTypeTable().GetPrimType(unsignedType), offset,
+                                                 builder->CreateIntConst(span, unsignedType));
+  Insert(*builder->CreateStmtCondGoto(cond, OP_brtrue, outOfRange));
+  ++numCompares;
+  // values of the range without a case go to the default label
+  std::vector<LabelIdx> table(static_cast<size_t>(span + 1), curSwitch->GetDefaultLabel());
+  for (size_t i = cluster.first; i <= cluster.last; ++i) {
+    table[static_cast<size_t>(static_cast<int64>(cases[i].first) - low)] = cases[i].second;
+  }
+  auto *rangeGoto = GetMIRModule().CurFuncCodeMemPool()->New<RangeGotoNode>(GetMIRModule());
+  rangeGoto->SetOpnd(ReadSelector());
+  rangeGoto->SetTagOffset(low);
+  for (size_t tag = 0; tag < table.size(); ++tag) {
+    rangeGoto->AddRangeGoto(static_cast<uint32>(tag), table[tag]);
+  }
+  Insert(*rangeGoto);
+  Insert(*builder->CreateStmtLabel(outOfRange));
+  ++numJumpTables;
+}
+
+// Dispatches the clusters [first, last) by halving them on the lowest case of the upper half.
+void SwitchLowerer::EmitClusters(size_t first, size_t last) {
+  if (last - first <= kMaxLinearClusters) {
+    for (size_t i = first; i < last; ++i) {
+      if (clusters[i].isJumpTable) {
+        EmitJumpTable(clusters[i]);
+      } else {
+        const CasePair &casePair = cases[clusters[i].first];
+        EmitCompare(OP_eq, casePair.first, casePair.second);
+      }
+    }
+    Insert(*builder->CreateStmtGoto(OP_goto, curSwitch->GetDefaultLabel()));
+    return;
+  }
+  size_t mid = first + (last - first) / 2;
+  LabelIdx upperHalf = builder->CreateLabIdx(*currFunc);
+  EmitCompare(OP_ge, cases[clusters[mid].first].first, upperHalf);
+  EmitClusters(first, mid);
+  Insert(*builder->CreateStmtLabel(upperHalf));
+  EmitClusters(mid, last);
+}
+
+void SwitchLowerer::LowerSwitch(BlockNode &block, SwitchNode &switchNode) {
+  selectorType = switchNode.GetSwitchOpnd()->GetPrimType();
+  // a switch without default label falls through, and unsigned selectors would order the cases differently
+  if (switchNode.GetDefaultLabel() == 0 || (selectorType != PTY_i32 && selectorType != PTY_i64)) {
+    return;
+  }
+  curBlock = &block;
+  curSwitch = &switchNode;
+  cases.assign(switchNode.GetSwitchTable().begin(), switchNode.GetSwitchTable().end());
+  std::sort(cases.begin(), cases.end(), [](const CasePair &lhs, const CasePair &rhs) {
+    return lhs.first < rhs.first;
+  });
+  ClusterCases();
+  // the selector is read by every compare, evaluate it once
+  BaseNode *opnd = switchNode.GetSwitchOpnd();
+  if (opnd->GetOpCode() == OP_regread) {
+    selector = static_cast<RegreadNode*>(opnd)->GetRegIdx();
+  } else {
+    selector = currFunc->GetPregTab()->CreatePreg(selectorType);
+    Insert(*builder->CreateStmtRegassign(selectorType, selector, opnd));
+  }
+  EmitClusters(0, clusters.size());
+  block.RemoveStmt(&switchNode);
+  ++numSwitches;
+}
+
+void SwitchLowerer::LowerBlock(BlockNode &block) {
+  StmtNode *next = nullptr;
+  for (StmtNode *stmt = block.GetFirst(); stmt != nullptr; stmt = next) {
+    next = stmt->GetNext();
+    switch (stmt->GetOpCode()) {
+      case OP_switch:
+        LowerSwitch(block, static_cast<SwitchNode&>(*stmt));
+        break;
+      case OP_block:
+        LowerBlock(static_cast<BlockNode&>(*stmt));
+        break;
+      case OP_if: {
+        auto *ifStmt = static_cast<IfStmtNode*>(stmt);
+        if (ifStmt->GetThenPart() != nullptr) {
+          LowerBlock(*ifStmt->GetThenPart());
+        }
+        if (ifStmt->GetElsePart() != nullptr) {
+          LowerBlock(*ifStmt->GetElsePart());
+        }
+        break;
+      }
+      case OP_while:
+      case OP_dowhile:
+        LowerBlock(*static_cast<WhileStmtNode*>(stmt)->GetBody());
+        break;
+      case OP_doloop:
+        LowerBlock(*static_cast<DoloopNode*>(stmt)->GetDoBody());
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void SwitchLowerer::ProcessFunc(MIRFunction *func) {
+  if (func->GetBody() == nullptr) {
+    return;
+  }
+  SetCurrentFunction(*func);
+  numSwitches = 0;
+  numJumpTables = 0;
+  numCompares = 0;
+  LowerBlock(*func->GetBody());
+  if (trace && numSwitches != 0) {
+    LogInfo::MapleLogger() << "switchlowering: " << func->GetName() << ": " << numSwitches << " switches, "
+                           << numJumpTables << " jump tables, " << numCompares << " compares\n";
+  }
+}
+}  // namespace maple
@@ -65,51 +65,81 @@ bool VtableAnalysis::CheckOverrideForCrossPackage(const MIRFunction &baseMethod,
 
 // If the method is not in method_table yet, add it in, otherwise update it.
 // Note: the method to add should already pass VtableCandidate test
-void VtableAnalysis::AddMethodToTable(MethodPtrVector &methodTable, MethodPair &methodpair) {
+void VtableAnalysis::AddMethodToTable(MethodPtrVector &methodTable, VtableIndexMap &indexMap,
+                                      MethodPair &methodpair) {
   MIRFunction *method = builder->GetFunctionFromStidx(methodpair.first);
   ASSERT(method != nullptr, "null ptr check!");
   GStrIdx strIdx = method->GetBaseFuncNameWithTypeStrIdx();
-  for (size_t i = 0; i < methodTable.size(); i++) {
+  std::vector<uint32> &slots = indexMap[strIdx];
+  for (uint32 i : slots) {
     MIRFunction *currFunc = builder->GetFunctionFromStidx(methodTable[i]->first);
     ASSERT(currFunc != nullptr, "null ptr check!");
-    GStrIdx currStrIdx = currFunc->GetBaseFuncNameWithTypeStrIdx();
-    if (strIdx == currStrIdx) {
-      if (CheckOverrideForCrossPackage(*currFunc, *method)) {
-        // only update when it's not an abstract method
-        if (!method->IsAbstract()) {
-          methodTable[i] = &methodpair;
-        }
-        return;
+    if (CheckOverrideForCrossPackage(*currFunc, *method)) {
+      // only update when it's not an abstract method
+      if (!method->IsAbstract()) {
+        methodTable[i] = &methodpair;
       }
+      return;
     }
   }
+  slots.push_back(methodTable.size());
   methodTable.push_back(&methodpair);
 }
 
+// Return the first vtable slot of structType named strIdx, or -1 if there is none.
+int VtableAnalysis::FindVtableSlot(const MIRStructType &structType, GStrIdx strIdx) const {
+  auto mapIt = vtableIndexMaps.find(&structType);
+  if (mapIt != vtableIndexMaps.end()) {
+    auto slotIt = mapIt->second.find(strIdx);
+    if (slotIt == mapIt->second.end() || slotIt->second.empty()) {
+      return -1;
+    }
+    return static_cast<int>(slotIt->second.front());
+  }
+  // The vtable of this type was not generated here, fall back to a linear search
+  for (size_t i = 0; i < structType.GetVTableMethodsSize(); i++) {
+    MIRFunction *method = builder->GetFunctionFromStidx(structType.GetVTableMethodsElemt(i)->first);
+    ASSERT(method != nullptr, "null ptr check!");
+    if (strIdx == method->GetBaseFuncNameWithTypeStrIdx()) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
 void VtableAnalysis::GenVtableList(const Klass &klass) {
   if (klass.IsInterface()) {
     MIRInterfaceType *iType = klass.GetMIRInterfaceType();
+    VtableIndexMap &indexMap = vtableIndexMaps[iType];
     // add in methods from parent interfaces, note interfaces can declare/define same methods
     for (const Klass *parentKlass : klass.GetSuperKlasses()) {
       MIRInterfaceType *parentInterfaceType = parentKlass->GetMIRInterfaceType();
       for (MethodPair *methodPair : parentInterfaceType->GetVTableMethods()) {
         ASSERT(methodPair != nullptr, "null ptr check!");
-        AddMethodToTable(iType->GetVTableMethods(), *methodPair);
+        AddMethodToTable(iType->GetVTableMethods(), indexMap, *methodPair);
       }
     }
     // add in methods from this interface, note it can override methods of parents
     for (MethodPair &methodPair : iType->GetMethods()) {
-      AddMethodToTable(iType->GetVTableMethods(), methodPair);
+      AddMethodToTable(iType->GetVTableMethods(), indexMap, methodPair);
     }
   } else {  // it's a class
     MIRClassType *curType = klass.GetMIRClassType();
     Klass *superKlass = klass.GetSuperKlass();
     // prepare vtable_methods
     // first is vtable from parents. since it's single inheritance, we copy it directly
+    // together with its slot index, so the parent layout is never searched again
     if (superKlass != nullptr) {
       MIRStructType *partenType = superKlass->GetMIRStructType();
       curType->GetVTableMethods() = partenType->GetVTableMethods();
+      auto parentIt = vtableIndexMaps.find(partenType);
+      if (parentIt != vtableIndexMaps.end()) {
+        // keep a reference, inserting curType may rehash and invalidate parentIt
+        const VtableIndexMap &parentIndexMap = parentIt->second;
+        vtableIndexMaps[curType] = parentIndexMap;
+      }
     }
+    VtableIndexMap &indexMap = vtableIndexMaps[curType];
     // vtable from implemented interfaces, need to merge in. both default or none-default
     // Note, all interface methods are also virtual methods, need to be in vtable too.
     for (TyIdx const &tyIdx : curType->GetInterfaceImplemented()) {
@@ -118,23 +148,19 @@ void VtableAnalysis::GenVtableList(const Klass &klass) {
         MIRFunction *method = builder->GetFunctionFromStidx(methodPair->first);
         GStrIdx strIdx = method->GetBaseFuncNameWithTypeStrIdx();
         Klass *iklass = klassHierarchy->GetKlassFromFunc(method);
-        bool found = false;
-        for (size_t i = 0; i < curType->GetVTableMethods().size(); i++) {
-          MIRFunction *curMethod = builder->GetFunctionFromStidx(curType->GetVTableMethods()[i]->first);
-          GStrIdx currStrIdx = curMethod->GetBaseFuncNameWithTypeStrIdx();
-          Klass *currKlass = klassHierarchy->GetKlassFromFunc(curMethod);
-          // Interfaces implemented methods can't override methods from parent,
-          // except the methods comes from another interface which is a parent of current interface
-          if (strIdx == currStrIdx) {
-            if (klassHierarchy->IsSuperKlassForInterface(currKlass, iklass)) {
-              curType->GetVTableMethods()[i] = methodPair;
-            }
-            found = true;
-            break;
-          }
-        }
-        if (!found) {
+        std::vector<uint32> &slots = indexMap[strIdx];
+        if (slots.empty()) {
+          slots.push_back(curType->GetVTableMethods().size());
           curType->GetVTableMethods().push_back(methodPair);
+          continue;
+        }
+        uint32 i = slots.front();
+        MIRFunction *curMethod = builder->GetFunctionFromStidx(curType->GetVTableMethods()[i]->first);
+        Klass *currKlass = klassHierarchy->GetKlassFromFunc(curMethod);
+        // Interfaces implemented methods can't override methods from parent,
+        // except the methods comes from another interface which is a parent of current interface
+        if (klassHierarchy->IsSuperKlassForInterface(currKlass, iklass)) {
+          curType->GetVTableMethods()[i] = methodPair;
         }
       }
     }
@@ -143,7 +169,7 @@ void VtableAnalysis::GenVtableList(const Klass &klass) {
       MIRFunction *curMethod = builder->GetFunctionFromStidx(methodpair.first);
       ASSERT(curMethod != nullptr, "null ptr check!");
       if (IsVtableCandidate(*curMethod)) {
-        AddMethodToTable(curType->GetVTableMethods(), methodpair);
+        AddMethodToTable(curType->GetVTableMethods(), indexMap, methodpair);
       }
       // Optimization: mark private methods as local
       if (curType->IsLocal() && curMethod->IsPrivate() && !curMethod->IsConstructor()) {
@@ -217,12 +243,9 @@ void VtableAnalysis::GenItableDefinition(const Klass &klass) {
       }
       // Search in vtable
       MIRFunction *vtabMethod = nullptr;
-      for (MethodPair *curMethodPair : curType->GetVTableMethods()) {
-        MIRFunction *method = builder->GetFunctionFromStidx(curMethodPair->first);
-        if (interfaceMethodStridx == method->GetBaseFuncNameWithTypeStrIdx()) {
-          vtabMethod = method;
-          break;
-        }
+      int slot = FindVtableSlot(*curType, interfaceMethodStridx);
+      if (slot >= 0) {
+        vtabMethod = builder->GetFunctionFromStidx(curType->GetVTableMethods()[slot]->first);
       }
       CHECK_FATAL(vtabMethod != nullptr, "Interface method %s is not implemented in class %s",
                   interfaceMethod->GetName().c_str(), klass.GetKlassName().c_str());
@@ -356,11 +379,15 @@ void VtableAnalysis::ProcessFunc(MIRFunction *func) {
     next = stmt->GetNext();
     switch (stmt->GetOpCode()) {
       case OP_virtualcallassigned: {
-        ReplaceVirtualInvoke(*(static_cast<CallNode*>(stmt)));
+        if (!Devirtualize(*(static_cast<CallNode*>(stmt)))) {
+          ReplaceVirtualInvoke(*(static_cast<CallNode*>(stmt)));
+        }
         break;
       }
       case OP_interfacecallassigned: {
-        ReplaceInterfaceInvoke(*(static_cast<CallNode*>(stmt)));
+        if (!Devirtualize(*(static_cast<CallNode*>(stmt)))) {
+          ReplaceInterfaceInvoke(*(static_cast<CallNode*>(stmt)));
+        }
         break;
       }
       case OP_superclasscallassigned: {
@@ -378,6 +405,15 @@ void VtableAnalysis::ProcessFunc(MIRFunction *func) {
   }
 }
 
+void VtableAnalysis::Finish() {
+  if (Options::quiet || numDynamicCalls == 0) {
+    return;
+  }
+  LogInfo::MapleLogger() << "vtableanalysis: " << GetMIRModule().GetFileName() << ": devirtualized "
+                         << numDevirtualizedCalls << " and guarded " << numGuardedCalls << " of " << numDynamicCalls
+                         << " virtual/interface call sites\n";
+}
+
 void VtableAnalysis::ReplaceSuperclassInvoke(CallNode &stmt) {
   // Because the virtual method may be inherited from its parent, we need to find
   // the actual method target.
@@ -432,6 +468,137 @@ BaseNode *VtableAnalysis::GenVtabItabBaseAddr(BaseNode *obj, bool isVirtual) {
                                   (isVirtual ? KLASS_VTAB_FIELDID : KLASS_ITAB_FIELDID), classInfoAddress);
 }
 
+// Return the method that every receiver of klass dispatches to, if the class hierarchy proves there is only one.
+// This must hold for classes outside the module too, so only final or private methods, and methods of classes that
+// cannot be subclassed, qualify.
+MIRFunction *VtableAnalysis::GetProvenTarget(const Klass &klass, GStrIdx strIdx) const {
+  if (!klass.IsClass() || klass.GetMIRStructType()->IsIncomplete()) {
+    return nullptr;
+  }
+  MIRFunction *target = klass.GetClosestMethod(strIdx);
+  if (target == nullptr || target->IsAbstract()) {
+    return nullptr;
+  }
+  if (target->IsFinal() || target->IsPrivate()) {
+    return target;
+  }
+  if (!klass.HasSubKlass() && (klass.GetMIRClassType()->IsFinal() || klass.IsPrivateInnerAndNoSubClass())) {
+    return target;
+  }
+  return nullptr;
+}
+
+// Return the method to call directly under a classinfo guard, and the class to guard on. We only guard call sites
+// that are monomorphic within the module: a class with a unique implementation, or an interface that is implemented
+// by exactly one class.
+MIRFunction *VtableAnalysis::GetGuardTarget(const Klass &klass, GStrIdx strIdx, const Klass *&guardKlass) const {
+  guardKlass = nullptr;
+  if (klass.IsClass()) {
+    if (klass.GetUniqueMethod(strIdx) != nullptr) {
+      guardKlass = &klass;
+    }
+  } else if (klass.IsInterface() && klass.GetImplKlasses().size() == 1) {
+    Klass *implKlass = *klass.GetImplKlasses().begin();
+    if (implKlass->IsClass() && !implKlass->HasSubKlass()) {
+      guardKlass = implKlass;
+    }
+  }
+  if (guardKlass == nullptr || guardKlass->GetMIRStructType()->IsIncomplete()) {
+    return nullptr;
+  }
+  MIRFunction *target = guardKlass->GetClosestMethod(strIdx);
+  return (target == nullptr || target->IsAbstract()) ? nullptr : target;
+}
+
+MIRSymbol *VtableAnalysis::GetOrCreateClassInfoSymbol(const Klass &klass) {
+  std::string classInfoName = CLASSINFO_PREFIX_STR + klass.GetKlassName();
+  MIRSymbol *classInfoSymbol = builder->GetGlobalDecl(classInfoName.c_str());
+  if (classInfoSymbol == nullptr) {
+    MIRStorageClass sclass = klass.GetMIRStructType()->IsLocal() ? kScGlobal : kScExtern;
+    classInfoSymbol = builder->CreateGlobalDecl(classInfoName.c_str(), *GlobalTables::GetTypeTable().GetPtr(), sclass);
+  }
+  return classInfoSymbol;
+}
+
+// Expand the call into
+//   brtrue @slow (ne (classinfo of receiver, addrof CLASSINFO_guardKlass))
+//   callassigned &target (...)
+//   goto @join
+//   @slow
+//   original dynamic call, lowered afterwards by the caller
+//   @join
+// The guard loads the classinfo from the receiver, so a null receiver still faults before either call.
+void VtableAnalysis::GenGuardedCall(CallNode &stmt, const Klass &guardKlass, const MIRFunction &target) {
+  MapleAllocator &alloc = GetMIRModule().GetCurFuncCodeMPAllocator();
+  BlockNode *body = currFunc->GetBody();
+  LabelIdx slowLabIdx = builder->CreateLabIdx(*currFunc);
+  LabelIdx joinLabIdx = builder->CreateLabIdx(*currFunc);
+  BaseNode *classInfoAddr = ReflectionAnalysis::GenClassInfoAddr(stmt.GetNopndAt(0)->CloneTree(alloc), *builder);
+  BaseNode *guardAddr = builder->CreateExprAddrof(0, *GetOrCreateClassInfoSymbol(guardKlass));
+  BaseNode *cond = builder->CreateExprCompare(OP_ne, *GlobalTables::GetTypeTable().GetUInt1(),
+                                              *GlobalTables::GetTypeTable().GetPtr(), classInfoAddr, guardAddr);
+  CallNode *directCall = stmt.CloneTree(alloc);
+  directCall->SetOpCode(OP_callassigned);
+  directCall->SetPUIdx(target.GetPuidx());
+  body->InsertBefore(&stmt, builder->CreateStmtCondGoto(cond, OP_brtrue, slowLabIdx));
+  body->InsertBefore(&stmt, directCall);
+  body->InsertBefore(&stmt, builder->CreateStmtGoto(OP_goto, joinLabIdx));
+  body->InsertBefore(&stmt, builder->CreateStmtLabel(slowLabIdx));
+  body->InsertAfter(&stmt, builder->CreateStmtLabel(joinLabIdx));
+}
+
+// Turn a virtual or interface call into a direct call when the target is proven, or, at kGuardedDevirt, prepend a
+// guarded direct call. Return true if the dynamic call is gone and needs no further lowering.
+bool VtableAnalysis::Devirtualize(CallNode &stmt) {
+  ++numDynamicCalls;
+  if (Options::devirtLevel == kNoDevirt || stmt.GetNopnd().empty()) {
+    return false;
+  }
+  // The receiver is evaluated once more by the null check or the guard.
+  BaseNode *receiver = stmt.GetNopndAt(0);
+  if (receiver->GetOpCode() != OP_dread && receiver->GetOpCode() != OP_regread) {
+    return false;
+  }
+  MIRFunction *callee = GlobalTables::GetFunctionTable().GetFunctionFromPuidx(stmt.GetPUIdx());
+  Klass *klass = klassHierarchy->GetKlassFromFunc(callee);
+  if (klass == nullptr) {
+    return false;
+  }
+  GStrIdx strIdx = callee->GetBaseFuncNameWithTypeStrIdx();
+  MIRFunction *target = GetProvenTarget(*klass, strIdx);
+  if (target != nullptr) {
+    // A direct call does not dereference the receiver, so keep the NullPointerException explicit.
+    StmtNode *nullCheck =
+        builder->CreateStmtUnary(OP_assertnonnull, receiver->CloneTree(GetMIRModule().GetCurFuncCodeMPAllocator()));
+    currFunc->GetBody()->InsertBefore(&stmt, nullCheck);
+    stmt.SetOpCode(OP_callassigned);
+    stmt.SetPUIdx(target->GetPuidx());
+    // Like a superclass call, the virtual method is now also referenced directly.
+    GetMIRModule().addSuperCall(target->GetName());
+    ++numDevirtualizedCalls;
+    if (trace) {
+      LogInfo::MapleLogger() << "[devirt] " << currFunc->GetName() << ": " << callee->GetName() << " -> "
+                             << target->GetName() << "\n";
+    }
+    return true;
+  }
+  if (Options::devirtLevel < kGuardedDevirt) {
+    return false;
+  }
+  const Klass *guardKlass = nullptr;
+  target = GetGuardTarget(*klass, strIdx, guardKlass);
+  if (target == nullptr) {
+    return false;
+  }
+  GenGuardedCall(stmt, *guardKlass, *target);
+  GetMIRModule().addSuperCall(target->GetName());
+  ++numGuardedCalls;
+  if (trace) {
+    LogInfo::MapleLogger() << "[devirt] " << currFunc->GetName() << ": " << callee->GetName() << " -> "
+                           << target->GetName() << " if " << guardKlass->GetKlassName() << "\n";
+  }
+  return false;
+}
 
 void VtableAnalysis::ReplaceVirtualInvoke(CallNode &stmt) {
   MIRFunction *callee = GlobalTables::GetFunctionTable().GetFunctionFromPuidx(stmt.GetPUIdx());
@@ -454,14 +621,10 @@ void VtableAnalysis::ReplaceVirtualInvoke(CallNode &stmt) {
   } else {
     GStrIdx calleeStridx = callee->GetBaseFuncNameWithTypeStrIdx();
     ASSERT(structType != nullptr, "null ptr check!");
-    for (size_t id1 = 0; id1 < structType->GetVTableMethods().size(); id1++) {
-      MIRFunction *vtableMethod = builder->GetFunctionFromStidx(structType->GetVTableMethods()[id1]->first);
-      ASSERT(vtableMethod != nullptr, "null ptr check!");
-      if (calleeStridx == vtableMethod->GetBaseFuncNameWithTypeStrIdx()) {
-        entryOffset = id1;
-        puidxToVtabIndex[callee->GetPuidx()] = id1;
-        break;
-      }
+    int slot = FindVtableSlot(*structType, calleeStridx);
+    if (slot >= 0) {
+      entryOffset = static_cast<size_t>(slot);
+      puidxToVtabIndex[callee->GetPuidx()] = slot;
     }
     CHECK_FATAL(entryOffset != SIZE_MAX,
                 "Error: method for virtual call cannot be found in all included mplt files. Call to %s in %s",